@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tools/int.hpp"
+
 #include <vector>
 
 namespace ai
@@ -15,10 +17,23 @@ namespace ai
         void* data = nullptr;   //!< Extra data pointer for the user.
     };
 
+    //! The neighbourhood of a node, a range within the graph contiguous edges.
+    struct Neighbours
+    {
+        const Neighbour* first = nullptr;   //!< The first neighbour.
+        uint count = 0u;                    //!< How many neighbours.
+
+        inline const Neighbour* begin() const { return first; }
+        inline const Neighbour* end() const { return first + count; }
+        inline uint size() const { return count; }
+        inline bool empty() const { return count == 0u; }
+        inline const Neighbour& operator[](uint index) const { return first[index]; }
+    };
+
     //! The abstraction of a cell in a graph.
     struct Node
     {
-        std::vector<Neighbour> neighbours;  //!< The neighbourhood of the node.
-        void* data = nullptr;               //!< Extra data pointer for the user.
+        Neighbours neighbours;  //!< The neighbourhood of the node.
+        void* data = nullptr;   //!< Extra data pointer for the user.
     };
 }
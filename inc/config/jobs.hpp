@@ -0,0 +1,15 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+namespace config
+{
+    struct Jobs
+    {
+        //! Load the corresponding config file.
+        Jobs();
+
+        uint workersCount = 0u; //!< How many threads run the jobs, 0 for one per hardware thread.
+    };
+}
+
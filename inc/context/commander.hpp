@@ -11,6 +11,10 @@
 namespace context
 {
     //! Command queue and broadcaster.
+    /*!
+     *  Interpreted command lines are logged to log/commands_*.eev,
+     *  with wait lines in between, so that the file can be replayed as a script.
+     */
 
     class Commander final : private sf::NonCopyable
     {
@@ -81,6 +85,15 @@ namespace context
 
         //! @}
 
+        //------------//
+        //! @name Log
+        //! @{
+
+        //! Write the command line to the log, after the time elapsed since the previous one.
+        void log(const std::wstring& commandLine);
+
+        //! @}
+
     private:
 
         std::queue<Command> m_commandQueue;         //!< The command queue.
@@ -89,5 +102,6 @@ namespace context
 
         // Log
         std::wofstream m_logStream; //!< The stream to log to.
+        sf::Time m_logTime;         //!< The time elapsed since the last logged line.
     };
 }
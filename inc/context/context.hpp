@@ -2,6 +2,7 @@
 
 #include "context/commander.hpp"
 #include "resources/holder.hpp"
+#include "resources/textureholder.hpp"
 #include "resources/musicplayer.hpp"
 #include "resources/soundplayer.hpp"
 #include "resources/animationholder.hpp"
@@ -9,6 +10,7 @@
 #include "config/nuiguides.hpp"
 #include "config/display.hpp"
 #include "config/audio.hpp"
+#include "config/jobs.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Texture.hpp>
@@ -42,6 +44,7 @@ namespace context
 
         config::Display     display;    //!< The display configuration.
         config::Audio       audio;      //!< The audio configuration.
+        config::Jobs        jobs;       //!< The jobs configuration.
         config::NUIGuides   nuiGuides;  //!< Guidelines for NUI elements.
         config::WindowInfo  windowInfo; //!< Extra informations for window parameters.
     };
@@ -4,9 +4,11 @@
 #include "tools/debug.hpp"
 #include "tools/int.hpp"
 
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
 #include <string>
 #include <vector>
-#include <deque>
 
 namespace context
 {
@@ -14,15 +16,46 @@ namespace context
 
     class EventReceiver;
 
+    //! The type of an event, interned once from its name.
+    using EventID = uint16;
+
+    //! Get the interned ID of an event name, to be resolved once and reused.
+    EventID eventID(const std::string& name);
+
+    //! Get the name of an interned event, for debug purposes.
+    const std::string& eventName(EventID id);
+
+    //! The type of a stored event that has been coalesced away, never sent.
+    constexpr EventID noEvent = static_cast<EventID>(-1);
+
+    //! How a stored event is merged with an equal one still waiting for broadcast.
+    /*!
+     *  Two events are equal if all their bytes are,
+     *  so coalesced events are expected to zero their padding on construction.
+     */
+    enum class Coalescing : uint8
+    {
+        NONE,               //!< Every event is stored.
+        DROP_IF_LAST_EQUAL, //!< Dropped if the last stored event is equal.
+        MERGE,              //!< Dropped if an equal event is stored, which keeps its position.
+        MOVE_TO_END,        //!< An equal stored event is removed, and this one is stored at the end.
+    };
+
     //! Base class for event.
+    /*!
+     *  Events are stored by value, so derived events are expected
+     *  to be trivially copyable and not bigger than eventMaxSize.
+     *  Relative order of stored events is kept, except for coalesced types.
+     */
 
     struct Event
     {
-        virtual ~Event() = default;
-
-        std::string type;   //!< The type of event which is sent.
+        EventID type;   //!< The type of event which is sent.
     };
 
+    //! The maximum size of an event, derived ones included.
+    constexpr uint eventMaxSize = 32u;
+
     //! Base class to be able to emit an event.
 
     class EventEmitter
@@ -38,15 +71,14 @@ namespace context
         //! @name Event emitter
         //! @{
 
-        //! Emits an event through all receivers.
-        //! Note: similar events won't be launched twice.
+        //! Emits an event through all receivers interested in its type.
         //! Set direct to true to send the event without adding it to the broadcast list.
-        void addEvent(std::unique_ptr<Event> event, bool direct = false);
+        template<class Event_t>
+        void addEvent(const Event_t& event, bool direct = false);
 
-        //! Emits a default event type through all receivers.
-        //! Note: similar events won't be launched twice.
+        //! Emits a default event type through all receivers interested in it.
         //! Set direct to true to send the event without adding it to the broadcast list.
-        void addEvent(std::string eventType, bool direct = false);
+        void addEvent(EventID eventType, bool direct = false);
 
         //! @}
 
@@ -61,25 +93,63 @@ namespace context
 
         //! @}
 
+        //-------------------//
+        //! @name Coalescing
+        //! @{
+
+        //! Set how stored events of a type are merged, none by default.
+        void setCoalescing(EventID eventType, Coalescing coalescing);
+
+        //! @}
+
         //-------------------------//
         //! @name Manage receivers
         //! @{
 
-        //! Method called by a receiver to register itself.
-        void addReceiver(EventReceiver* receiver);
+        //! Method called by a receiver to register itself for a type of event.
+        void addReceiver(EventReceiver* receiver, EventID eventType);
 
-        //! Method called by a receiver to unregister itself.
-        void removeReceiver(EventReceiver* receiver);
+        //! Method called by a receiver to unregister itself from a type of event.
+        void removeReceiver(EventReceiver* receiver, EventID eventType);
+
+        //! @}
+
+        //---------------//
+        //! @name Events
+        //! @{
+
+        //! Send the event to all interested receivers.
+        void send(const Event& event);
+
+        //! Add a stored event at the end of the ring buffer, growing it if needed.
+        //! Does nothing if the event is coalesced with an already stored one.
+        void push(const void* event, uint size);
 
         //! @}
 
     private:
 
-        //! All the receivers to be called when an event is sent.
-        std::vector<EventReceiver*> m_receivers;
+        //! Raw memory for a stored event.
+        using EventStorage = std::aligned_storage<eventMaxSize, alignof(std::max_align_t)>::type;
+
+        //! The stored event at the specified position from the first one.
+        EventStorage& storedEvent(uint index);
+
+        //! Find the position of an equal stored event, -1u if none.
+        //! Set fromEnd to true to find the last one.
+        uint findStoredEvent(const EventStorage& event, bool fromEnd);
+
+        //! The receivers to be called when an event is sent, by event type.
+        std::vector<std::vector<EventReceiver*>> m_receivers;
 
-        //! The list of events to broadcasts.
-        std::deque<std::unique_ptr<Event>> m_events;
+        // The events to broadcast, as a ring buffer
+        std::vector<EventStorage> m_events; //!< The storage, its size is a power of two.
+        uint m_eventsFirst = 0u;            //!< The index of the first event.
+        uint m_eventsCount = 0u;            //!< How many events are stored.
+
+        // Coalescing
+        std::vector<Coalescing> m_coalescings;  //!< How events are merged, by event type.
+        std::vector<uint> m_storedCounts;       //!< How many events are stored, by event type.
     };
 
     //! Base class for those who want to be able to receive a dungeon event.
@@ -100,8 +170,8 @@ namespace context
         //! @name Events
         //! @{
 
-        //! Set the event emitter.
-        void setEmitter(EventEmitter* emitter);
+        //! Set the event emitter, and the types of events to receive from it.
+        void setEmitter(EventEmitter* emitter, std::initializer_list<EventID> eventTypes = {});
 
         //! Get the event emitter.
         inline EventEmitter* emitter() { return m_emitter; }
@@ -114,7 +184,7 @@ namespace context
         //! @name Events
         //! @{
 
-        //! Called whenever an event is sent.
+        //! Called whenever an event of a registered type is sent.
         virtual void receive(const Event& event) = 0;
 
         //! @}
@@ -124,9 +194,14 @@ namespace context
         //! The emitter events are coming from.
         EventEmitter* m_emitter = nullptr;
 
+        //! The types of events received.
+        std::vector<EventID> m_eventTypes;
+
 #if DEBUG_GLOBAL > 0
         //! In debug mode, assert that the receiver is not detroyed during emit.
         bool m_lock = false;
 #endif
     };
 }
+
+#include "context/event.inl"
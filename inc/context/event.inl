@@ -0,0 +1,18 @@
+#pragma once
+
+namespace context
+{
+    //-------------------------//
+    //----- Event emitter -----//
+
+    template<class Event_t>
+    inline void EventEmitter::addEvent(const Event_t& event, bool direct)
+    {
+        static_assert(std::is_base_of<Event, Event_t>::value, "Emitted events should inherit from context::Event.");
+        static_assert(std::is_trivially_copyable<Event_t>::value, "Emitted events are stored by value and should be trivially copyable.");
+        static_assert(sizeof(Event_t) <= eventMaxSize, "Emitted events should not be bigger than context::eventMaxSize.");
+
+        if (direct) send(event);
+        else push(&event, sizeof(Event_t));
+    }
+}
@@ -1,16 +1,8 @@
 #pragma once
 
+#include "context/event.hpp"
 #include "tools/int.hpp"
 
-#include <string>
-
-// Forward declarations
-
-namespace context
-{
-    class EventEmitter;
-}
-
 namespace context
 {
     //! Stores and controls some value.
@@ -60,7 +52,7 @@ namespace context
         //!
 
         //! Sets what to use for events.
-        void setEvents(EventEmitter* emitter, std::string eventType);
+        void setEvents(EventEmitter* emitter, EventID eventType);
 
         //! Set a factor applied to each modification (except set).
         void setFactor(uint factor);
@@ -73,6 +65,6 @@ namespace context
         uint m_factor = 1u; //!< Multiplicative factor applied to each modification.
 
         EventEmitter* m_emitter = nullptr; //!< The emitter to use on changes.
-        std::string m_eventType;           //!< The type of events to use on changes.
+        EventID m_eventType = 0u;          //!< The type of events to use on changes.
     };
 }
@@ -70,7 +70,7 @@ public:
     //! @name Loading and freeing resources
     //! @{
 
-    static void loadTextures(const std::initializer_list<std::string>& folders);    //!< Load all textures inside folders into memory.
+    static void loadTextures(const std::initializer_list<std::string>& folders, bool atlased = false);  //!< Load all textures inside folders into memory, the small ones packed if atlased.
     static void loadSounds(const std::initializer_list<std::string>& folders);      //!< Load all sounds inside folders into memory.
     static void loadAnimations(const std::initializer_list<std::string>& folders);  //!< Load all animations inside folders into memory.
 
@@ -98,6 +98,8 @@ protected:
     /*!
      *  As we want to know the hovered entity at each frame,
      *  we generate a MouseMoved event with the current position of the mouse.
+     *  It is skipped if neither the mouse position nor the scene hit-test epoch changed,
+     *  the hovered entity being then the same.
      */
     void synchronizeMouse();
 
@@ -195,6 +197,10 @@ private:
     std::wstring m_scriptCommandLine;   //!< The current command line to execute.
     int m_scriptWaitTime = 0;           //!< Milliseconds to wait before sending next command.
 
+    // Mouse
+    sf::Vector2i m_mousePosition;       //!< The mouse position of the last synchronization.
+    uint32 m_mouseHitTestEpoch = 0u;    //!< The scene hit-test epoch of the last synchronization.
+
     // Visual part
     static VisualDebug s_visualDebug;   //!< The debug information.
     states::StateStack m_stateStack;    //!< The stack of states.
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Forward declarations
+
+class JobGroup;
+
+//! A job to be run by the job system.
+struct Job
+{
+    const char* name = nullptr;         //!< A static name, given to the instrumentation hooks.
+    std::function<void()> function;     //!< What to run.
+    JobGroup* group = nullptr;          //!< The group the job is counted in.
+};
+
+//! Jobs that can be waited for together.
+/*!
+ *  Jobs forked into the group are counted until done,
+ *  and jobs can be set to start once the group is done.
+ *  A group should outlive its jobs, which joining it ensures.
+ */
+
+class JobGroup final
+{
+    friend class JobSystem;
+
+public:
+
+    //! Default constructor.
+    JobGroup() = default;
+
+    JobGroup(const JobGroup&) = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    //! Whether all jobs of the group are done.
+    inline bool done() const { return m_pending == 0u; }
+
+private:
+
+    std::atomic<uint> m_pending{0u};    //!< How many jobs are not done yet.
+    std::mutex m_mutex;                 //!< Protects the continuations and the last job finishing.
+    std::vector<Job> m_continuations;   //!< The jobs to start once the group is done.
+};
+
+//! Runs jobs on a fixed set of threads.
+/*!
+ *  Each thread takes the jobs it forked last first, and steals the oldest ones
+ *  of the others when it has none left, so that nested fork/join stay cache-friendly.
+ *  Threads waiting for a group run pending jobs meanwhile, so with a single worker,
+ *  everything runs on the calling thread, in order.
+ */
+
+class JobSystem final
+{
+public:
+
+    //! Called before and after each job, with its name and the index of the worker running it.
+    //! The worker is 0 for threads not created by the job system.
+    using Hook = std::function<void(const char* name, uint worker)>;
+
+public:
+
+    //! Constructor, without any thread until started.
+    JobSystem();
+
+    //! Destructor, stops the threads.
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    //----------------//
+    //! @name Workers
+    //! @{
+
+    //! Start the threads, the ones waiting for jobs taking part, so one less is created.
+    //! With 0, there is one worker per hardware thread.
+    void start(uint workersCount);
+
+    //! Stop the threads, pending jobs being left to the threads waiting for them.
+    void stop();
+
+    //! How many threads run the jobs, the calling one included.
+    inline uint workersCount() const { return m_threads.size() + 1u; }
+
+    //! @}
+
+    //-------------//
+    //! @name Jobs
+    //! @{
+
+    //! Run the function asynchronously, counted in the group.
+    void fork(JobGroup& group, const char* name, std::function<void()> function);
+
+    //! Run the function asynchronously once the dependency is done, counted in the group.
+    void forkAfter(JobGroup& dependency, JobGroup& group, const char* name, std::function<void()> function);
+
+    //! Wait for all the jobs of the group, running pending jobs meanwhile.
+    void join(JobGroup& group);
+
+    //! Run the function for each index from 0 to count - 1, by chunks of grain indices.
+    //! Returns once all are done.
+    void parallelFor(const char* name, uint count, const std::function<void(uint)>& function, uint grain = 1u);
+
+    //! @}
+
+    //------------------------//
+    //! @name Instrumentation
+    //! @{
+
+    //! Set the functions called around each job, nullptr for none.
+    //! They are called concurrently, and should not be changed while jobs are running.
+    void setHooks(Hook onStart, Hook onFinish);
+
+    //! @}
+
+protected:
+
+    //----------------//
+    //! @name Threads
+    //! @{
+
+    //! The queue of the calling thread.
+    uint queueIndex() const;
+
+    //! Queue a job.
+    void push(Job job);
+
+    //! Take a job, from the calling thread queue first, then stealing from the others.
+    bool pop(Job& job);
+
+    //! Run a job and mark it done.
+    void execute(Job& job);
+
+    //! Mark one job of the group done, starting its continuations if it was the last.
+    void finish(JobGroup& group);
+
+    //! The loop of each thread, running jobs or sleeping.
+    void workerRoutine(uint index);
+
+    //! @}
+
+    //! The jobs forked by a thread.
+    struct Queue
+    {
+        std::mutex mutex;       //!< Protects the jobs.
+        std::deque<Job> jobs;   //!< Newest last.
+    };
+
+private:
+
+    std::vector<std::unique_ptr<Queue>> m_queues;   //!< One per worker, the first one being for threads not created here.
+    std::vector<std::thread> m_threads;             //!< The threads created.
+    std::atomic<uint> m_queuedCount{0u};            //!< How many jobs are waiting in the queues.
+
+    // Sleeping
+    std::mutex m_wakeMutex;                     //!< Protects the stopping state.
+    std::condition_variable m_wakeCondition;    //!< Notified when a job is queued or when stopping.
+    bool m_stopping = false;                    //!< Whether the threads are to stop.
+
+    // Instrumentation
+    Hook m_onStart = nullptr;   //!< Called before each job.
+    Hook m_onFinish = nullptr;  //!< Called after each job.
+};
+
+//! Global job system.
+extern JobSystem s_jobs;
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "dungeon/data.hpp"
+#include "dungeon/graph.hpp"
+#include "dungeon/inter.hpp"
+#include "nui/contextmenu.hpp"
+#include "scene/entity.hpp"
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <ostream>
+#include <string>
+
+//! Runs the dungeon simulation without window, rendering nor audio.
+/*!
+ *  A dungeon save is loaded, then data, elements and components
+ *  are updated at fixed time steps, as fast as the CPU allows.
+ *  This is used to fast-forward a game for balancing,
+ *  and to soak-test large dungeons.
+ *
+ *  A commands log, as recorded by the commander, can also be replayed,
+ *  the digest of the final state then identifying the run.
+ */
+
+class Simulation final : sf::NonCopyable
+{
+public:
+
+    //! The time spent in each part of a run.
+    struct Report
+    {
+        uint ticks = 0u;        //!< How many fixed time steps were simulated.
+        uint gameHours = 0u;    //!< How many in-game hours were simulated.
+        sf::Time total;         //!< The whole run.
+        sf::Time elements;      //!< Elements routines, mostly Lua AI.
+        sf::Time components;    //!< Components, mostly movements.
+
+        dungeon::Data::UpdateTimings data;  //!< Events and managers.
+    };
+
+public:
+
+    //! Constructor, loads the resources used by the simulation.
+    Simulation();
+
+    //! Destructor.
+    ~Simulation();
+
+    //----------------//
+    //! @name Routine
+    //! @{
+
+    //! Let heroes and monsters decide on that many job system workers, before being updated.
+    //! With 0, each element decides during its own update, as the game does.
+    void setAIWorkers(uint workersCount);
+
+    //! Load the dungeon of a world, from its folder as in saves/worlds.xml.
+    //! @return False if no world uses that folder.
+    bool load(const std::wstring& folder);
+
+    //! Simulate that many in-game hours, at fixed time steps.
+    const Report& run(uint gameHours, const sf::Time& step);
+
+    //! Interpret the command lines of a log file, respecting its wait lines, at fixed time steps.
+    //! @return False if the file cannot be opened.
+    bool replay(const std::string& file, const sf::Time& step);
+
+    //! Print the last report, the current wallets and the state digest.
+    void print(std::ostream& out) const;
+
+    //! @}
+
+private:
+
+    //----------------//
+    //! @name Report
+    //! @{
+
+    //! Reset the report and start timing.
+    void startReport();
+
+    //! Simulate one time step.
+    void tick(const sf::Time& step);
+
+    //! Finish timing, for the game time elapsed since startTime.
+    void finishReport(uint startTime);
+
+    //! @}
+
+private:
+
+    //! The parent of the inter, updated as a layer root would be, but without a layer.
+    class Root final : public scene::Entity
+    {
+    public:
+
+        std::string _name() const final { return "SimulationRoot"; }
+
+        using scene::Entity::update;
+    };
+
+private:
+
+    Root m_root;                    //!< The parent of the inter.
+    nui::ContextMenu m_contextMenu; //!< Required by the inter, never shown.
+    dungeon::Data m_data;           //!< The dungeon data.
+    dungeon::Graph m_graph;         //!< The graph of the dungeon.
+    dungeon::Inter m_inter;         //!< The dungeon inter, parent of all elements.
+
+    Report m_report;        //!< The last run report.
+    sf::Clock m_clock;      //!< Times the whole run.
+};
@@ -47,6 +47,9 @@ public:
     //! Used to precisely inform how much time the whole render took.
     void setRenderTickTime(const sf::Time& t);
 
+    //! Used to count the mouse hit tests, skipped if nothing changed since the previous one.
+    void addMouseHitTest(bool skipped);
+
     //! Basic drawing to the main window.
     void draw(sf::RenderTarget& target, sf::RenderStates states) const final;
 
@@ -102,5 +105,9 @@ private:
     float m_timeFactor = 1.f;       //!< The estimated time factor.
     int64 m_logicTickTimeSum = 0;   //!< Cummulated time for update().
     int64 m_renderTickTimeSum = 0;  //!< Cummulated time for render().
+
+    // Mouse
+    uint m_mouseHitTests = 0u;          //!< Number of mouse hit tests performed.
+    uint m_mouseHitTestsSkipped = 0u;   //!< Number of mouse hit tests skipped.
 };
 
@@ -18,9 +18,13 @@
 
 #include <SFML/System/Time.hpp>
 
+#include <condition_variable>
+#include <memory>
 #include <string>
 #include <vector>
 #include <array>
+#include <thread>
+#include <mutex>
 
 // Forward declarations
 
@@ -56,13 +60,45 @@ namespace dungeon
             std::vector<Room> rooms;
         };
 
+        //! All the saved states of the dungeon, copied so that they can be written later.
+        struct Snapshot
+        {
+            std::wstring name;          //!< Name of the dungeon.
+            uint time = 0u;             //!< Current game time.
+            uint floorsCount = 0u;      //!< Number of floors.
+            uint floorRoomsCount = 0u;  //!< Number of rooms in each floor.
+
+            // Resources
+            uint soul = 0u;             //!< Soul wallet value.
+            uint fame = 0u;             //!< Fame wallet value.
+            uint debtPerWeek = 0u;      //!< Debt dosh per week.
+            uint debtWeeksLeft = 0u;    //!< Debt duration.
+
+            // Structure and elements
+            std::vector<Floor> floors;                                              //!< All floors.
+            std::unordered_map<std::wstring, TrapGeneric> trapsGenerics;            //!< Traps generics.
+            std::unordered_map<std::wstring, MonsterGeneric> monstersGenerics;      //!< Monsters generics.
+            HeroesManager::Snapshot heroes;                                         //!< Heroes states.
+            MonstersManager::Snapshot monsters;                                     //!< Monsters states.
+            DynamicsManager::Snapshot dynamics;                                     //!< Dynamics states.
+        };
+
+        //! The time spent in each part of the update, accumulated while timed.
+        struct UpdateTimings
+        {
+            sf::Time events;    //!< Broadcasting events.
+            sf::Time heroes;    //!< Heroes manager update.
+            sf::Time monsters;  //!< Monsters manager update.
+            sf::Time dynamics;  //!< Dynamics manager update.
+        };
+
     public:
 
         //! Constructor.
         Data();
 
-        //! Default destructor.
-        ~Data() = default;
+        //! Destructor, waits for background saves to be written.
+        ~Data();
 
         //----------------//
         //! @name Routine
@@ -71,6 +107,12 @@ namespace dungeon
         //! Routine call for time update.
         void update(const sf::Time& dt);
 
+        //! Whether to accumulate the time spent in each part of the update, for profiling.
+        void setUpdateTimed(bool updateTimed);
+
+        //! The time spent in each part of the update since it is timed.
+        inline const UpdateTimings& updateTimings() const { return m_updateTimings; }
+
         //! @}
 
         //------------------------//
@@ -85,9 +127,31 @@ namespace dungeon
         //! @return The filename of the main dungeon file.
         std::wstring save(const std::wstring& folder);
 
+        //! Save dungeon data to a specified folder (must exists), without blocking.
+        /*!
+         *  The state is copied right away, then encoded and written to disk by a worker thread.
+         *  If the worker is still busy, only the latest state will be written.
+         *  Note: villains are not saved, this is left to save().
+         *  @return The filename of the main dungeon file.
+         */
+        std::wstring saveAsync(const std::wstring& folder);
+
+        //! Block until all background saves are written.
+        void waitSaves();
+
         //! Save data to a specified folder (must exists).
         void createFiles(const std::wstring& folder);
 
+        //! Copy all the saved states.
+        Snapshot snapshot() const;
+
+        //! A hash of all the saved states and the villain wallets.
+        /*!
+         *  Two runs from the same save, seed and commands get the same digest,
+         *  which is used to check that replays are reproducible.
+         */
+        uint64 digest() const;
+
         //! @}
 
         //----------------//
@@ -95,7 +159,8 @@ namespace dungeon
         //! @{
 
         //! Quick tool to emit an dungeon event with coords informations.
-        void addEvent(std::string eventType, const RoomCoords& coords);
+        //! Room changes also invalidate the room within the linked graph.
+        void addEvent(context::EventID eventType, const RoomCoords& coords);
 
         //! @}
 
@@ -202,7 +267,7 @@ namespace dungeon
         //----- Warnings
 
         //! Send all the warnings.
-        void warningsSend(const std::vector<Warning>& warnings, const RoomCoords& coords, const std::string& eventType);
+        void warningsSend(const std::vector<Warning>& warnings, const RoomCoords& coords, context::EventID eventType);
 
         //----- Links
 
@@ -424,6 +489,10 @@ namespace dungeon
         //! @access floorRoomsCount setFloorRoomsCount changedFloorRoomsCount
         PARAMGSU(uint, m_floorRoomsCount, floorRoomsCount, setFloorRoomsCount, changedFloorRoomsCount)
 
+        //! Whether save() writes the compact binary format instead of XML.
+        //! @access binarySaves setBinarySaves
+        PARAMGS(bool, m_binarySaves, binarySaves, setBinarySaves)
+
         //! @}
 
     protected:
@@ -433,10 +502,36 @@ namespace dungeon
         //! @{
 
         //! Load dungeon data from a specified file (must exists).
+        //! The format (XML or binary) is deduced from the extension.
         void loadDungeon(const std::wstring& file);
 
         //! Save dungeon data to a specified file (must exists).
-        void saveDungeon(const std::wstring& file);
+        //! The format (XML or binary) is deduced from the extension.
+        static void saveDungeon(const Snapshot& snapshot, const std::wstring& file);
+
+        //! Load dungeon data from a XML file.
+        void loadDungeonXML(const std::wstring& file);
+
+        //! Save dungeon data to a XML file.
+        static void saveDungeonXML(const Snapshot& snapshot, const std::wstring& file);
+
+        //! Load dungeon data from a binary file.
+        void loadDungeonBinary(const std::wstring& file);
+
+        //! Save dungeon data to a binary file.
+        static void saveDungeonBinary(const Snapshot& snapshot, const std::wstring& file);
+
+        //! Encode dungeon data as saved to a binary file.
+        static std::string encodeDungeonBinary(const Snapshot& snapshot);
+
+        //! The main dungeon file to save to, in the specified folder.
+        std::wstring saveFilename(const std::wstring& folder) const;
+
+        //! The most recent existing file between the candidates, the first one if none exists.
+        std::wstring mostRecentFile(const std::vector<std::wstring>& files) const;
+
+        //! Worker thread routine, writing pending snapshots.
+        void savesRoutine();
 
         //! @}
 
@@ -501,6 +596,10 @@ namespace dungeon
         uint m_time = 0u;           //!< How much time the dungeon has been constructed, in in-game hours.
         const float m_timeGameHour; //!< Constant time: how many real seconds equals an in-game hour.
 
+        // Profiling
+        bool m_updateTimed = false;     //!< Whether the update is timed.
+        UpdateTimings m_updateTimings;  //!< The time spent in each part of the update.
+
         // Databases
         MonstersDB m_monstersDB;        //!< All monsters immuable data.
         TrapsDB m_trapsDB;              //!< All traps immuable data.
@@ -510,6 +609,15 @@ namespace dungeon
         // Generics
         std::unordered_map<std::wstring, TrapGeneric> m_trapsGenerics;          //!< More info about the trap's types.
         std::unordered_map<std::wstring, MonsterGeneric> m_monstersGenerics;    //!< More info about the monster's types.
+
+        // Background saves
+        std::thread m_savesThread;                      //!< Encodes and writes the snapshots.
+        std::mutex m_savesMutex;                        //!< Protects the pending snapshot and states below.
+        std::condition_variable m_savesCondition;       //!< Notified when a snapshot is pending or written.
+        std::unique_ptr<Snapshot> m_pendingSnapshot;    //!< The next snapshot to write, if any.
+        std::wstring m_pendingFile;                     //!< Where to write the next snapshot.
+        bool m_saving = false;                          //!< Whether a snapshot is being written.
+        bool m_savesQuit = false;                       //!< Whether the worker thread should stop.
     };
 }
 
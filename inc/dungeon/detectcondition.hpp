@@ -0,0 +1,144 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <string>
+#include <vector>
+
+namespace dungeon
+{
+    // Forward declarations
+
+    class DetectEntity;
+
+    //! A condition on the entities around a detecting one, compiled once from a string.
+    /*!
+     *  The language combines atoms with "and", "or", "not" and parentheses:
+     *  - "distance < X", with <, <=, > or >=, X being relative to the detect range factor ;
+     *  - "same_room" and "same_floor", according to the detect room size ;
+     *  - "key == K" or "key != K", comparing the detect key ;
+     *  - "data.NAME < X", with any comparison, false if the entity has no such data.
+     *
+     *  For example: "distance < 0.5 and not same_room and data.dosh > 0".
+     *  The condition is compiled to a postfix program, evaluated without allocation.
+     */
+
+    class DetectCondition final
+    {
+    public:
+
+        //! Default constructor, a condition never met.
+        DetectCondition() = default;
+
+        //! Default destructor.
+        ~DetectCondition() = default;
+
+        //--------------------//
+        //! @name Compilation
+        //! @{
+
+        //! Compile the string, replacing the previous condition.
+        //! @return False if the string is invalid, the condition being then never met.
+        bool compile(const std::string& condition);
+
+        //! The error of the last compilation, empty if none.
+        inline const std::string& error() const { return m_error; }
+
+        //! Whether the condition can be met at all.
+        inline bool valid() const { return !m_program.empty(); }
+
+        //! The range out of which no entity can meet the condition, relative as distances, or negative if unbounded.
+        inline float range() const { return m_range; }
+
+        //! @}
+
+        //-------------------//
+        //! @name Evaluation
+        //! @{
+
+        //! Whether the entity meets the condition, relatively to the detecting one.
+        bool evaluate(const DetectEntity& detecting, const DetectEntity& entity) const;
+
+        //! @}
+
+    protected:
+
+        //! The operations of the program.
+        enum class Opcode : uint8
+        {
+            DISTANCE,   //!< Push the comparison of the distance to value.
+            SAME_ROOM,  //!< Push whether both entities are in the same room.
+            SAME_FLOOR, //!< Push whether both entities are on the same floor.
+            KEY,        //!< Push the comparison of the detect key to the one at index.
+            DATA,       //!< Push the comparison of the data with attribute ID index to value.
+            NOT,        //!< Negate the top.
+            AND,        //!< Replace the two at the top with their conjunction.
+            OR,         //!< Replace the two at the top with their disjunction.
+        };
+
+        //! How an atom compares to its value.
+        enum class Comparison : uint8
+        {
+            LESS,
+            LESS_EQUAL,
+            GREATER,
+            GREATER_EQUAL,
+            EQUAL,
+            NOT_EQUAL,
+        };
+
+        //! An operation and its operands.
+        struct Instruction
+        {
+            Opcode opcode;
+            Comparison comparison = Comparison::EQUAL;
+            float value = 0.f;  //!< The value compared to.
+            uint32 index = 0u;  //!< The key index or the attribute ID.
+        };
+
+        //! A token of the condition string.
+        struct Token
+        {
+            std::string text;
+            bool number = false;
+        };
+
+        //----------------//
+        //! @name Parsing
+        //! @{
+
+        //! Split the condition into tokens.
+        bool tokenize(const std::string& condition);
+
+        //! Parse "a or b or ...", appending to the program.
+        bool parseOr();
+
+        //! Parse "a and b and ...", appending to the program.
+        bool parseAnd();
+
+        //! Parse "not a", "(a)" or an atom, appending to the program.
+        bool parseUnary();
+
+        //! Parse a comparison operator and a number.
+        bool parseComparison(Instruction& instruction, bool ordering);
+
+        //! Set the error, returning false.
+        bool fail(const std::string& error);
+
+        //! @}
+
+        //! Compare two values.
+        static bool compare(float a, Comparison comparison, float b);
+
+    private:
+
+        std::vector<Instruction> m_program; //!< Postfix.
+        std::vector<std::string> m_keys;    //!< The keys compared to.
+        float m_range = -1.f;               //!< Out of which the condition cannot be met.
+        std::string m_error;                //!< The last compilation error.
+
+        // Parsing
+        std::vector<Token> m_tokens;    //!< The tokens of the condition being compiled.
+        uint m_token = 0u;              //!< The next token to parse.
+    };
+}
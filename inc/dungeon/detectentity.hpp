@@ -1,5 +1,6 @@
 #pragma once
 
+#include "dungeon/detectcondition.hpp"
 #include "scene/entity.hpp"
 
 #include <functional>
@@ -17,9 +18,9 @@ namespace dungeon
         using baseClass = scene::Entity;
 
         friend class Detector;
+        friend class DetectCondition;
 
         using UID_t = uint32;
-        using DetectCondition = std::function<std::vector<UID_t>()>;
         using DetectCallback = std::function<void(const UID_t)>;
 
     public:
@@ -52,6 +53,10 @@ namespace dungeon
         //! Set whether this entity does range checks.
         inline void setDetectActive(bool detectActive) { m_detectActive = detectActive; }
 
+        //! Get the value of a data of the entity, compared by detect conditions.
+        //! @return False if the entity has no such data.
+        virtual bool detectData(uint32 attributeID, float& value) const { return false; }
+
         //! @}
 
     protected:
@@ -62,25 +67,32 @@ namespace dungeon
 
         void update(const sf::Time &dt, const float factor) final;
 
+        void onLocalPositionChanges() override;
+
         //! @}
 
         //------------------//
         //! @name Detection
         //! @{
 
+        //! When the callback of a signal is called, for each entity concerned.
+        enum class DetectEvent
+        {
+            ENTER,  //!< Once, when the entity starts meeting the condition.
+            STAY,   //!< Each update, while the entity meets the condition.
+            EXIT,   //!< Once, when the entity stops meeting the condition, or is destroyed.
+        };
+
         //! Add a function to call whenever a condition is met concerning an entity with the specified key.
-        //! For exemple, key = "hero", condition = "distance < 50".
-        void addDetectSignal(const std::string& key, const std::string& condition, DetectCallback callback);
+        //! For exemple, key = "hero", condition = "distance < 50 and same_floor".
+        //! An empty key lets the condition filter keys itself, and an invalid condition is never met.
+        void addDetectSignal(const std::string& key, const std::string& condition, DetectCallback callback, DetectEvent event = DetectEvent::STAY);
 
         //! Clear all detect signals from the list.
         void removeDetectSignals();
 
-        //! Analyse a condition string and create a corresponding function.
-        //! If an error occurs, the function always returns false.
-        DetectCondition interpretDetectCondition(const std::string& key, const std::string& condition);
-
-        //! Check if an entity with matching key is currently in range.
-        std::vector<UID_t> inRangeUIDs(const std::string& key, const float range) const;
+        //! Get the entities with matching key currently in range, replacing the content of UIDs.
+        void inRangeUIDs(const std::string& key, const float range, std::vector<UID_t>& UIDs) const;
 
         //! Factor applied to all range checks.
         inline void setDetectRangeFactor(const float detectRangeFactor) { m_detectRangeFactor = detectRangeFactor; }
@@ -88,6 +100,12 @@ namespace dungeon
         //! The factor applied to all range checks.
         inline float detectRangeFactor() const { return m_detectRangeFactor; }
 
+        //! Size of the rooms, for same room/floor checks.
+        inline void setDetectRoomSize(const sf::Vector2f& detectRoomSize) { m_detectRoomSize = detectRoomSize; }
+
+        //! The size of the rooms, for same room/floor checks.
+        inline const sf::Vector2f& detectRoomSize() const { return m_detectRoomSize; }
+
         //! Set the UID of the entity, should be called by detector.
         inline void setUID(UID_t inUID) { m_UID = inUID; }
 
@@ -96,8 +114,11 @@ namespace dungeon
         //! A signal testing a condition.
         struct DetectSignal
         {
-            DetectCondition condition;
-            DetectCallback callback;
+            std::string key;                        //!< The key of the entities checked, any if empty.
+            DetectCondition condition;              //!< What the entities should meet.
+            DetectCallback callback;                //!< Called for each entity concerned by the event.
+            DetectEvent event = DetectEvent::STAY;  //!< When the callback is called.
+            std::vector<UID_t> detectedUIDs;        //!< The entities meeting the condition on last update, sorted.
         };
 
     private:
@@ -105,10 +126,23 @@ namespace dungeon
         //! The UID of the entity, will be defined by the detector.
         UID_t m_UID = -1u;
 
+        //! The cell of the detector spatial index containing the entity.
+        uint64 m_detectCell = 0u;
+
+        //! When the entity has been registered to the detector, relatively to others.
+        uint32 m_detectOrder = 0u;
+
         //! Signals to activate regularly.
         std::vector<DetectSignal> m_detectSignals;
 
+        //! The entities meeting the condition of the signal being checked, reused.
+        std::vector<UID_t> m_detectUIDs;
+
+        //! The entities concerned by the event of the signal being checked, reused.
+        std::vector<UID_t> m_detectEventUIDs;
+
         float m_detectRangeFactor = 1.f;    //!< Factor applied to all range checks.
+        sf::Vector2f m_detectRoomSize;      //!< The size of the rooms, none if zero.
         bool m_detectVisible = true;        //!< Is this entity to be considered in signal checks?
         bool m_detectActive = true;         //!< Is this entity doing signal checks?
     };
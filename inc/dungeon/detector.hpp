@@ -6,18 +6,27 @@
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Time.hpp>
 
+#include <unordered_map>
 #include <functional>
 #include <string>
 #include <vector>
-#include <list>
 
 namespace dungeon
 {
     // Forward declarations
 
     class DetectEntity;
+    class DetectCondition;
 
     //! Detect proximity of entities and inform them consequently.
+    /*!
+     *  Entities are indexed in a uniform grid (spatial hash) of their local positions,
+     *  so that range queries only visit the cells around the position.
+     *  The results are exactly the same than a scan of all entities, in the same order.
+     *
+     *  Entities are stored contiguously and their UID is a generational index of a slot,
+     *  so that find/add/remove are O(1) and stale UIDs are resolved to nullptr.
+     */
 
     class Detector final : private sf::NonCopyable
     {
@@ -49,15 +58,31 @@ namespace dungeon
 
         //! @}
 
+        //----------------------//
+        //! @name Spatial index
+        //! @{
+
+        //! Set the size of the cells of the spatial index.
+        //! Range queries are the most efficient when the usual range is about one cell.
+        void setCellSize(float cellSize);
+
+        //! Whether range queries use the spatial index or scan all the entities.
+        inline void setIndexed(bool indexed) { m_indexed = indexed; }
+
+        //! @}
+
     protected:
 
         //------------------//
         //! @name Detection
         //! @{
 
-        //! Check if there is an entity with matching key in range of the one specified.
-        //! @return The UID of the entity detected, or -1u if none.
-        std::vector<UID_t> inRangeUIDs(const DetectEntity& entity, const std::string& key, const float range) const;
+        //! Get the entities with matching key in range of the one specified, replacing the content of UIDs.
+        void inRangeUIDs(const DetectEntity& entity, const std::string& key, const float range, std::vector<UID_t>& UIDs) const;
+
+        //! Get the entities with matching key, any if empty, that meet the condition relatively to the one specified.
+        //! Only the entities within the range of the condition are evaluated.
+        void detect(const DetectEntity& entity, const std::string& key, const DetectCondition& condition, std::vector<UID_t>& UIDs) const;
 
         //! @}
 
@@ -73,6 +98,31 @@ namespace dungeon
         //! Should be called by the destructor of DetectEntity.
         void removeEntity(DetectEntity& entity);
 
+        //! Move the entity to the cell of its current position.
+        //! Should be called by DetectEntity whenever its local position changes.
+        void refreshEntity(DetectEntity& entity);
+
+        //! Remove the holes left by removed entities, keeping the order.
+        void compact();
+
+        //! @}
+
+        //----------------------//
+        //! @name Spatial index
+        //! @{
+
+        //! The key of the cell containing the position.
+        uint64 cellKey(const sf::Vector2f& position) const;
+
+        //! Add the entity to the cell it belongs to.
+        void cellInsert(DetectEntity& entity);
+
+        //! Remove the entity from the cell it belongs to.
+        void cellRemove(DetectEntity& entity);
+
+        //! Get all entities that might be in range of the position, sorted by registering order.
+        void candidatesInRange(const sf::Vector2f& position, float range, std::vector<DetectEntity*>& candidates) const;
+
         //! @}
 
         //! Type of action for pending ones.
@@ -89,16 +139,45 @@ namespace dungeon
             DetectEntity* pEntity;
         };
 
+        //! Where to find the entity of an UID.
+        struct Slot
+        {
+            uint32 generation = 0u; //!< Incremented each time the slot is freed.
+            uint32 index = -1u;     //!< The index of the entity in m_entities, or -1u if the slot is free.
+        };
+
+        //! How many of the low bits of the UID are for the slot, others being the generation.
+        static constexpr uint32 s_slotBits = 20u;
+
+        //! The mask to get the slot from an UID.
+        static constexpr uint32 s_slotMask = (1u << s_slotBits) - 1u;
+
     private:
 
-        //! All registered entities.
-        std::list<DetectEntity*> m_entities;
+        //! All registered entities, in registering order, nullptr where one was removed.
+        std::vector<DetectEntity*> m_entities;
+        uint32 m_holesCount = 0u;   //!< How many nullptr are in m_entities.
+
+        //! The slots, indexed by the low bits of the UIDs.
+        std::vector<Slot> m_slots;
+
+        //! The slots that are free to use.
+        std::vector<uint32> m_freeSlots;
+
+        //! The spatial index, all entities of a cell by its key.
+        std::unordered_map<uint64, std::vector<DetectEntity*>> m_cells;
+
+        float m_cellSize = 100.f;   //!< The size of a cell of the spatial index.
+        bool m_indexed = true;      //!< Whether the spatial index is used for range queries.
+
+        //! The candidates of the applyInRange() in progress, if any.
+        std::vector<DetectEntity*>* m_applyingCandidates = nullptr;
 
         //! Actions we delayed.
         std::vector<PendingAction> m_pendingActions;
 
-        //! Remember the next UID to be set.
-        UID_t m_UIDGenerator = 0u;
+        //! Remember the next registering order to be set.
+        uint32 m_orderGenerator = 0u;
     };
 
     //! Global detector.
@@ -18,8 +18,8 @@ namespace dungeon
 
     public:
 
-        //! Constructor.
-        Dynamic(Inter& inter);
+        //! Constructor, the handle being the one of its info within the manager.
+        Dynamic(uint32 managerHandle, Inter& inter);
 
         //! Default destructor.
         virtual ~Dynamic() = default;
@@ -33,12 +33,23 @@ namespace dungeon
 
         //! @}
 
+        //----------------//
+        //! @name Manager
+        //! @{
+
+        //! The handle of the dynamic info within the manager.
+        inline uint32 managerHandle() const { return m_managerHandle; }
+
+        //! @}
+
     protected:
 
         //----------------//
         //! @name Lua API
         //! @{
 
+        void registerLuaAPI(scene::LuaVM& vm) override;
+
         //! Destroy this entity.
         void lua_dynamicRemoveSelf();
 
@@ -48,5 +59,8 @@ namespace dungeon
 
         //! The id of the dynamic.
         std::wstring m_elementID;
+
+        //! The handle of the dynamic info within the manager.
+        uint32 m_managerHandle;
     };
 }
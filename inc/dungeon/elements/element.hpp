@@ -4,8 +4,10 @@
 #include "dungeon/detectentity.hpp"
 #include "scene/wrappers/animatedsprite.hpp"
 #include "nui/mouseoverlay.hpp"
+#include "scene/components/ai.hpp"
 
-#include <selene/selene.hpp>
+#include <functional>
+#include <vector>
 
 namespace dungeon
 {
@@ -32,8 +34,8 @@ namespace dungeon
         //! Constructor.
         Element(dungeon::Inter& inter);
 
-        //! Default destructor.
-        virtual ~Element() = default;
+        //! Destructor.
+        virtual ~Element();
 
         //---------------------//
         //! @name Element data
@@ -45,6 +47,9 @@ namespace dungeon
         //! Quick access to element data.
         inline ElementData& edata() { return *m_edata; }
 
+        //! Unsigned and float data can be compared by detect conditions.
+        bool detectData(uint32 attributeID, float& value) const final;
+
         //! @}
 
         //------------------//
@@ -60,8 +65,14 @@ namespace dungeon
         //! @name Lua
         //! @{
 
-        //! Access the lua state.
-        sel::State& lua() { return *m_lua; }
+        //! Access the lua state, within the environment of this element.
+        inline scene::LuaScope lua() { return m_ai->lua(); }
+
+        //! Load the lua script, the API being registered if the VM is a new one.
+        bool loadLua(const std::string& file);
+
+        //! The VM running the script, nullptr if none loaded.
+        inline scene::LuaVM* vm() { return m_ai->vm(); }
 
         //! @}
 
@@ -77,6 +88,18 @@ namespace dungeon
 
         //! @}
 
+        //-----------------------//
+        //! @name Deferred calls
+        //! @{
+
+        //! Set whether Lua calls affecting more than the element are recorded instead of applied.
+        inline void setDeferring(bool deferring) { m_deferring = deferring; }
+
+        //! Apply the calls recorded while deferring, in order, and forget them.
+        void applyDeferredCalls();
+
+        //! @}
+
         //---------------//
         //! @name Events
         //! @{
@@ -103,9 +126,41 @@ namespace dungeon
         //! @name Lua API
         //! @{
 
-        //! Calling detector.
+        //! Register the lua API into a new VM.
+        //! Bindings are shared by all elements using the VM, and forward to the active one.
+        virtual void registerLuaAPI(scene::LuaVM& vm);
+
+        //! Register a method as a lua function, called on the active element of the VM.
+        template <class Element_t, class Return_t, class... Args>
+        static void luaBind(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...));
+
+        //! Register a const method as a lua function, called on the active element of the VM.
+        template <class Element_t, class Return_t, class... Args>
+        static void luaBind(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...) const);
+
+        //! Register a method affecting more than the element itself.
+        //! While the element is deferring, the call is recorded instead, to be applied later.
+        template <class Element_t, class... Args>
+        static void luaBindDeferred(scene::LuaVM& vm, const char* name, void (Element_t::*method)(Args...));
+
+        //! Register a const method affecting more than the element itself, recorded while deferring.
+        template <class Element_t, class... Args>
+        static void luaBindDeferred(scene::LuaVM& vm, const char* name, void (Element_t::*method)(Args...) const);
+
+        //! Register a method which result depends on more than the element itself.
+        //! It cannot be called while the element is deferring, a default value being returned.
+        template <class Element_t, class Return_t, class... Args>
+        static void luaBindSerial(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...));
+
+        //! Calling detector, each update while an entity meets the condition.
         void lua_callbackRegister(const std::string& luaKey, const std::string& entityType, const std::string& condition);
 
+        //! Calling detector, once when an entity starts meeting the condition.
+        void lua_callbackEnterRegister(const std::string& luaKey, const std::string& entityType, const std::string& condition);
+
+        //! Calling detector, once when an entity stops meeting the condition.
+        void lua_callbackExitRegister(const std::string& luaKey, const std::string& entityType, const std::string& condition);
+
         //! Add action callback whenever a left click happens.
         void lua_callbackClickLeftSet(const std::string& luaKey, const std::string& actionName);
 
@@ -121,7 +176,7 @@ namespace dungeon
         bool lua_setDataBool(const std::string& s, const bool value);
 
         //! Get the correponding eData.
-        bool lua_getDataBool(const std::string& s) const;
+        bool lua_getDataBool(const std::string& s);
 
         //! Init the eData with the value if empty.
         bool lua_initEmptyDataBool(const std::string& s, const bool value);
@@ -130,7 +185,7 @@ namespace dungeon
         uint32 lua_setDataU32(const std::string& s, const uint32 value);
 
         //! Get the correponding eData.
-        uint32 lua_getDataU32(const std::string& s) const;
+        uint32 lua_getDataU32(const std::string& s);
 
         //! Set the eData with the value specified.
         uint32 lua_addDataU32(const std::string& s, const uint32 value);
@@ -142,7 +197,7 @@ namespace dungeon
         lua_Number lua_setDataFloat(const std::string& s, const lua_Number value);
 
         //! Get the correponding eData.
-        lua_Number lua_getDataFloat(const std::string& s) const;
+        lua_Number lua_getDataFloat(const std::string& s);
 
         //! Set the eData with the value specified.
         lua_Number lua_addDataFloat(const std::string& s, const lua_Number value);
@@ -150,6 +205,48 @@ namespace dungeon
         //! Init the eData with the value if empty.
         lua_Number lua_initEmptyDataFloat(const std::string& s, const lua_Number value);
 
+        //----- Element data from attribute
+
+        //! Get the handle of an attribute, to be resolved once and passed to the functions below.
+        //! Invalid handles are reported, nothing being changed and a default value being returned.
+        uint32 lua_attribute(const std::string& s) const;
+
+        //! Whether the handle given by Lua is valid, reporting it otherwise.
+        bool checkAttribute(const uint32 id);
+
+        //! Set the eData with the value specified.
+        bool lua_setDataBoolID(const uint32 id, const bool value);
+
+        //! Get the correponding eData.
+        bool lua_getDataBoolID(const uint32 id);
+
+        //! Init the eData with the value if empty.
+        bool lua_initEmptyDataBoolID(const uint32 id, const bool value);
+
+        //! Set the eData with the value specified.
+        uint32 lua_setDataU32ID(const uint32 id, const uint32 value);
+
+        //! Get the correponding eData.
+        uint32 lua_getDataU32ID(const uint32 id);
+
+        //! Add the value specified to the eData.
+        uint32 lua_addDataU32ID(const uint32 id, const uint32 value);
+
+        //! Init the eData with the value if empty.
+        uint32 lua_initEmptyDataU32ID(const uint32 id, const uint32 value);
+
+        //! Set the eData with the value specified.
+        lua_Number lua_setDataFloatID(const uint32 id, const lua_Number value);
+
+        //! Get the correponding eData.
+        lua_Number lua_getDataFloatID(const uint32 id);
+
+        //! Add the value specified to the eData.
+        lua_Number lua_addDataFloatID(const uint32 id, const lua_Number value);
+
+        //! Init the eData with the value if empty.
+        lua_Number lua_initEmptyDataFloatID(const uint32 id, const lua_Number value);
+
         //----- Element data from UID
 
         //! Set the eData with the value specified.
@@ -255,11 +352,17 @@ namespace dungeon
         Inter& m_inter;                 //!< To be able to interact with nearby elements.
         ElementData* m_edata = nullptr; //!< The data of the element.
         scene::AnimatedSprite m_sprite; //!< The sprite.
-        sel::State* m_lua = nullptr;    //!< The lua state.
+        scene::AI* m_ai = nullptr;      //!< The lua state.
 
         // Click actions
         ClickAction m_leftClickAction;      //!< When left click is pressed.
         ClickAction m_rightClickAction;     //!< When right click is pressed.
         nui::MouseOverlay m_mouseOverlay;   //!< Display for the mouse actions.
+
+        // Deferred calls
+        bool m_deferring = false;                           //!< Are Lua calls affecting the dungeon recorded?
+        std::vector<std::function<void()>> m_deferredCalls; //!< The calls recorded, in order.
     };
 }
+
+#include "dungeon/elements/element.inl"
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <iostream>
+
+namespace dungeon
+{
+    //-------------------//
+    //----- Lua API -----//
+
+    template <class Element_t, class Return_t, class... Args>
+    inline void Element::luaBind(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...))
+    {
+        auto pVM = &vm;
+        vm.state()[name] = std::function<Return_t(Args...)>([pVM, method] (Args... args) {
+            return (static_cast<Element_t*>(pVM->active())->*method)(std::forward<Args>(args)...);
+        });
+    }
+
+    template <class Element_t, class Return_t, class... Args>
+    inline void Element::luaBind(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...) const)
+    {
+        auto pVM = &vm;
+        vm.state()[name] = std::function<Return_t(Args...)>([pVM, method] (Args... args) {
+            return (static_cast<const Element_t*>(pVM->active())->*method)(std::forward<Args>(args)...);
+        });
+    }
+
+    template <class Element_t, class... Args>
+    inline void Element::luaBindDeferred(scene::LuaVM& vm, const char* name, void (Element_t::*method)(Args...))
+    {
+        auto pVM = &vm;
+        vm.state()[name] = std::function<void(Args...)>([pVM, method] (Args... args) {
+            auto element = static_cast<Element_t*>(pVM->active());
+            if (element->m_deferring) {
+                element->m_deferredCalls.emplace_back([element, method, args...] { (element->*method)(args...); });
+                return;
+            }
+            (element->*method)(std::forward<Args>(args)...);
+        });
+    }
+
+    template <class Element_t, class... Args>
+    inline void Element::luaBindDeferred(scene::LuaVM& vm, const char* name, void (Element_t::*method)(Args...) const)
+    {
+        auto pVM = &vm;
+        vm.state()[name] = std::function<void(Args...)>([pVM, method] (Args... args) {
+            auto element = static_cast<Element_t*>(pVM->active());
+            if (element->m_deferring) {
+                element->m_deferredCalls.emplace_back([element, method, args...] { (element->*method)(args...); });
+                return;
+            }
+            (element->*method)(std::forward<Args>(args)...);
+        });
+    }
+
+    template <class Element_t, class Return_t, class... Args>
+    inline void Element::luaBindSerial(scene::LuaVM& vm, const char* name, Return_t (Element_t::*method)(Args...))
+    {
+        auto pVM = &vm;
+        vm.state()[name] = std::function<Return_t(Args...)>([pVM, name, method] (Args... args) {
+            auto element = static_cast<Element_t*>(pVM->active());
+
+            // Reported with the recorded calls, so from the main thread
+            if (element->m_deferring) {
+                element->m_deferredCalls.emplace_back([name] {
+                    std::cerr << "/!\\ LUA " << name << "() cannot be called while evaluating the graph." << std::endl;
+                });
+                return Return_t();
+            }
+            return (element->*method)(std::forward<Args>(args)...);
+        });
+    }
+}
@@ -1,19 +1,26 @@
 #pragma once
 
 #include "tools/metadata.hpp"
+#include "tools/binary.hpp"
 #include "tools/tools.hpp"
 #include "tools/debug.hpp"
 #include "tools/platform-fixes.hpp" // find_if
 
 #include <pugixml/pugixml.hpp>
-#include <unordered_map>
+#include <vector>
 #include <string>
 
 namespace dungeon
 {
+    //! An attribute name, interned once to avoid string hashing on each access.
+    using AttributeID = uint32;
+
     /*!
      *  A dynamic structure holding dungeon element information
-     *  and which can be exported and imported as XML.
+     *  and which can be exported and imported as XML or binary.
+     *
+     *  Attributes are stored flat, in insertion order, and searched by AttributeID.
+     *  Note: adding an attribute invalidates references to the others.
      */
 
     class ElementData final
@@ -37,10 +44,31 @@ namespace dungeon
         void create(std::wstring type);
 
         //! Returns true if the data has no attributes.
-        inline bool empty() const { return m_attributes.empty(); }
+        inline bool empty() const { return m_ids.empty(); }
+
+        //! Whether an attribute exists or not.
+        bool exists(AttributeID id) const;
 
         //! Whether an attribute exists or not.
-        bool exists(const std::wstring& name) const;
+        inline bool exists(const std::wstring& name) const { return exists(attributeID(name)); }
+
+        //! @}
+
+        //------------------//
+        //! @name Symbols
+        //! @{
+
+        //! Get the interned ID of an attribute name, to be resolved once and reused.
+        static AttributeID attributeID(const std::wstring& name);
+
+        //! Get the interned ID of an attribute name, to be resolved once and reused.
+        static AttributeID attributeID(const std::string& name);
+
+        //! Whether the ID is one of an interned attribute.
+        static bool attributeInterned(AttributeID id);
+
+        //! Get the name of an interned attribute, safe from any thread and valid forever.
+        static const std::wstring& attributeName(AttributeID id);
 
         //! @}
 
@@ -56,18 +84,39 @@ namespace dungeon
 
         //! @}
 
+        //---------------------------//
+        //! @name Binary interaction
+        //! @{
+
+        //! Save data to the binary stream.
+        void saveBinary(BinaryWriter& writer) const;
+
+        //! Load data from the binary stream.
+        void loadBinary(BinaryReader& reader);
+
+        //! @}
+
         //----------------//
         //! @name Getters
         //! @{
 
         //! Access an existing attribute (const).
-        inline const MetaData& at(const std::wstring& name) const { return m_attributes.at(name); }
+        const MetaData& at(AttributeID id) const;
+
+        //! Access an existing attribute.
+        inline MetaData& at(AttributeID id) { return const_cast<MetaData&>(static_cast<const ElementData&>(*this).at(id)); }
+
+        //! Access an existing attribute (const).
+        inline const MetaData& at(const std::wstring& name) const { return at(attributeID(name)); }
 
         //! Access an existing attribute.
-        inline MetaData& at(const std::wstring& name) { return m_attributes.at(name); }
+        inline MetaData& at(const std::wstring& name) { return at(attributeID(name)); }
 
-        //! Access an attribute.
-        inline MetaData& operator[](const std::wstring& name) { return m_attributes[name]; }
+        //! Access an attribute, created if it does not exist.
+        MetaData& operator[](AttributeID id);
+
+        //! Access an attribute, created if it does not exist.
+        inline MetaData& operator[](const std::wstring& name) { return operator[](attributeID(name)); }
 
         //! Whether the data exists (false if cleared or just created).
         inline bool exists() const { return m_exists; }
@@ -77,13 +126,31 @@ namespace dungeon
 
         //! @}
 
+    protected:
+
+        //! The index of the attribute, -1u if it does not exist.
+        uint find(AttributeID id) const;
+
     private:
 
         bool m_exists = false;  //!< Whether the data exists or not.
         std::wstring m_type;    //!< The type of data.
-        std::unordered_map<std::wstring, MetaData> m_attributes; //!< The attributes.
+
+        // Attributes
+        std::vector<AttributeID> m_ids; //!< The attributes names, searched linearly.
+        std::vector<MetaData> m_values; //!< The attributes values, in the same order.
     };
 
+    //! Attributes commonly used by the engine.
+    namespace attributes
+    {
+        extern const AttributeID rx;    //!< Current relative position.
+        extern const AttributeID ry;    //!< Current relative position.
+        extern const AttributeID tx;    //!< Target relative position.
+        extern const AttributeID ty;    //!< Target relative position.
+        extern const AttributeID dosh;  //!< Dosh held.
+    }
+
     //------------------------------//
     //----- External functions -----//
 
@@ -105,3 +172,4 @@ namespace dungeon
     }
 }
 
+#include "dungeon/elements/elementdata.inl"
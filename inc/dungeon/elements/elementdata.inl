@@ -0,0 +1,46 @@
+#pragma once
+
+namespace dungeon
+{
+    //------------------------//
+    //----- Manipulation -----//
+
+    inline bool ElementData::exists(AttributeID id) const
+    {
+        returnif (!m_exists) false;
+        auto index = find(id);
+        returnif (index == -1u) false;
+        return m_values[index].type() != MetaType::NONE;
+    }
+
+    //-------------------//
+    //----- Getters -----//
+
+    inline const MetaData& ElementData::at(AttributeID id) const
+    {
+        auto index = find(id);
+        if (index == -1u) mquit("Accessing a non-existing attribute '" + toString(attributeName(id)) + "' of ElementData.");
+        return m_values[index];
+    }
+
+    inline MetaData& ElementData::operator[](AttributeID id)
+    {
+        auto index = find(id);
+        returnif (index != -1u) m_values[index];
+
+        m_ids.emplace_back(id);
+        m_values.emplace_back();
+        return m_values.back();
+    }
+
+    //---------------------//
+    //----- Internals -----//
+
+    inline uint ElementData::find(AttributeID id) const
+    {
+        for (uint i = 0u; i < m_ids.size(); ++i)
+            if (m_ids[i] == id)
+                return i;
+        return -1u;
+    }
+}
@@ -60,6 +60,8 @@ namespace dungeon
         //! @name Lua API
         //! @{
 
+        void registerLuaAPI(scene::LuaVM& vm) override;
+
         //! Does a facility with the specified ID exists in the same room?
         bool lua_hasSiblingFacility(const std::string& facilityID) const;
 
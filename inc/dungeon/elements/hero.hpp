@@ -16,8 +16,8 @@ namespace dungeon
 
     public:
 
-        //! Constructor.
-        Hero(HeroesManager& manager, Inter& inter, Graph& graph);
+        //! Constructor, the handle being the one of its info within the manager.
+        Hero(HeroesManager& manager, uint32 managerHandle, Inter& inter, Graph& graph);
 
         //! Default destructor.
         ~Hero() = default;
@@ -44,6 +44,15 @@ namespace dungeon
 
         //! @}
 
+        //----------------//
+        //! @name Manager
+        //! @{
+
+        //! The handle of the hero info within the manager.
+        inline uint32 managerHandle() const { return m_managerHandle; }
+
+        //! @}
+
     protected:
 
         //---------------------//
@@ -58,16 +67,23 @@ namespace dungeon
         //! @name Lua API
         //! @{
 
+        void registerLuaAPI(scene::LuaVM& vm) override;
+
         //! When the hero wants to get out.
         void lua_getOut();
 
         //! When the hero wants to steal money from treasure.
         uint lua_stealTreasure();
 
+        //! Steal money from treasure, adding it to the specified data.
+        //! As nothing is returned, this can be deferred while evaluating the graph.
+        void lua_stealTreasureInto(const std::string& attribute);
+
         //! @}
 
     private:
 
         HeroesManager& m_manager;   //!< The heroes manager.
+        uint32 m_managerHandle;     //!< The handle of the hero info within the manager.
     };
 }
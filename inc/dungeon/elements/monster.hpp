@@ -12,8 +12,8 @@ namespace dungeon
 
     public:
 
-        //! Constructor.
-        Monster(Inter& inter, Graph& graph);
+        //! Constructor, the handle being the one of its info within the manager.
+        Monster(uint32 managerHandle, Inter& inter, Graph& graph);
 
         //! Default destructor.
         ~Monster() = default;
@@ -30,6 +30,15 @@ namespace dungeon
 
         //! @}
 
+        //----------------//
+        //! @name Manager
+        //! @{
+
+        //! The handle of the monster info within the manager.
+        inline uint32 managerHandle() const { return m_managerHandle; }
+
+        //! @}
+
     protected:
 
         //---------------------//
@@ -39,5 +48,9 @@ namespace dungeon
         void rebindElementData() final;
 
         //! @}
+
+    private:
+
+        uint32 m_managerHandle; //!< The handle of the monster info within the manager.
     };
 }
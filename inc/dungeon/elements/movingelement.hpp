@@ -3,6 +3,8 @@
 #include "dungeon/graph.hpp"
 #include "dungeon/elements/dynamicelement.hpp"
 
+#include <tuple>
+
 namespace dungeon
 {
     //! A generic moving element interface.
@@ -22,6 +24,21 @@ namespace dungeon
             uint altitude = 0u;     //!< How high is the node.
             uint treasure = 0u;     //!< How much money there is stored in this node.
             bool exit = false;      //!< Whether the hero can exit the dungeon by this node or not.
+
+            // Those come from the graph distance fields, -1u if unreachable
+            uint exitDistance = -1u;        //!< How many moves to the closest exit.
+            uint treasureDistance = -1u;    //!< How many moves to the closest treasure.
+
+            // Where the node is
+            uint x = 0u;            //!< The floor of the node.
+            uint y = 0u;            //!< The room of the node within its floor.
+        };
+
+        //! A node extra information.
+        struct NodeInfo
+        {
+            uint visits = 0u;           //!< How many times the node has been visited.
+            uint16 lastVisit = 0x7FFF;  //!< The tick of the last time the node has been visited.
         };
 
         //! The way to the next room.
@@ -31,6 +48,15 @@ namespace dungeon
             const Graph::NeighbourData* neighbourData = nullptr;    //!< The graph neighbour that get us here (if any).
         };
 
+        //! A decision taken beforehand, concurrently with other elements.
+        struct Decision
+        {
+            bool pending = false;                   //!< Whether the decision is to be used by the next update.
+            bool due = false;                       //!< Whether the AI is to be updated, neither walking nor pausing.
+            uint graphVersion = -1u;                //!< The graph version the best nodes were found for.
+            const Graph::NodeData* node = nullptr;  //!< The node the best nodes were found from.
+        };
+
     public:
 
         //! Constructor.
@@ -66,6 +92,18 @@ namespace dungeon
 
         //! @}
 
+        //--------------------//
+        //! @name Decision
+        //! @{
+
+        //! Find the best rooms to go next, for the coming update to pick one of them.
+        //! Lua calls affecting the rest of the dungeon are deferred to that update,
+        //! so that elements not sharing a VM can decide concurrently.
+        //! The graph distances should have been refreshed beforehand.
+        void decide(const sf::Time& dt);
+
+        //! @}
+
     protected:
 
         //----------------//
@@ -81,12 +119,21 @@ namespace dungeon
         //! @name Lua API
         //! @{
 
+        void registerLuaAPI(scene::LuaVM& vm) override;
+
         //! Will stop the entity to move and won't call for nextNode anymore.
         void lua_setMoving(bool moving);
 
         //! Returns true if the current direction is matching.
         bool lua_isLookingDirection(const std::string& direction) const;
 
+        //! The next room to go to in order to reach the specified one,
+        //! the current room if there is no way or if the room is outside the dungeon.
+        std::tuple<uint32, uint32> lua_pathNext(uint32 x, uint32 y);
+
+        //! How many moves to reach the specified room, -1u if there is no way or if the room is outside the dungeon.
+        uint32 lua_distanceTo(uint32 x, uint32 y);
+
         //! @}
 
         //--------------------------------//
@@ -99,18 +146,46 @@ namespace dungeon
         //! Reinits the state to start a fresh new run.
         void reinit();
 
-        //! Updates the AI.
+        //! Whether the AI is to be updated, neither walking nor pausing, the pause being updated.
+        bool aiDue(const sf::Time& dt);
+
+        //! Visit the current node, then pick randomly among the best nodes.
         NodeWay findNextNode(const Graph::NodeData* currentNode);
 
+        //! Remember a visit to the node.
+        void visit(const Graph::NodeData* node);
+
+        //! Find the best nodes to go to from the current one, which is among them if it is as good.
+        void findBestNodes(const Graph::NodeData* currentNode);
+
+        //! Get the evaluations of the current node, then of each of its neighbours.
+        void evaluate(const Graph::NodeData* currentNode, std::vector<int>& evaluations);
+
+        //! Get all evaluations in one Lua call, if the script defines _evaluateAll.
+        //! @return False if the script uses the per-node callbacks.
+        bool evaluateAll(const Graph::NodeData* currentNode, std::vector<int>& evaluations);
+
         //! Select the node to move the hero to.
         void setCurrentNode(const NodeWay& nodeWay);
 
         //! Get all weight information from a node.
         Weight getWeight(const Graph::NodeData* node);
 
-        //! Returns the evaluation of a Lua function given a node.
+        //! The visits information of a node.
+        NodeInfo& nodeInfo(const RoomCoords& coords);
+
+        //! Fit the visits information to the graph size, keeping the rooms still existing.
+        void resizeNodeInfos();
+
+        //! Returns the evaluation of a Lua function given a node, read through the eev_weight getters.
         uint call(const char* function, const Graph::NodeData* node);
 
+        //! Push the table read by the eev_weight getters, creating them the first time.
+        static void pushWeightValues(lua_State* L);
+
+        //! Fill the fields of a Lua table with a weight.
+        static void pushWeight(lua_State* L, const Weight& weight);
+
         //! @}
 
         //--------------------------------//
@@ -128,13 +203,6 @@ namespace dungeon
 
         //! @}
 
-        //! A node extra information.
-        struct NodeInfo
-        {
-            uint visits = 0u;           //!< How many times the node has been visited.
-            uint16 lastVisit = 0x7FFF;  //!< The tick of the last time the node has been visited.
-        };
-
     protected:
 
         Graph& m_graph;                 //!< Abstract dungeon graph.
@@ -143,7 +211,12 @@ namespace dungeon
 
         // Graph evaluation for AI
         uint m_tick = 0u;                                       //!< The current tick (how many nodes has been visited so far).
-        std::unordered_map<RoomCoords, NodeInfo> m_nodeInfos;   //!< Remembers the visits of a certain node.
+        std::vector<NodeInfo> m_nodeInfos;                      //!< Remembers the visits of a certain node, floor-major.
+        uint8 m_nodeInfosFloorsCount = 0u;                      //!< The graph floors count the visits are laid out for.
+        uint8 m_nodeInfosFloorRoomsCount = 0u;                  //!< The graph rooms per floor the visits are laid out for.
+        std::vector<int> m_evaluations;                         //!< The last evaluations, kept to reuse the memory.
+        std::vector<NodeWay> m_bestNodes;                       //!< The last best nodes, kept to reuse the memory.
+        Decision m_decision;                                    //!< The decision taken beforehand, if any.
 
         // Tunnel state
         bool m_inTunnel = false;                //!< Is the element inside a tunnel?
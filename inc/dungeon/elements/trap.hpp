@@ -49,6 +49,8 @@ namespace dungeon
         //! @name Lua API
         //! @{
 
+        void registerLuaAPI(scene::LuaVM& vm) override;
+
         //! Indicate that harvestable dosh has changed.
         void lua_warnHarvestableDosh();
 
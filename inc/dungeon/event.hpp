@@ -3,6 +3,8 @@
 #include "context/event.hpp"
 #include "tools/int.hpp"
 
+#include <cstring>
+
 namespace dungeon
 {
     // Forward declarations
@@ -19,6 +21,9 @@ namespace dungeon
     //! A dungeon event.
     struct Event : public context::Event
     {
+        //! Zeroed, padding included, so that coalescing can compare events.
+        Event() { std::memset(static_cast<void*>(this), 0, sizeof(Event)); }
+
         union
         {
             int delta;              //!< The difference between previous and current value of resources.
@@ -32,4 +37,30 @@ namespace dungeon
             } monster;
         };
     };
+
+    //! Events emitted by the dungeon data.
+    namespace events
+    {
+        extern const context::EventID dungeonChanged;          //!< Dungeon rooms or elements changed.
+        extern const context::EventID dungeonStructureChanged; //!< Dungeon size changed.
+        extern const context::EventID dungeonGraphChanged;     //!< The graph has been updated.
+        extern const context::EventID roomConstructed;         //!< A room has been constructed.
+        extern const context::EventID roomDestroyed;           //!< A room has been destroyed.
+        extern const context::EventID roomChanged;             //!< A room moved.
+        extern const context::EventID roomHideChanged;         //!< The hide flags of a room changed.
+        extern const context::EventID facilityChanged;         //!< A facility of the room changed.
+        extern const context::EventID trapChanged;             //!< The trap of the room changed.
+        extern const context::EventID treasureChanged;         //!< The treasure of the room changed.
+        extern const context::EventID harvestableDoshChanged;  //!< The dosh to harvest in the room changed.
+        extern const context::EventID trapGenericChanged;      //!< A trap type has been unlocked or locked.
+        extern const context::EventID monsterGenericChanged;   //!< A monster type has been unlocked or locked.
+        extern const context::EventID monsterAdded;            //!< A monster has been hired.
+        extern const context::EventID reserveCountdownChanged; //!< The countdown before hiring a monster type changed.
+        extern const context::EventID timeChanged;             //!< The game time changed.
+        extern const context::EventID debtChanged;             //!< The debt changed.
+        extern const context::EventID doshChanged;             //!< The villain dosh changed.
+        extern const context::EventID evilChanged;             //!< The villain evilness changed.
+        extern const context::EventID soulChanged;             //!< The soul resource changed.
+        extern const context::EventID fameChanged;             //!< The fame resource changed.
+    }
 }
@@ -5,6 +5,10 @@
 #include "context/event.hpp"
 #include "dungeon/structs/room.hpp"
 
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
 namespace dungeon
 {
     // Forward declarations
@@ -19,6 +23,7 @@ namespace dungeon
     public:
 
         //! The abstraction of a passage between two dungeon rooms.
+        //! Interned, passages through the same tunnel facility type share it.
         struct NeighbourData
         {
             std::wstring tunnelFacilityID;  //!< The ID of the facility providing this way (empty if not a tunnel way).
@@ -40,7 +45,7 @@ namespace dungeon
             uint treasure = 0u;         //!< How many money there is stored in the node (total).
             bool entrance = false;      //!< Whether the node is an entrance or not.
 
-            std::vector<std::unique_ptr<NeighbourData>> neighbours; //!< Extra info about its neighbourhood.
+            uint edgesOffset = 0u;      //!< Where its neighbours start within the graph edges.
         };
 
     public:
@@ -48,8 +53,8 @@ namespace dungeon
         //! Default constructor.
         Graph() = default;
 
-        //! Default destructor.
-        ~Graph() = default;
+        //! Destructor.
+        ~Graph();
 
         //---------------------//
         //! @name Dungeon data
@@ -58,6 +63,14 @@ namespace dungeon
         //! The data of the dungeon to be read from.
         void useData(Data& data);
 
+        //! Mark a room as changed, it and the nodes leading to it
+        //! will be updated on the next dungeon change.
+        void invalidateRoom(const RoomCoords& coords);
+
+        //! Forget about invalidated rooms,
+        //! the whole graph will be updated on the next dungeon change.
+        void invalidateAll();
+
         //! @}
 
         //--------------------//
@@ -70,6 +83,40 @@ namespace dungeon
         //! Simple getter to access nodes data.
         const NodeData* nodeData(const RoomCoords& coords) const;
 
+        //! How many floors the graph covers.
+        inline uint8 floorsCount() const { return m_floorsCount; }
+
+        //! How many rooms per floor the graph covers.
+        inline uint8 floorRoomsCount() const { return m_floorRoomsCount; }
+
+        //! @}
+
+        //------------------//
+        //! @name Distances
+        //! Moves needed to reach a room, -1u if unreachable.
+        //! Distance fields are computed on first request, and kept until the graph changes.
+        //! Once refreshDistances() called, they can be read from several threads until the graph changes.
+        //! @{
+
+        //! Changes each time the passages, entrances or treasures change.
+        inline uint version() const { return m_version; }
+
+        //! Compute the fields to entrances and treasures now, if the graph changed.
+        void refreshDistances();
+
+        //! Distance to the closest entrance.
+        uint entranceDistance(const RoomCoords& coords);
+
+        //! Distance to the closest room with treasure.
+        uint treasureDistance(const RoomCoords& coords);
+
+        //! Distance from a room to another.
+        uint distance(const RoomCoords& from, const RoomCoords& to);
+
+        //! The neighbour to go to in order to get closer to the target room.
+        //! @return nullptr if already there or if unreachable.
+        const NodeData* nextTowards(const RoomCoords& from, const RoomCoords& to);
+
         //! @}
 
     protected:
@@ -86,8 +133,14 @@ namespace dungeon
         //! @name Graph construction
         //! @{
 
-        //! Add a neighbour to a node.
-        void addNodeNeighbour(NodeData& nodeData, const RoomCoords& neighbourCoords, const std::wstring& tunnelFacilityID = L"");
+        //! Get the interned extra info for a passage.
+        NeighbourData* neighbourData(const std::wstring& tunnelFacilityID);
+
+        //! Add a neighbour to the node being rebuilt.
+        void addNodeNeighbour(const RoomCoords& neighbourCoords, const std::wstring& tunnelFacilityID = L"");
+
+        //! Refresh a node from data, its new neighbours being added to the patch.
+        void rebuildNode(NodeData& nodeData);
 
         //! @}
 
@@ -101,9 +154,43 @@ namespace dungeon
         //! Reconstruct size of graph (and update it) to the current data.
         void reconstructFromData();
 
-        //! Updates the graph to the current data.
+        //! Updates the whole graph to the current data.
         void updateFromData();
 
+        //! Updates only the nodes affected by invalidated rooms.
+        void updateFromInvalidRooms();
+
+        //! Rebuild dirty nodes and patch the edges.
+        void rebuildDirtyNodes();
+
+        //! Mark the node to be rebuilt, if coords are valid.
+        void markDirty(const RoomCoords& coords);
+
+        //! Set the starting nodes from entrances.
+        void refreshStartingNodes();
+
+        //! @}
+
+        //! Moves needed to reach the closest target, by node index.
+        struct DistanceField
+        {
+            uint version = -1u;             //!< The graph version it was computed for.
+            std::vector<uint> distances;    //!< The distances, -1u if unreachable.
+        };
+
+        //------------------//
+        //! @name Distances
+        //! @{
+
+        //! Compute the field again if the graph changed since.
+        void refreshField(DistanceField& field, const std::function<bool(const NodeData&)>& isTarget);
+
+        //! The field to a specific room, computed if needed.
+        const DistanceField& roomField(uint targetIndex);
+
+        //! Compute the nodes that have a passage to each node, if the graph changed since.
+        void refreshReverseEdges();
+
         //! @}
 
     private:
@@ -116,5 +203,32 @@ namespace dungeon
 
         uint8 m_floorsCount = 0u;   //!< Number of nodes.
         uint8 m_floorRoomsCount = 0u;  //!< Number of nodes.
+
+        // Edges, neighbours of a node are contiguous, nodes pointing to their range
+        std::vector<ai::Neighbour> m_edges;         //!< All the neighbours, by node.
+        std::vector<ai::Neighbour> m_edgesBuffer;   //!< The storage reused when edges are rebuilt.
+        std::unordered_map<std::wstring, NeighbourData> m_neighboursData;  //!< Interned extra info, by tunnel facility ID.
+
+        // Incremental updates, node indices being floor-major
+        std::vector<RoomCoords> m_invalidRooms;         //!< The rooms changed since last update.
+        bool m_invalidAll = false;                      //!< Whether all rooms changed since last update.
+        std::vector<bool> m_dirtyNodes;                 //!< Whether a node is to be rebuilt, by node index.
+        std::vector<uint> m_dirtyIndices;               //!< The nodes to be rebuilt.
+        std::vector<std::vector<uint>> m_tunnelSources; //!< The nodes with a tunnel to a node, by node index.
+        std::vector<ai::Neighbour> m_patchEdges;        //!< The new neighbours of rebuilt nodes.
+        std::vector<uint> m_patchOffsets;               //!< Where rebuilt nodes neighbours start in the patch.
+        uint m_rebuiltIndex = 0u;                       //!< The index of the node being rebuilt.
+
+        // Distances, computed from the targets by following passages backwards
+        uint m_version = 0u;                                    //!< Incremented on each change.
+        DistanceField m_entrancesField;                         //!< To the closest entrance.
+        DistanceField m_treasuresField;                         //!< To the closest treasure.
+        std::unordered_map<uint, DistanceField> m_roomsFields;  //!< To specific rooms, by node index.
+        std::mutex m_roomsFieldsMutex;                          //!< Protects the rooms fields, computed on demand.
+        uint m_roomsFieldsVersion = -1u;                        //!< The graph version of the rooms fields.
+        std::vector<uint> m_reverseOffsets;                     //!< Where sources of a node start, by node index.
+        std::vector<uint> m_reverseEdges;                       //!< Nodes having a passage to a node, contiguous by node.
+        uint m_reverseVersion = -1u;                            //!< The graph version of the reverse edges.
+        std::vector<uint> m_fieldQueue;                         //!< The breadth-first search queue.
     };
 }
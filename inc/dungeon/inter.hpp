@@ -139,6 +139,11 @@ namespace dungeon
         //! Get the room scale factors, relative to original image size.
         inline const sf::Vector2f& roomScale() const { return m_roomScale; }
 
+        //! Set whether moving elements decide where to go on the job system, before they are updated.
+        //! Otherwise, each element decides during its own update, as the game does.
+        //! The results depend on whether decisions are taken beforehand, not on the workers count.
+        inline void setParallelAI(bool parallelAI) { m_parallelAI = parallelAI; }
+
         //! @}
 
         //------------------//
@@ -375,6 +380,9 @@ namespace dungeon
         void updateRoutine(const sf::Time& dt) final;
         void onSizeChanges() final;
 
+        //! Let all moving elements decide concurrently, the ones sharing a VM on the same thread.
+        void decideMovingElements(const sf::Time& dt);
+
         //! @}
 
         //---------------//
@@ -515,6 +523,11 @@ namespace dungeon
         std::vector<MovingRoom> m_movingRooms;  //!< The rooms to animate.
         Effecter m_effecter;                    //!< Play some routine animations.
 
+        // Parallel AI
+        bool m_parallelAI = false;                                      //!< Whether the decisions are taken beforehand.
+        std::vector<std::vector<MovingElement*>> m_aiJobs;              //!< The elements deciding, grouped by VM.
+        std::unordered_map<const scene::LuaVM*, uint> m_aiJobsIndices;  //!< The job of each VM, for the current update.
+
         // Prediction
         std::wstring m_predictionID;                //!< The current ID of the element overlay.
         scene::AnimatedSprite m_predictionSprite;   //!< The current sprite shown.
@@ -2,6 +2,7 @@
 
 #include "context/event.hpp"
 #include "dungeon/elements/dynamic.hpp"
+#include "tools/handlepool.hpp"
 
 namespace dungeon
 {
@@ -14,6 +15,14 @@ namespace dungeon
 
     class DynamicsManager final : public context::EventReceiver
     {
+    public:
+
+        //! The saved states of all dynamics, copied so that they can be written later.
+        struct Snapshot
+        {
+            std::vector<ElementData> dynamics;  //!< The data of all dynamics not being removed.
+        };
+
     public:
 
         //! Constructor.
@@ -38,8 +47,17 @@ namespace dungeon
         //! Load from an XML file.
         void load(const pugi::xml_node& node);
 
+        //! Load from a binary stream.
+        void loadBinary(BinaryReader& reader);
+
+        //! Copy the saved states.
+        Snapshot snapshot() const;
+
         //! Save to an XML file.
-        void save(pugi::xml_node node);
+        static void save(const Snapshot& snapshot, pugi::xml_node node);
+
+        //! Save to a binary stream.
+        static void saveBinary(const Snapshot& snapshot, BinaryWriter& writer);
 
         //! @}
 
@@ -108,6 +126,6 @@ namespace dungeon
         Inter* m_inter = nullptr;   //!< The dungeon inter, to get cellsize and position.
 
         // Dynamics
-        std::vector<DynamicInfo> m_dynamicsInfo;    //!< All the dynamics currently in the dungeon.
+        HandlePool<DynamicInfo> m_dynamicsInfo; //!< All the dynamics currently in the dungeon, never moved.
     };
 }
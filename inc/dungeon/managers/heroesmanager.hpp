@@ -4,6 +4,7 @@
 #include "dungeon/graph.hpp"
 #include "dungeon/elements/hero.hpp"
 #include "context/event.hpp"
+#include "tools/handlepool.hpp"
 
 namespace dungeon
 {
@@ -42,6 +43,25 @@ namespace dungeon
             float damageFeedbackTime = 0.f;             //!< How long to wait for the damage state.
         };
 
+        //! The saved states of a hero.
+        struct HeroSnapshot
+        {
+            ElementData data;       //!< All its data.
+            HeroStatus status;      //!< Hero status.
+            float spawnDelay;       //!< Seconds to wait before effective spawning.
+            float hp;               //!< How many HP the hero has left.
+            bool spawnHard;         //!< Is the spawn point already defined?
+        };
+
+    public:
+
+        //! The saved states of all heroes, copied so that they can be written later.
+        struct Snapshot
+        {
+            float nextGroupDelay = -1.f;        //!< Delay before next group.
+            std::vector<HeroSnapshot> heroes;   //!< All heroes not being removed.
+        };
+
     public:
 
         //! Constructor.
@@ -66,8 +86,17 @@ namespace dungeon
         //! Load from an XML file.
         void load(const pugi::xml_node& node);
 
+        //! Load from a binary stream.
+        void loadBinary(BinaryReader& reader);
+
+        //! Copy the saved states.
+        Snapshot snapshot() const;
+
         //! Save to an XML file.
-        void save(pugi::xml_node node);
+        static void save(const Snapshot& snapshot, pugi::xml_node node);
+
+        //! Save to a binary stream.
+        static void saveBinary(const Snapshot& snapshot, BinaryWriter& writer);
 
         //! @}
 
@@ -148,9 +177,6 @@ namespace dungeon
         //! @name ICU
         //! @{
 
-        //! Refresh all element data reference for heroes.
-        void refreshHeroesData();
-
         //! Refresh all heroes information about the current graph.
         void refreshHeroesFromGraph();
 
@@ -164,7 +190,7 @@ namespace dungeon
         Inter* m_inter = nullptr;   //!< The dungeon inter, to get cellsize and position.
 
         // Heroes
-        std::vector<HeroInfo> m_heroesInfo; //!< All the heroes currently in the dungeon.
+        HandlePool<HeroInfo> m_heroesInfo;  //!< All the heroes currently in the dungeon, never moved.
         float m_nextGroupDelay = -1.f;
     };
 }
@@ -4,6 +4,7 @@
 #include "dungeon/graph.hpp"
 #include "dungeon/elements/monster.hpp"
 #include "context/event.hpp"
+#include "tools/handlepool.hpp"
 
 namespace dungeon
 {
@@ -16,6 +17,22 @@ namespace dungeon
 
     class MonstersManager final : public context::EventReceiver
     {
+    public:
+
+        //! The saved states of a monster.
+        struct MonsterSnapshot
+        {
+            ElementData data;   //!< All its data.
+            float hp;           //!< How many HP the monster has left.
+            bool running;       //!< Whether the monster was already spawned.
+        };
+
+        //! The saved states of all monsters, copied so that they can be written later.
+        struct Snapshot
+        {
+            std::vector<MonsterSnapshot> monsters;  //!< All monsters not being removed.
+        };
+
     public:
 
         //! Constructor.
@@ -40,8 +57,17 @@ namespace dungeon
         //! Load from an XML file.
         void load(const pugi::xml_node& node);
 
+        //! Load from a binary stream.
+        void loadBinary(BinaryReader& reader);
+
+        //! Copy the saved states.
+        Snapshot snapshot() const;
+
         //! Save to an XML file.
-        void save(pugi::xml_node node);
+        static void save(const Snapshot& snapshot, pugi::xml_node node);
+
+        //! Save to a binary stream.
+        static void saveBinary(const Snapshot& snapshot, BinaryWriter& writer);
 
         //! @}
 
@@ -92,9 +118,6 @@ namespace dungeon
         //! @name ICU
         //! @{
 
-        //! Refresh all element data references.
-        void refreshMonstersData();
-
         //! Refresh all monsters information about the current graph.
         void refreshMonstersFromGraph();
 
@@ -134,6 +157,6 @@ namespace dungeon
         Inter* m_inter = nullptr;   //!< The dungeon inter, to get cellsize and position.
 
         // Monsters
-        std::vector<MonsterInfo> m_monstersInfo;    //!< All the heroes currently in the dungeon.
+        HandlePool<MonsterInfo> m_monstersInfo; //!< All the monsters currently in the dungeon, never moved.
     };
 }
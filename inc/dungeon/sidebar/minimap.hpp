@@ -68,6 +68,7 @@ namespace dungeon
         //! @{
 
         void drawInternal(sf::RenderTarget& target, sf::RenderStates states) const final;
+        bool drawsInternalDirectly() const final { return true; }
         void onTransformChanges() final;
         void onSizeChanges() final;
         void refreshNUI(const config::NUIGuides& cNUI) final;
@@ -43,6 +43,7 @@ namespace nui
         void onFocusChanged() final;
         void update(const sf::Time& dt, const float factor) final;
         void drawInternal(sf::RenderTarget& target, sf::RenderStates states) const final;
+        bool drawsInternalDirectly() const final { return focused(); }
 
         //! @}
 
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <vector>
+
+namespace resources
+{
+    //! Packs rectangles into pages, for texture atlases.
+    /*!
+     *  Skyline bottom-left: each page keeps the outline of what is placed,
+     *  and each rectangle goes where it ends the closest to the top of the page, then the leftmost.
+     *  Rectangles are placed from the tallest to the shortest, first in the earlier pages.
+     *  The placements only depend on the sizes and their order, so packing is deterministic.
+     *
+     *  Each rectangle is surrounded by padding, which is within the page too.
+     */
+
+    class AtlasPacker final
+    {
+    public:
+
+        //! Where a rectangle is placed.
+        struct Placement
+        {
+            int page = -1;      //!< The index of the page, or -1 if the rectangle is too big for a page.
+            sf::IntRect rect;   //!< The rectangle within the page, without the padding.
+        };
+
+    public:
+
+        //! Constructor, with the size of the pages and the padding around each rectangle.
+        AtlasPacker(const sf::Vector2u& pageSize, uint padding);
+
+        //! Default destructor.
+        ~AtlasPacker() = default;
+
+        //-----------------//
+        //! @name Packing
+        //! @{
+
+        //! Pack rectangles of these sizes, replacing the previous packing.
+        //! @return The placements, in the same order as the sizes.
+        std::vector<Placement> pack(const std::vector<sf::Vector2u>& sizes);
+
+        //! How many pages the last packing used.
+        inline uint pagesCount() const { return m_pagesHeights.size(); }
+
+        //! The height used in each page by the last packing, their width being the page width.
+        inline const std::vector<uint>& pagesHeights() const { return m_pagesHeights; }
+
+        //! The ratio of the used pages area covered by the rectangles of the last packing.
+        float occupancy() const;
+
+        //! @}
+
+    protected:
+
+        //! A horizontal part of the outline of a page.
+        struct Segment
+        {
+            uint x;
+            uint y;
+            uint width;
+        };
+
+        //! Find the position where the rectangle ends the closest to the top, then the leftmost.
+        //! @return False if it does not fit.
+        bool findPosition(const std::vector<Segment>& skyline, const sf::Vector2u& size, sf::Vector2u& position) const;
+
+        //! Raise the skyline for the rectangle placed.
+        void place(std::vector<Segment>& skyline, const sf::Vector2u& size, const sf::Vector2u& position) const;
+
+    private:
+
+        sf::Vector2u m_pageSize;    //!< The size of each page.
+        uint m_padding = 0u;        //!< The space kept around each rectangle.
+
+        // Last packing
+        std::vector<uint> m_pagesHeights;   //!< The height used in each page.
+        uint64 m_packedArea = 0u;           //!< The area covered by the rectangles placed.
+    };
+}
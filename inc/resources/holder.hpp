@@ -28,6 +28,9 @@ namespace resources
         template <typename Parameter>
         Resource& load(const std::string& filename, const Parameter& parameter);
 
+        //! Store a resource already loaded from filename, elsewhere.
+        Resource& store(const std::string& filename, std::unique_ptr<Resource> resource);
+
         //! Remove a resource from memory.
         void free(const std::string& id);
 
@@ -94,7 +97,8 @@ namespace sf
 
 namespace resources
 {
-    using TextureHolder =       Holder<sf::Texture>;
+    class TextureHolder;
+
     using ShaderHolder =        Holder<sf::Shader>;
     using FontHolder =          Holder<sf::Font>;
     using SoundBufferHolder =   Holder<sf::SoundBuffer>;
@@ -33,6 +33,12 @@ namespace resources
         return insertResource(getID(filename), std::move(resource));
     }
 
+    template <typename Resource>
+    inline Resource& Holder<Resource>::store(const std::string& filename, std::unique_ptr<Resource> resource)
+    {
+        return insertResource(getID(filename), std::move(resource));
+    }
+
     template <typename Resource>
     inline void Holder<Resource>::free(const std::string& id)
     {
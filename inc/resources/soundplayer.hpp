@@ -59,6 +59,9 @@ namespace resources
         //! Set the volume to play new sounds.
         void setVolume(float volume);
 
+        //! Whether new sounds are ignored, as when running without audio.
+        inline void setMuted(bool muted) { m_muted = muted; }
+
         //! Clean list of sounds.
         void removeStoppedSounds();
 
@@ -81,6 +84,7 @@ namespace resources
         SoundBufferHolder m_soundBuffers;                   //!< Sound player.
         std::list<std::unique_ptr<sf::Sound>> m_sounds;     //!< Sound list.
         float m_volume = 100.f;                             //!< Current volume for new sounds.
+        bool m_muted = false;                               //!< Whether new sounds are ignored.
 
 
         const float m_listenerZ = 300.f;        //!< Z-depth for listener.
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "resources/holder.hpp"
+#include "tools/int.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <vector>
+
+// Forward declarations
+
+namespace sf
+{
+    class Image;
+}
+
+namespace resources
+{
+    //! Holder for textures, able to pack small ones into atlas pages.
+    /*!
+     *  A packed texture is a region of a shared page: drawing many of them
+     *  keeps the same texture bound, so that they are batched together.
+     *  Use region() to get it, get() still returns a standalone texture,
+     *  loaded from its file the first time it is asked for.
+     *
+     *  The layout and the pages of each folder are kept in a directory,
+     *  reused as long as the files packed are not modified.
+     */
+
+    class TextureHolder final : public Holder<sf::Texture>
+    {
+        using baseClass = Holder<sf::Texture>;
+
+    public:
+
+        //! Where to find a texture.
+        struct Region
+        {
+            const sf::Texture* texture = nullptr;   //!< The page or the standalone texture.
+            sf::IntRect rect;                       //!< The part of the texture to draw.
+        };
+
+    public:
+
+        //! Default constructor.
+        TextureHolder() = default;
+
+        //! Default destructor.
+        ~TextureHolder() = default;
+
+        //----------------//
+        //! @name Storage
+        //! @{
+
+        //! Remove a texture from memory.
+        void free(const std::string& id);
+
+        //! Remove all textures from memory with id starting with specified prefix, and their pages.
+        void freeMatchingPrefix(const std::string& prefix);
+
+        //! @}
+
+        //---------------//
+        //! @name Access
+        //! @{
+
+        //! Returns true if the texture exists, standalone or packed.
+        bool stored(const std::string& id) const;
+
+        //! Returns true if the texture exists, standalone or packed.
+        inline bool fileStored(const std::string& filename) const { return stored(getID(filename)); }
+
+        //! Get the standalone texture from its ID, loading it if it was only packed.
+        //! That second copy is loaded from disk and kept, so prefer region() for packed textures.
+        sf::Texture& get(const std::string& id);
+
+        //! Get the texture region to draw from its ID, within its page if packed.
+        Region region(const std::string& id);
+
+        //! @}
+
+        //-------------------//
+        //! @name Atlases
+        //! @{
+
+        //! Set the directory where atlases are saved, empty to disable the disk cache.
+        void setAtlasDirectory(const std::string& directory);
+
+        //! Load the atlas of the folder from the disk cache, if made of these files unmodified.
+        //! Files too big to be packed are not stored.
+        bool loadAtlas(const std::string& folder, const std::vector<std::string>& filenames);
+
+        //! Pack the small images into pages, and save them in the disk cache.
+        //! Images too big to be packed are not stored, nor are the null ones.
+        void packAtlas(const std::string& folder, const std::vector<std::string>& filenames,
+                       const std::vector<std::unique_ptr<sf::Image>>& images);
+
+        //! How many pages are in memory.
+        uint pagesCount() const;
+
+        //! @}
+
+    protected:
+
+        //-------------------//
+        //! @name Atlases
+        //! @{
+
+        //! The value identifying the files packed and how they are.
+        uint64 atlasSignature(const std::vector<std::string>& filenames) const;
+
+        //! The disk cache file, for the folder and this extension.
+        std::string atlasFile(const std::string& folder, const std::string& suffix) const;
+
+        //! @}
+
+    private:
+
+        //! A texture packed.
+        struct PackedTexture
+        {
+            const sf::Texture* page = nullptr;  //!< The page containing it.
+            sf::IntRect rect;                   //!< Where it is within the page.
+            std::string filename;               //!< Its file, to load it standalone if needed.
+        };
+
+        std::map<std::string, PackedTexture> m_packed;  //!< All textures packed, by ID.
+        std::map<std::string, std::vector<std::unique_ptr<sf::Texture>>> m_pages;   //!< The pages, by folder.
+
+        std::string m_atlasDirectory;   //!< Where the atlases are kept between runs.
+    };
+}
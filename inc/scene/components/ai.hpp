@@ -1,14 +1,141 @@
 #pragma once
 
 #include "scene/components/component.hpp"
+#include "tools/int.hpp"
 
+#include <SFML/System/NonCopyable.hpp>
 #include <SFML/Window/Event.hpp>
 
 #include <selene/selene.hpp>
 
+#include <unordered_map>
+#include <vector>
+#include <functional>
+#include <string>
+
 namespace scene
 {
+    //! A Lua virtual machine, possibly shared by multiple AI components.
+    /*!
+     *  The script is compiled once, then run for each AI in its own environment table,
+     *  so that the state of an instance (locals and globals of the script) is isolated.
+     *  The C++ API is registered once in the global table, which environments inherit from.
+     */
+
+    class LuaVM final : private sf::NonCopyable
+    {
+        friend class AI;
+        friend class LuaScope;
+
+    public:
+
+        //! Constructor.
+        LuaVM();
+
+        //! Destructor.
+        ~LuaVM();
+
+        //------------------//
+        //! @name Lua state
+        //! @{
+
+        //! Access the lua state, to register the C++ API.
+        inline sel::State& state() { return m_lua; }
+
+        //! The entity which AI is currently accessed within this VM.
+        inline Entity* active() const { return m_active; }
+
+        //! The memory currently used by the VM, in bytes.
+        size_t memoryUsage() const;
+
+        //! How many AIs currently run within the VM.
+        inline uint instancesCount() const { return m_instancesCount; }
+
+        //! Whether some scope is currently open on the VM.
+        inline bool inUse() const { return m_scopesCount != 0u; }
+
+        //! @}
+
+    protected:
+
+        //------------------//
+        //! @name Instances
+        //! @{
+
+        //! Load the compiled script file, only the first time or if it changed.
+        bool compile(const std::string& file);
+
+        //! Run the compiled script within a new environment, the entity being active meanwhile.
+        //! @return The reference of the environment, or LUA_NOREF on error.
+        int createInstance(Entity* entity);
+
+        //! Release the environment of an instance.
+        void destroyInstance(int instanceRef);
+
+        //! Set the active entity and use its environment as global table.
+        void activate(Entity* entity, int instanceRef);
+
+        //! @}
+
+    private:
+
+        lua_State* m_L = nullptr;       //!< The raw lua state.
+        sel::State m_lua;               //!< The lua state wrapper.
+        int m_globalsRef = LUA_NOREF;   //!< The original global table, holding the C++ API.
+        int m_chunkRef = LUA_NOREF;     //!< The compiled script, a function taking the environment.
+        uint64 m_chunkHash = 0u;        //!< The hash of the script source compiled.
+        uint m_instancesCount = 0u;     //!< How many environments are alive.
+        uint m_scopesCount = 0u;        //!< How many scopes are open.
+
+        // Activation
+        Entity* m_active = nullptr;     //!< The entity which AI is currently active.
+        int m_activeRef = LUA_NOREF;    //!< The environment currently used as global table.
+    };
+
+    //! Gives access to the environment of an AI during its lifetime.
+    /*!
+     *  Lua calls and global variables accessed through it are the ones of the AI.
+     *  Scopes can be nested, the previously active AI being restored on destruction.
+     */
+
+    class LuaScope final
+    {
+    public:
+
+        //! Constructor, activates the instance.
+        LuaScope(LuaVM& vm, Entity* entity, int instanceRef);
+
+        //! Move constructor.
+        LuaScope(LuaScope&& other);
+
+        //! Destructor, restores the previously active instance.
+        ~LuaScope();
+
+        //! Access a global variable of the instance.
+        inline sel::Selector operator[](const char* name) { return m_vm->m_lua[name]; }
+
+        //! Execute some lua code within the environment of the instance.
+        inline bool operator()(const char* code) { return m_vm->m_lua(code); }
+
+        //! The raw lua state, for calls passing too much data to go through the wrapper.
+        //! Its global table is the environment of the instance.
+        inline lua_State* raw() { return m_vm->m_L; }
+
+    private:
+
+        LuaVM* m_vm = nullptr;              //!< The VM.
+        Entity* m_previousActive = nullptr; //!< The entity that was previously active.
+        int m_previousRef = LUA_NOREF;      //!< The environment that was previously active.
+    };
+
     //! Allows to execute a LUA script.
+    /*!
+     *  By default, all AIs running the same script share one VM,
+     *  and the C++ API is registered only when the VM is created.
+     *  The VM is released with the last AI running it.
+     *  A script can also be run by several VMs, AIs being spread over them,
+     *  so that AIs on different VMs can be run from different threads.
+     */
 
     class AI final : public Component
     {
@@ -19,8 +146,8 @@ namespace scene
         //! Constructor.
         AI(Entity& entity);
 
-        //! Default destructor.
-        ~AI() = default;
+        //! Destructor.
+        ~AI();
 
         static std::string id() noexcept { return "AI"; }
 
@@ -28,14 +155,43 @@ namespace scene
         //! @name Lua state
         //! @{
 
-        //! Access the lua state.
-        sel::State& luaState() { return m_lua; }
+        //! Load the script file, in the VM shared by all AIs running it (if shared VMs are enabled).
+        //! The onNewVM callback is called first whenever the VM is a new one, to register the C++ API.
+        bool load(const std::string& file, const std::function<void(LuaVM&)>& onNewVM);
+
+        //! Activates the AI environment, to be used for any lua access.
+        LuaScope lua();
+
+        //! The VM running the AI, nullptr if no script loaded.
+        inline LuaVM* vm() { return m_vm; }
+
+        //! Set whether AIs running the same script share one VM or each one has its own.
+        //! Only affects scripts loaded afterwards.
+        static inline void setSharedVMs(bool sharedVMs) { s_sharedVMs = sharedVMs; }
+
+        //! Set how many shared VMs run each script, a new AI going to the least used one.
+        //! Only affects scripts loaded afterwards.
+        static inline void setVMsPerScript(uint vmsPerScript) { s_vmsPerScript = vmsPerScript; }
 
         //! @}
 
+    protected:
+
+        //! Release the current instance if any.
+        void unload();
+
+        //! Release the shared VMs of the script no more running any AI.
+        static void releaseUnusedVMs(const std::string& file);
+
     private:
 
-        sel::State m_lua;   //!< The lua state.
+        LuaVM* m_vm = nullptr;              //!< The VM used, if a script is loaded.
+        std::unique_ptr<LuaVM> m_ownVM;     //!< The VM, if not shared.
+        int m_instanceRef = LUA_NOREF;      //!< The environment of this AI in the VM.
+        std::string m_file;                 //!< The script loaded in a shared VM, if any.
+
+        static bool s_sharedVMs;                                                            //!< Are VMs shared between AIs?
+        static uint s_vmsPerScript;                                                         //!< How many shared VMs run each script.
+        static std::unordered_map<std::string, std::vector<std::unique_ptr<LuaVM>>> s_vms;  //!< All shared VMs, by script file.
     };
 }
-
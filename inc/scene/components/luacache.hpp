@@ -0,0 +1,103 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <selene/selene.hpp>
+
+#include <unordered_map>
+#include <chrono>
+#include <string>
+
+namespace scene
+{
+    //! Process-wide cache of compiled lua scripts.
+    /*!
+     *  A script is compiled only when first used or when its content changed,
+     *  VMs then load its bytecode directly.
+     *  The file is read again at most once per second, to see changes.
+     *  If a directory is set, the bytecode is kept there between runs too.
+     *
+     *  The script is compiled as the body of a function taking its environment,
+     *  see LuaVM::createInstance().
+     */
+
+    class LuaCache final : private sf::NonCopyable
+    {
+    public:
+
+        //! A compiled script.
+        struct Chunk
+        {
+            std::string bytecode;   //!< The dumped function.
+            uint64 hash = 0u;       //!< The hash of the source compiled.
+            std::chrono::steady_clock::time_point checkTime;    //!< When the file was last read.
+        };
+
+    public:
+
+        //! Constructor.
+        LuaCache();
+
+        //! Destructor.
+        ~LuaCache();
+
+        //----------------//
+        //! @name Chunks
+        //! @{
+
+        //! Get the compiled script, compiling it if not done yet or if the file content changed.
+        //! @return nullptr if the file cannot be read or has a syntax error.
+        const Chunk* chunk(const std::string& file);
+
+        //! Forget all compiled scripts kept in memory.
+        void clear();
+
+        //! @}
+
+        //------------------//
+        //! @name Disk cache
+        //! @{
+
+        //! Set the directory where bytecode is saved, empty to disable the disk cache.
+        void setDirectory(const std::string& directory);
+
+        //! @}
+
+    protected:
+
+        //------------------//
+        //! @name Internals
+        //! @{
+
+        //! Read the whole script file.
+        bool readSource(const std::string& file, std::string& source) const;
+
+        //! Compile the source of the script file.
+        bool compile(const std::string& file, const std::string& source, Chunk& chunk);
+
+        //! Check that the bytecode can be loaded by this version of Lua.
+        bool isLoadable(const std::string& file, const std::string& bytecode);
+
+        //! Get the chunk from the disk cache, if up to date.
+        bool loadFromDisk(const std::string& file, Chunk& chunk);
+
+        //! Save the chunk in the disk cache.
+        void saveToDisk(const std::string& file, const Chunk& chunk) const;
+
+        //! The file of the disk cache for the specified script.
+        std::string diskFile(const std::string& file) const;
+
+        //! @}
+
+    private:
+
+        lua_State* m_L = nullptr;                           //!< A state used to compile.
+        std::unordered_map<std::string, Chunk> m_chunks;    //!< The compiled scripts, by file.
+        std::string m_directory;                            //!< The disk cache directory, if any.
+    };
+
+    //! The static cache.
+    extern LuaCache s_luaCache;
+}
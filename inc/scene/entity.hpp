@@ -7,6 +7,7 @@
 #include <SFML/Graphics/Transformable.hpp>
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Window/Mouse.hpp>
 #include <SFML/Window/Event.hpp>
 
@@ -126,7 +127,8 @@ namespace scene
         sf::FloatRect localBounds() const;
 
         //! Returns the localBounds transformed to global coordinates.
-        sf::FloatRect globalBounds() const;
+        //! Cached until the transform or the size changes.
+        const sf::FloatRect& globalBounds() const;
 
         //! Set the shader applied to the whole entity.
         void setShader(const std::string& shaderID);
@@ -206,7 +208,7 @@ namespace scene
         PARAMG(sf::Vector2f, m_scale, scale)
 
         //! Whether the entity and its children will be drawn, and therefore detectable.
-        PARAMGS(bool, m_visible, visible, setVisible)
+        PARAMGSU(bool, m_visible, visible, setVisible, refreshHitTests)
 
         //! Whether the entity will be drawn (does not affect detectability nor children).
         PARAMGS(bool, m_transparent, transparent, setTransparent)
@@ -222,10 +224,26 @@ namespace scene
         //! Draws the entity parts and recursively calls children draw functions.
         void draw(sf::RenderTarget& target, sf::RenderStates states) const final;
 
+        //! Draws the entity and its children, skipping them if their culling bounds are out of the view rect.
+        void drawCulled(sf::RenderTarget& target, sf::RenderStates states, const sf::FloatRect& viewRect) const;
+
+        //! Get the global bounds of all that the entity and its descendants draw, cached.
+        /*!
+         *  An entity with a size is expected to draw itself and its children within it.
+         *  Without size, these are the bounds of its children, if it draws no part itself.
+         *  @return False if the bounds are unknown, when some entity without size draws something itself.
+         */
+        bool cullingBounds(sf::FloatRect& bounds) const;
+
         //! Extra hook for drawing something else than drawables.
         virtual void drawInternal(sf::RenderTarget& target, sf::RenderStates states) const {}
 
+        //! Whether drawInternal() draws directly to the target, and not only through its SpriteBatch.
+        //! If so, the batched sprites are drawn before, to keep the drawing order.
+        virtual bool drawsInternalDirectly() const { return false; }
+
         //! Really draw the entity parts with no global clipping.
+        //! Sprites are batched if the target has an active SpriteBatch.
         void drawParts(sf::RenderTarget& target, sf::RenderStates states) const;
 
         //! Really draw the entity parts with a global clipping.
@@ -238,6 +256,9 @@ namespace scene
         //! Called whenever the position/rotation/scale changed.
         virtual void onTransformChanges() {}
 
+        //! Called right away whenever the local position changed.
+        virtual void onLocalPositionChanges() {}
+
         //! Called whenever size changed.
         /*!
          *  Should be reimplemented in inherited classes to adapt
@@ -295,7 +316,12 @@ namespace scene
         std::list<Entity*>& children() noexcept { return m_children; }
 
         //! Get the first entity with the graph at given position.
-        Entity* firstOver(const sf::Vector2f& position);
+        //! If indexed, the branches which picking bounds do not contain the position are skipped.
+        Entity* firstOver(const sf::Vector2f& position, bool indexed = true);
+
+        //! Get the global bounds of the entity and all its descendants, cached.
+        //! Nothing out of these can be found by firstOver().
+        const sf::FloatRect& pickingBounds() const;
 
         //! @}
 
@@ -405,10 +431,11 @@ namespace scene
 
         //! An entity is just a bunch of drawable parts.
         struct Part {
-            sf::Drawable*   drawable;       //!< Drawable part.
-            sf::Shader*     shader;         //!< Shader to apply to the part.
-            bool            clipping;       //!< Whether the part needs clipping.
-            sf::FloatRect   clippingRect;   //!< If clipping, the clipping rectangle.
+            sf::Drawable*       drawable;       //!< Drawable part.
+            sf::Shader*         shader;         //!< Shader to apply to the part.
+            bool                clipping;       //!< Whether the part needs clipping.
+            sf::FloatRect       clippingRect;   //!< If clipping, the clipping rectangle.
+            const sf::Sprite*   sprite;         //!< The drawable if it is a sprite, which can be batched.
         };
 
         //! Add a drawable as a part.
@@ -445,6 +472,12 @@ namespace scene
         //! Refresh the origin of the entity.
         void refreshOrigin();
 
+        //! Mark the bounds as changed, along with the culling and picking bounds of the ancestors depending on them.
+        void refreshBoundsChanges();
+
+        //! Invalidate the cached hit tests, as the entity under the mouse might have changed.
+        void refreshHitTests();
+
         //! Refresh the position relative to the size of the parent.
         void refreshRelativePosition();
 
@@ -529,7 +562,7 @@ namespace scene
         PARAMG(Entity*, m_parent, parent)
 
         //! Whether the mouse events affects the entity.
-        PARAMGS(bool, m_detectable, detectable, setDetectable)
+        PARAMGSU(bool, m_detectable, detectable, setDetectable, refreshHitTests)
 
         //! Whether the entity is focusable, and can get events from keyboard/joystick.
         /*!
@@ -563,6 +596,15 @@ namespace scene
         bool m_markedForVisible = false;    //!< Whether the entity is marked for a delayed setVisible() call.
         bool m_visibleMark;                 //!< The target status to visible, if mark is on.
 
+        // Bounds
+        mutable sf::FloatRect m_globalBounds;           //!< The localBounds in global coordinates, if no changes.
+        mutable sf::FloatRect m_cullingBounds;          //!< The bounds of all that is drawn, if no changes.
+        mutable bool m_globalBoundsChanges = true;      //!< Whether the global bounds are to be recomputed.
+        mutable bool m_cullingBoundsChanges = true;     //!< Whether the culling bounds are to be recomputed.
+        mutable bool m_cullingBounded = false;          //!< Whether the culling bounds are known.
+        mutable sf::FloatRect m_pickingBounds;          //!< The bounds of all that can be picked, if no changes.
+        mutable bool m_pickingBoundsChanges = true;     //!< Whether the picking bounds are to be recomputed.
+
         // Constraints
         sf::FloatRect m_insideLocalRect = {0.f, 0.f, -1.f, -1.f};   //!< The entity will be kept between this limits if width/height is not negative.
 
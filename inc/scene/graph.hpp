@@ -24,8 +24,8 @@ namespace scene
         //! Constructor.
         Graph();
 
-        //! Default destructor.
-        ~Graph() = default;
+        //! Destructor.
+        ~Graph();
 
         //----------------//
         //! @name Routine
@@ -81,6 +81,24 @@ namespace scene
 
         //! @}
 
+        //------------------//
+        //! @name Hit tests
+        //! @{
+
+        //! The hit-test epoch, shared by all graphs.
+        /*!
+         *  It changes whenever the entity under the mouse might have changed:
+         *  transforms, sizes, visibility, detectability, clipping, children order,
+         *  attached or detached entities, layer views and graphs creation.
+         *  As long as it does not change, a hit test at the same mouse position gives the same entity.
+         */
+        static inline uint32 hitTestEpoch() { return s_hitTestEpoch; }
+
+        //! Change the hit-test epoch, so that cached hit tests are performed again.
+        static inline void invalidateHitTests() { ++s_hitTestEpoch; }
+
+        //! @}
+
     protected:
 
         //---------------//
@@ -165,6 +183,7 @@ namespace scene
         //! @{
 
         //! Find the front-most detectable entity below the mouse position.
+        //! The result is cached until the mouse position or the hit-test epoch changes.
         //! \param viewPos will be set to the position in the entity's layer's view.
         Entity* entityFromPosition(const sf::Vector2i& mousePos, sf::Vector2f& viewPos);
 
@@ -185,6 +204,13 @@ namespace scene
         // Mouse detection
         Entity* m_hoveredEntity = nullptr;  //!< The currently hovered entity.
 
+        // Hit tests
+        static uint32 s_hitTestEpoch;       //!< Changed whenever the entity under the mouse might have changed.
+        uint32 m_hitTestEpoch = 0u;         //!< The hit-test epoch of the cached hit test.
+        sf::Vector2i m_hitTestMousePos;     //!< The mouse position of the cached hit test.
+        sf::Vector2f m_hitTestViewPos;      //!< The position in the view of the cached hit test.
+        Entity* m_hitTestEntity = nullptr;  //!< The entity found by the cached hit test.
+
         // Global events
         std::list<Entity*> m_globalHandlers;    //!< All the registered entities to global events.
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "scene/entity.hpp"
+#include "scene/spritebatch.hpp"
 #include "scene/posteffects/posteffect.hpp"
 
 #include <SFML/Graphics/View.hpp>
@@ -133,6 +134,9 @@ namespace scene
         //! Even if not found, viewPos is set to the position within the layer view.
         Entity* entityFromPosition(const sf::Vector2i& mousePos, sf::Vector2f& viewPos);
 
+        //! Whether picking skips the branches out of position, or visits all entities.
+        inline void setPickingIndexed(bool pickingIndexed) { m_pickingIndexed = pickingIndexed; }
+
         //! Called whenever manipuability status changed.
         void refreshManipulability();
 
@@ -212,6 +216,9 @@ namespace scene
         // Viewports
         bool m_ownViewport = false; //!< Whether or not we use a provided viewport.
 
+        // Picking
+        bool m_pickingIndexed = true;   //!< Whether picking skips the branches out of position.
+
         //! Called whenever the size changes.
         Callback m_onSizeChangesCallback = nullptr;
 
@@ -219,6 +226,7 @@ namespace scene
         Callback m_onViewChangesCallback = nullptr;
 
         // Drawing
+        mutable SpriteBatch m_spriteBatch;      //!< Batches the sprites of the entities.
         mutable sf::RenderTexture m_tmpTarget;  //!< Temporary target to draw.
         sf::View m_basicView;                   //!< The view used to render.
         sf::View m_internView;                  //!< The view, but with a viewport relative to the layer size, not the screen.
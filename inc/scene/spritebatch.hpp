@@ -0,0 +1,114 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <functional>
+#include <vector>
+
+// Forward declarations
+
+namespace sf
+{
+    class RenderTarget;
+    class Sprite;
+    class Texture;
+}
+
+namespace scene
+{
+    //! Collects textured quads and draws them at once while the render states are the same.
+    /*!
+     *  Quads are transformed on the CPU, so that sprites with different transforms
+     *  share a draw call as long as they use the same texture (an atlas), shader and blend mode.
+     *  The pending quads are drawn, keeping the drawing order, whenever one of these changes.
+     *
+     *  Once begun for a target, the batch is the active one of this target.
+     *  Anything drawn directly to the target needs to flush the active batch before.
+     */
+
+    class SpriteBatch final : private sf::NonCopyable
+    {
+    public:
+
+        //! Where the flushed vertices go, instead of the target.
+        using Submit = std::function<void(const sf::Vertex* vertices, std::size_t verticesCount, const sf::RenderStates& states)>;
+
+    public:
+
+        //! Default constructor.
+        SpriteBatch() = default;
+
+        //! Default destructor.
+        ~SpriteBatch() = default;
+
+        //----------------//
+        //! @name Routine
+        //! @{
+
+        //! Start batching for the target, becoming its active batch.
+        void begin(sf::RenderTarget& target);
+
+        //! Flush and stop batching, the previously active batch being active again.
+        void end();
+
+        //! Add a sprite, drawn as target.draw(sprite, states) would.
+        void draw(const sf::Sprite& sprite, const sf::RenderStates& states);
+
+        //! Add a quad of the texture rect, drawn with the color and transform, then the states.
+        void draw(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Color& color,
+                  const sf::Transform& transform, const sf::RenderStates& states);
+
+        //! Draw the pending quads.
+        void flush();
+
+        //! The batch active for the target, or nullptr if none.
+        static SpriteBatch* active(const sf::RenderTarget& target);
+
+        //! Flush the batch active for the target, if any.
+        static void flushActive(const sf::RenderTarget& target);
+
+        //! @}
+
+        //-------------------//
+        //! @name Submission
+        //! @{
+
+        //! Send the flushed vertices to this function rather than drawing them, mostly for testing.
+        inline void setSubmit(Submit submit) { m_submit = std::move(submit); }
+
+        //! How many times the quads were flushed, i.e. draw calls.
+        inline uint flushesCount() const { return m_flushesCount; }
+
+        //! How many quads were added.
+        inline uint quadsCount() const { return m_quadsCount; }
+
+        //! Reset the counters.
+        inline void resetCounters() { m_flushesCount = 0u; m_quadsCount = 0u; }
+
+        //! @}
+
+    private:
+
+        // Target
+        sf::RenderTarget* m_target = nullptr;   //!< The target to draw to, if begun.
+        SpriteBatch* m_previous = nullptr;      //!< The batch active before this one was begun.
+        Submit m_submit = nullptr;              //!< Where flushed vertices go, if set.
+
+        // Pending quads
+        std::vector<sf::Vertex> m_vertices;     //!< The quads, as triangles.
+        sf::RenderStates m_states;              //!< The render states shared by the quads.
+
+        // Counters
+        uint m_flushesCount = 0u;   //!< How many times the quads were flushed.
+        uint m_quadsCount = 0u;     //!< How many quads were added.
+
+        static SpriteBatch* s_active;   //!< The last batch begun.
+    };
+}
@@ -75,6 +75,10 @@ namespace states
         dungeon::Inter m_dungeonInter;
         dungeon::Sidebar m_dungeonSidebar;
 
+        // Autosave
+        float m_autosaveTime = 0.f;             //!< Seconds since last autosave.
+        const float m_autosaveDelay = 120.f;    //!< Seconds between two autosaves.
+
         // Loading
         scene::Label m_loadingText;
         scene::RectangleShape m_loadingBackground;
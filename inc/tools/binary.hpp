@@ -0,0 +1,137 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <string>
+#include <vector>
+
+//! Writes little-endian binary data to a memory buffer.
+/*!
+ *  Data is organized in chunks: a 4-character tag, the size of the content,
+ *  then the content itself, so that a reader can skip the ones it does not know.
+ */
+
+class BinaryWriter final
+{
+public:
+
+    //! Default constructor.
+    BinaryWriter() = default;
+
+    //--------------//
+    //! @name Values
+    //! @{
+
+    void write(bool value);
+    void write(uint8 value);
+    void write(uint16 value);
+    void write(uint32 value);
+    void write(uint64 value);
+    void write(int32 value);
+    void write(int64 value);
+    void write(float value);
+    void write(double value);
+
+    //! Write the length, then the characters.
+    void write(const std::wstring& value);
+
+    //! Write raw bytes.
+    void writeBytes(const char* bytes, uint size);
+
+    //! @}
+
+    //--------------//
+    //! @name Chunks
+    //! @{
+
+    //! Start a chunk, returns the offset to pass to endChunk().
+    uint beginChunk(const char tag[4]);
+
+    //! Finish the chunk, writing its size.
+    void endChunk(uint offset);
+
+    //! @}
+
+    //! The data written so far.
+    inline const std::string& buffer() const { return m_buffer; }
+
+private:
+
+    std::string m_buffer;   //!< The data.
+};
+
+//! Reads little-endian binary data from a memory area.
+/*!
+ *  Reading past the end never crashes: it returns 0 and marks the reader as failed.
+ *  The data is not copied, so it can be used on a memory-mapped file.
+ */
+
+class BinaryReader final
+{
+public:
+
+    //! A sub-area of the data.
+    struct Chunk
+    {
+        std::string tag;        //!< The 4-character tag.
+        const char* data;       //!< Start of the content.
+        uint size;              //!< Size of the content.
+    };
+
+public:
+
+    //! Constructor.
+    BinaryReader(const char* data = nullptr, uint size = 0u) : m_data(data), m_size(size) {}
+
+    //! Constructor, from a chunk.
+    BinaryReader(const Chunk& chunk) : m_data(chunk.data), m_size(chunk.size) {}
+
+    //--------------//
+    //! @name Values
+    //! @{
+
+    bool readBool();
+    uint8 readUint8();
+    uint16 readUint16();
+    uint32 readUint32();
+    uint64 readUint64();
+    int32 readInt32();
+    int64 readInt64();
+    float readFloat();
+    double readDouble();
+    std::wstring readWString();
+
+    //! Check that the next bytes are the ones expected, and skip them.
+    bool expectBytes(const char* bytes, uint size);
+
+    //! @}
+
+    //--------------//
+    //! @name Chunks
+    //! @{
+
+    //! Read all chunks up to the end.
+    std::vector<Chunk> readChunks();
+
+    //! @}
+
+    //! Whether an error occured (reading past the end or invalid chunk).
+    inline bool failed() const { return m_failed; }
+
+    //! Whether all data has been read.
+    inline bool ended() const { return m_offset >= m_size; }
+
+protected:
+
+    //! Get the next bytes, nullptr if not enough data left.
+    const char* consume(uint size);
+
+private:
+
+    const char* m_data = nullptr;   //!< The data.
+    uint m_size = 0u;               //!< The data size.
+    uint m_offset = 0u;             //!< The current reading position.
+    bool m_failed = false;          //!< Whether an error occured.
+};
+
+#include "tools/binary.inl"
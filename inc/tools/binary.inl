@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstring>
+
+//------------------------//
+//----- BinaryWriter -----//
+
+inline void BinaryWriter::write(bool value)
+{
+    write(static_cast<uint8>(value? 1u : 0u));
+}
+
+inline void BinaryWriter::write(uint8 value)
+{
+    m_buffer.push_back(static_cast<char>(value));
+}
+
+inline void BinaryWriter::write(uint16 value)
+{
+    write(static_cast<uint8>(value));
+    write(static_cast<uint8>(value >> 8u));
+}
+
+inline void BinaryWriter::write(uint32 value)
+{
+    write(static_cast<uint16>(value));
+    write(static_cast<uint16>(value >> 16u));
+}
+
+inline void BinaryWriter::write(uint64 value)
+{
+    write(static_cast<uint32>(value));
+    write(static_cast<uint32>(value >> 32u));
+}
+
+inline void BinaryWriter::write(int32 value)
+{
+    write(static_cast<uint32>(value));
+}
+
+inline void BinaryWriter::write(int64 value)
+{
+    write(static_cast<uint64>(value));
+}
+
+inline void BinaryWriter::write(float value)
+{
+    uint32 bits;
+    std::memcpy(&bits, &value, sizeof(uint32));
+    write(bits);
+}
+
+inline void BinaryWriter::write(double value)
+{
+    uint64 bits;
+    std::memcpy(&bits, &value, sizeof(uint64));
+    write(bits);
+}
+
+inline void BinaryWriter::write(const std::wstring& value)
+{
+    // Characters are stored on 32 bits, whatever the platform wchar_t is
+    write(static_cast<uint32>(value.size()));
+    for (auto c : value)
+        write(static_cast<uint32>(c));
+}
+
+inline void BinaryWriter::writeBytes(const char* bytes, uint size)
+{
+    m_buffer.append(bytes, size);
+}
+
+//----- Chunks
+
+inline uint BinaryWriter::beginChunk(const char tag[4])
+{
+    writeBytes(tag, 4u);
+    uint offset = m_buffer.size();
+    write(0u);
+    return offset;
+}
+
+inline void BinaryWriter::endChunk(uint offset)
+{
+    uint32 size = m_buffer.size() - offset - sizeof(uint32);
+    for (uint i = 0u; i < sizeof(uint32); ++i)
+        m_buffer[offset + i] = static_cast<char>(size >> (8u * i));
+}
+
+//------------------------//
+//----- BinaryReader -----//
+
+inline bool BinaryReader::readBool()
+{
+    return readUint8() != 0u;
+}
+
+inline uint8 BinaryReader::readUint8()
+{
+    auto bytes = consume(1u);
+    if (bytes == nullptr) return 0u;
+    return static_cast<uint8>(bytes[0u]);
+}
+
+inline uint16 BinaryReader::readUint16()
+{
+    uint16 low = readUint8();
+    uint16 high = readUint8();
+    return low | (high << 8u);
+}
+
+inline uint32 BinaryReader::readUint32()
+{
+    uint32 low = readUint16();
+    uint32 high = readUint16();
+    return low | (high << 16u);
+}
+
+inline uint64 BinaryReader::readUint64()
+{
+    uint64 low = readUint32();
+    uint64 high = readUint32();
+    return low | (high << 32u);
+}
+
+inline int32 BinaryReader::readInt32()
+{
+    return static_cast<int32>(readUint32());
+}
+
+inline int64 BinaryReader::readInt64()
+{
+    return static_cast<int64>(readUint64());
+}
+
+inline float BinaryReader::readFloat()
+{
+    float value;
+    uint32 bits = readUint32();
+    std::memcpy(&value, &bits, sizeof(uint32));
+    return value;
+}
+
+inline double BinaryReader::readDouble()
+{
+    double value;
+    uint64 bits = readUint64();
+    std::memcpy(&value, &bits, sizeof(uint64));
+    return value;
+}
+
+inline std::wstring BinaryReader::readWString()
+{
+    std::wstring value;
+    uint32 length = readUint32();
+    if (m_failed || length > (m_size - m_offset) / 4u) {
+        m_failed = true;
+        return value;
+    }
+
+    value.resize(length);
+    for (auto& c : value)
+        c = static_cast<wchar_t>(readUint32());
+    return value;
+}
+
+inline bool BinaryReader::expectBytes(const char* bytes, uint size)
+{
+    auto read = consume(size);
+    if (read == nullptr || std::memcmp(read, bytes, size) != 0) {
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+//----- Chunks
+
+inline std::vector<BinaryReader::Chunk> BinaryReader::readChunks()
+{
+    std::vector<Chunk> chunks;
+
+    while (!ended() && !m_failed) {
+        Chunk chunk;
+        auto tag = consume(4u);
+        chunk.size = readUint32();
+        chunk.data = consume(chunk.size);
+        if (tag == nullptr || chunk.data == nullptr) break;
+
+        chunk.tag.assign(tag, 4u);
+        chunks.emplace_back(std::move(chunk));
+    }
+
+    return chunks;
+}
+
+//----- Internals
+
+inline const char* BinaryReader::consume(uint size)
+{
+    if (m_failed || size > m_size - m_offset) {
+        m_failed = true;
+        return nullptr;
+    }
+
+    auto bytes = m_data + m_offset;
+    m_offset += size;
+    return bytes;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tools/int.hpp"
+
 #include <string>
 #include <vector>
 
@@ -21,6 +23,14 @@ bool createDirectory(const std::wstring& directory);
 bool fileExists(const std::string& filename);
 bool fileExists(const std::wstring& filename);
 
+//! Returns the last modification time of the file, 0 if it does not exist.
+//! The unit is platform-specific, only useful to compare with another one.
+uint64 fileModificationTime(const std::string& filename);
+
+//! Move the file, replacing the destination if it exists.
+//! Returns true on success. On the same file system, readers see either the old or the new file.
+bool fileReplace(const std::string& source, const std::string& destination);
+
 //! List all files and directories.
 //! If recursive, be sure that there is no loop with symlink.
 std::vector<FileInfo> listFiles(const std::string& directory, bool recursive = false);
@@ -3,6 +3,7 @@
 #include "tools/string.hpp" // toString
 
 #include <fstream>
+#include <cstdio>
 
 #if defined(__WIN32__)
     // Windows
@@ -42,6 +43,36 @@ inline bool fileExists(const std::wstring& filename)
     return fileExists(toString(filename));
 }
 
+inline uint64 fileModificationTime(const std::string& filename)
+{
+#if defined(__WIN32__)
+    // Windows
+    WIN32_FILE_ATTRIBUTE_DATA fileData;
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &fileData))
+        return 0u;
+    return (static_cast<uint64>(fileData.ftLastWriteTime.dwHighDateTime) << 32u) | fileData.ftLastWriteTime.dwLowDateTime;
+
+#else
+    // POSIX
+    struct stat st;
+    if (stat(filename.c_str(), &st) == -1)
+        return 0u;
+    return static_cast<uint64>(st.st_mtime);
+#endif
+}
+
+inline bool fileReplace(const std::string& source, const std::string& destination)
+{
+#if defined(__WIN32__)
+    // Windows
+    return MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+
+#else
+    // POSIX
+    return std::rename(source.c_str(), destination.c_str()) == 0;
+#endif
+}
+
 inline std::vector<FileInfo> listFiles(const std::string& directory, bool recursive)
 {
     std::vector<FileInfo> filesInfo;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "tools/int.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+//! A pool of objects that never move, referenced by generational handles.
+/*!
+ *  Objects are stored within fixed-size chunks, so that adding or removing one
+ *  never invalidates pointers to the others. A handle is the index of the slot
+ *  in its low bits, and a generation in the others, incremented each time the slot
+ *  is freed, so that a stale handle is detected instead of aliasing a new object.
+ *  Iteration is in slot order, freed slots being reused first.
+ */
+
+template <typename T, uint ChunkSize = 64u>
+class HandlePool
+{
+public:
+
+    //! The reference to an object of the pool.
+    using Handle = uint32;
+
+    //! A handle never returned.
+    static constexpr Handle invalidHandle = -1u;
+
+    //! Iterates over the objects alive, in slot order.
+    template <class Pool, class Value>
+    class Iterator
+    {
+    public:
+
+        Iterator(Pool* pool, uint32 slotIndex);
+
+        Value& operator*() const;
+        Value* operator->() const;
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const { return m_slotIndex != other.m_slotIndex; }
+        bool operator==(const Iterator& other) const { return m_slotIndex == other.m_slotIndex; }
+
+        //! The handle of the object pointed.
+        Handle handle() const;
+
+    private:
+
+        Pool* m_pool;           //!< The pool iterated.
+        uint32 m_slotIndex;     //!< The current slot.
+    };
+
+    using iterator = Iterator<HandlePool, T>;
+    using const_iterator = Iterator<const HandlePool, const T>;
+
+public:
+
+    //! Constructor.
+    HandlePool() = default;
+
+    //! Destructor, destroys all objects alive.
+    ~HandlePool();
+
+    //! Not copyable, as objects are referenced by address.
+    HandlePool(const HandlePool&) = delete;
+    HandlePool& operator=(const HandlePool&) = delete;
+
+    //----------------//
+    //! @name Objects
+    //! @{
+
+    //! Construct an object in a free slot, with all its arguments.
+    template <class... Args> Handle emplace(Args&&... args);
+
+    //! Destroy the object, its handle becoming stale.
+    //! Note: Safe to call while iterating, the other objects not moving.
+    void erase(Handle handle);
+
+    //! Destroy all objects, keeping the chunks allocated.
+    void clear();
+
+    //! Get the object from its handle, nullptr if stale.
+    T* get(Handle handle);
+
+    //! Get the object from its handle, nullptr if stale.
+    const T* get(Handle handle) const;
+
+    //! How many objects are alive.
+    inline uint size() const { return m_size; }
+
+    //! Whether no object is alive.
+    inline bool empty() const { return m_size == 0u; }
+
+    //! @}
+
+    //------------------//
+    //! @name Iterators
+    //! @{
+
+    iterator begin() { return iterator(this, 0u); }
+    iterator end() { return iterator(this, slotsCount()); }
+    const_iterator begin() const { return const_iterator(this, 0u); }
+    const_iterator end() const { return const_iterator(this, slotsCount()); }
+
+    //! @}
+
+protected:
+
+    //---------------//
+    //! @name Slots
+    //! @{
+
+    //! How many slots are allocated.
+    inline uint32 slotsCount() const { return static_cast<uint32>(m_chunks.size()) * ChunkSize; }
+
+    //! @}
+
+private:
+
+    //! Where an object lives.
+    struct Slot
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; //!< The object, if alive.
+        uint32 generation = 0u;                                             //!< Incremented each time the slot is freed.
+        bool alive = false;                                                 //!< Whether the storage holds an object.
+
+        inline T* object() { return reinterpret_cast<T*>(&storage); }
+        inline const T* object() const { return reinterpret_cast<const T*>(&storage); }
+    };
+
+    //! Slots are allocated by chunks, never moved once allocated.
+    using Chunk = std::array<Slot, ChunkSize>;
+
+    //! How many of the low bits of a handle are for the slot, others being the generation.
+    static constexpr uint32 s_slotBits = 20u;
+
+    //! The mask to get the slot from a handle.
+    static constexpr uint32 s_slotMask = (1u << s_slotBits) - 1u;
+
+    //! The slot from its index.
+    inline Slot& slot(uint32 slotIndex) { return (*m_chunks[slotIndex / ChunkSize])[slotIndex % ChunkSize]; }
+    inline const Slot& slot(uint32 slotIndex) const { return (*m_chunks[slotIndex / ChunkSize])[slotIndex % ChunkSize]; }
+
+private:
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;   //!< All allocated slots.
+    std::vector<uint32> m_freeSlots;                //!< The slots that are free to use, last freed at the end.
+    uint m_size = 0u;                               //!< How many objects are alive.
+};
+
+#include "tools/handlepool.inl"
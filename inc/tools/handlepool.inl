@@ -0,0 +1,138 @@
+#pragma once
+
+#include "tools/platform-fixes.hpp" // make_unique
+#include "tools/tools.hpp"
+#include "tools/debug.hpp"
+
+#include <utility>
+#include <new>
+
+//--------------------//
+//----- Iterator -----//
+
+template <typename T, uint ChunkSize>
+template <class Pool, class Value>
+HandlePool<T, ChunkSize>::Iterator<Pool, Value>::Iterator(Pool* pool, uint32 slotIndex)
+    : m_pool(pool)
+    , m_slotIndex(slotIndex)
+{
+    // Skipping free slots
+    while (m_slotIndex < m_pool->slotsCount() && !m_pool->slot(m_slotIndex).alive)
+        ++m_slotIndex;
+}
+
+template <typename T, uint ChunkSize>
+template <class Pool, class Value>
+inline Value& HandlePool<T, ChunkSize>::Iterator<Pool, Value>::operator*() const
+{
+    return *m_pool->slot(m_slotIndex).object();
+}
+
+template <typename T, uint ChunkSize>
+template <class Pool, class Value>
+inline Value* HandlePool<T, ChunkSize>::Iterator<Pool, Value>::operator->() const
+{
+    return m_pool->slot(m_slotIndex).object();
+}
+
+template <typename T, uint ChunkSize>
+template <class Pool, class Value>
+inline auto HandlePool<T, ChunkSize>::Iterator<Pool, Value>::operator++() -> Iterator&
+{
+    do ++m_slotIndex;
+    while (m_slotIndex < m_pool->slotsCount() && !m_pool->slot(m_slotIndex).alive);
+    return *this;
+}
+
+template <typename T, uint ChunkSize>
+template <class Pool, class Value>
+inline auto HandlePool<T, ChunkSize>::Iterator<Pool, Value>::handle() const -> Handle
+{
+    return (m_pool->slot(m_slotIndex).generation << s_slotBits) | m_slotIndex;
+}
+
+//------------------------------------//
+//----- Constructor & destructor -----//
+
+template <typename T, uint ChunkSize>
+HandlePool<T, ChunkSize>::~HandlePool()
+{
+    clear();
+}
+
+//-------------------//
+//----- Objects -----//
+
+template <typename T, uint ChunkSize>
+template <class... Args>
+auto HandlePool<T, ChunkSize>::emplace(Args&&... args) -> Handle
+{
+    // No free slot, allocate a new chunk, its first slots used first
+    if (m_freeSlots.empty()) {
+        massert(slotsCount() + ChunkSize <= s_slotMask, "Too many objects in the handle pool.");
+        m_chunks.emplace_back(std::make_unique<Chunk>());
+        for (uint32 i = 1u; i <= ChunkSize; ++i)
+            m_freeSlots.emplace_back(slotsCount() - i);
+    }
+
+    auto slotIndex = m_freeSlots.back();
+    m_freeSlots.pop_back();
+
+    auto& freeSlot = slot(slotIndex);
+    new (freeSlot.object()) T(std::forward<Args>(args)...);
+    freeSlot.alive = true;
+    m_size += 1u;
+
+    return (freeSlot.generation << s_slotBits) | slotIndex;
+}
+
+template <typename T, uint ChunkSize>
+void HandlePool<T, ChunkSize>::erase(Handle handle)
+{
+    auto pObject = get(handle);
+    returnif (pObject == nullptr);
+
+    auto slotIndex = handle & s_slotMask;
+    auto& usedSlot = slot(slotIndex);
+    pObject->~T();
+    usedSlot.alive = false;
+    m_size -= 1u;
+
+    // Next generation, never producing the invalid handle
+    usedSlot.generation = (usedSlot.generation + 1u) & (-1u >> s_slotBits);
+    if (((usedSlot.generation << s_slotBits) | slotIndex) == invalidHandle)
+        usedSlot.generation = 0u;
+    m_freeSlots.emplace_back(slotIndex);
+}
+
+template <typename T, uint ChunkSize>
+void HandlePool<T, ChunkSize>::clear()
+{
+    for (uint32 slotIndex = 0u; slotIndex < slotsCount(); ++slotIndex) {
+        auto& usedSlot = slot(slotIndex);
+        if (usedSlot.alive)
+            erase((usedSlot.generation << s_slotBits) | slotIndex);
+    }
+}
+
+template <typename T, uint ChunkSize>
+inline T* HandlePool<T, ChunkSize>::get(Handle handle)
+{
+    auto slotIndex = handle & s_slotMask;
+    returnif (slotIndex >= slotsCount()) nullptr;
+
+    auto& usedSlot = slot(slotIndex);
+    returnif (!usedSlot.alive || usedSlot.generation != (handle >> s_slotBits)) nullptr;
+    return usedSlot.object();
+}
+
+template <typename T, uint ChunkSize>
+inline const T* HandlePool<T, ChunkSize>::get(Handle handle) const
+{
+    auto slotIndex = handle & s_slotMask;
+    returnif (slotIndex >= slotsCount()) nullptr;
+
+    const auto& usedSlot = slot(slotIndex);
+    returnif (!usedSlot.alive || usedSlot.generation != (handle >> s_slotBits)) nullptr;
+    return usedSlot.object();
+}
@@ -1,36 +1,68 @@
 #pragma once
 
+#include "tools/int.hpp"
+
+#include <array>
 #include <random>
 #include <iterator>
+#include <type_traits>
 
 namespace alea
 {
-    extern std::mt19937 s_generator;
+    //! Independent streams of randomness.
+    /*!
+     *  Each subsystem draws from its own generator,
+     *  so that one drawing more numbers (e.g. visual effects depending on the framerate)
+     *  does not change the sequence seen by the others.
+     */
+    enum class Stream : uint8
+    {
+        DEFAULT,    //!< Anything not listed below.
+        HEROES,     //!< Heroes groups spawning.
+        ELEMENTS,   //!< Dungeon elements behaviour.
+        DCB,        //!< Dungeon character builder questions.
+        VISUAL,     //!< Cosmetics, never affecting the game state.
+        COUNT,      //!< Not a stream, keep last.
+    };
+
+    extern std::array<std::mt19937, static_cast<uint>(Stream::COUNT)> s_generators;
+
+    //! Seed all streams, each one getting a different sequence from the same value.
+    void seed(uint32 value);
+
+    //! The generator of a stream.
+    inline std::mt19937& generator(Stream stream = Stream::DEFAULT)
+    {
+        return s_generators[static_cast<uint>(stream)];
+    }
 
     //! Returns a random element from within standard iterators.
     template<typename Iter>
-    inline Iter randIt(Iter start, Iter end)
+    inline Iter randIt(Iter start, Iter end, Stream stream = Stream::DEFAULT)
     {
         using difference_type = typename std::iterator_traits<Iter>::difference_type;
         std::uniform_int_distribution<difference_type>
             distribution(static_cast<difference_type>(0),
             std::distance(start, end) - static_cast<difference_type>(1));
-        return std::next(start, distribution(s_generator));
+        return std::next(start, distribution(generator(stream)));
     }
 
     //! Returns a random element from a standard container.
     template<typename Container>
-    inline auto rand(const Container& container)
+    inline auto rand(const Container& container, Stream stream = Stream::DEFAULT)
         -> decltype(*std::begin(container))
     {
-        return *randIt(std::begin(container), std::end(container));
+        return *randIt(std::begin(container), std::end(container), stream);
     }
 
     //! Returns a random element in the specified range.
+    //! Integers are within [start, end], reals within [start, end[.
     template<typename T>
-    inline T rand(const T& start, const T& end)
+    inline T rand(const T& start, const T& end, Stream stream = Stream::DEFAULT)
     {
-        std::uniform_real_distribution<T> distribution(start, end);
-        return distribution(s_generator);
+        using distribution_type = typename std::conditional<std::is_integral<T>::value,
+            std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>::type;
+        distribution_type distribution(start, end);
+        return distribution(generator(stream));
     }
 }
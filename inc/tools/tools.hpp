@@ -17,6 +17,12 @@ namespace tools
         return element->second;
     }
 
+    //! The rectangle seen through the view, in world coordinates.
+    inline sf::FloatRect viewRect(const sf::View& view)
+    {
+        return {view.getCenter() - view.getSize() / 2.f, view.getSize()};
+    }
+
     // TODO Move to its own file?
     inline sf::FloatRect mapRectCoordsToPixel(const sf::RenderTarget& target, const sf::FloatRect& rect, const sf::View* view = nullptr)
     {
@@ -55,6 +55,9 @@ namespace tools
 {
     //! Intersects two rect into one.
     template<typename T> sf::Rect<T> intersect(const sf::Rect<T>& r1, const sf::Rect<T>& r2);
+
+    //! The smallest rect containing both, a rect with negative size being empty.
+    template<typename T> sf::Rect<T> unite(const sf::Rect<T>& r1, const sf::Rect<T>& r2);
 }
 
 namespace std
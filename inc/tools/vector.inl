@@ -206,6 +206,22 @@ namespace tools
         return r;
     }
 
+    template<typename T> inline
+    sf::Rect<T> unite(const sf::Rect<T>& r1, const sf::Rect<T>& r2)
+    {
+        sf::Rect<T> r;
+
+        if (r1.width < 0.f || r1.height < 0.f) return r2;
+        if (r2.width < 0.f || r2.height < 0.f) return r1;
+
+        r.left = std::min(r1.left, r2.left);
+        r.top = std::min(r1.top, r2.top);
+        r.width = std::max(r1.left + r1.width, r2.left + r2.width) - r.left;
+        r.height = std::max(r1.top + r1.height, r2.top + r2.height) - r.top;
+
+        return r;
+    }
+
     template<typename T> inline
     bool areIntersecting(const sf::Rect<T>& r1, const sf::Rect<T>& r2)
     {
@@ -14,6 +14,12 @@ local SOUTH = 1
 local EAST  = 2
 local WEST  = 3
 
+----------------
+-- Attributes --
+
+local ON        = eev_attribute("on")
+local DIRECTION = eev_attribute("direction")
+
 ------------
 -- Locals --
 
@@ -33,8 +39,8 @@ function _reinit()
     end
 
     -- Get from data
-    on = eev_initEmptyDataBool("on", false)
-    direction = eev_initEmptyDataU32("direction", NORTH)
+    on = eev_initEmptyDataBoolID(ON, false)
+    direction = eev_initEmptyDataU32ID(DIRECTION, NORTH)
 
     refreshDisplay(true)
     refreshRoomLocking()
@@ -119,7 +125,7 @@ function activatePiston()
     success = eev_dungeonPushRoom(x, y, directionString(), 500)
 
     if not success then return end
-    on = eev_setDataBool("on", true)
+    on = eev_setDataBoolID(ON, true)
     refreshDisplay(false)
     refreshRoomLocking()
 end
@@ -131,7 +137,7 @@ function deactivatePiston()
     local x = eev_getCurrentRoomX()
     local y = eev_getCurrentRoomY()
 
-    on = eev_setDataBool("on", false)
+    on = eev_setDataBoolID(ON, false)
     refreshDisplay(false)
     refreshRoomLocking()
 end
@@ -145,10 +151,10 @@ function orientPiston()
     elseif direction == EAST then   direction = SOUTH
     end
 
-    eev_setDataU32("direction", direction)
+    eev_setDataU32ID(DIRECTION, direction)
 
     -- Deactivate the piston
-    on = eev_setDataBool("on", false)
+    on = eev_setDataBoolID(ON, false)
     refreshDisplay(true)
     refreshRoomLocking()
 end
@@ -162,10 +168,10 @@ function turnPiston(turnDirection)
     elseif turnDirection == "east" then   direction = EAST
     end
 
-    eev_setDataU32("direction", direction)
+    eev_setDataU32ID(DIRECTION, direction)
 
     -- Deactivate the piston
-    on = eev_setDataBool("on", false)
+    on = eev_setDataBoolID(ON, false)
     refreshDisplay(true)
     refreshRoomLocking()
 end
@@ -6,6 +6,11 @@
 ---- Description:
 -- A trapdoor that can be triggered to make a hole in the floor.
 
+----------------
+-- Attributes --
+
+local ON = eev_attribute("on")
+
 ------------
 -- Locals --
 
@@ -21,7 +26,7 @@ local on                        -- Always equal to its data homonym
 -- Called on new data
 function _reinit()
     -- Get from data
-    on = eev_initEmptyDataBool("on", false)
+    on = eev_initEmptyDataBoolID(ON, false)
 
     refreshDisplay()
     refreshTunnel()
@@ -91,7 +96,7 @@ end
 function openDoor()
     if on then return end
 
-    on = eev_setDataBool("on", true)
+    on = eev_setDataBoolID(ON, true)
     eev_selectAnimation("open")
     refreshTunnel()
 end
@@ -100,7 +105,7 @@ end
 function closeDoor()
     if not on then return end
 
-    on = eev_setDataBool("on", false)
+    on = eev_setDataBoolID(ON, false)
     eev_selectAnimation("close")
     refreshTunnel()
 end
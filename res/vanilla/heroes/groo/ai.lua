@@ -10,7 +10,7 @@
 
 local altitude_ref
 local visited_ref
-local lastVisit_ref
+local exitDistance_ref
 local treasure_found
 
 ---------------
@@ -49,38 +49,41 @@ end
 ----------------------
 -- Graph navigation --
 
--- Called with the current node information
-function _evaluateReference()
+-- Called with the weights of the current node, then of its neighbours
+-- Returns the evaluation of each of them
+function _evaluateAll(weights, count)
+    local reference = weights[1]
+
     -- If it is the first time we met a treasure, change state
-    if (eev_weight.treasure() > 0) then
-        local stolenDosh = eev_stealTreasure()
-        eev_addDataU32("dosh", stolenDosh)
+    if (reference.treasure > 0) then
+        eev_stealTreasureInto("dosh")
         treasure_found = true
     end
 
     -- Save current references
-    altitude_ref = eev_weight.altitude()
-    visited_ref = eev_weight.visited()
-    lastVisit_ref = eev_weight.lastVisit()
+    altitude_ref = reference.altitude
+    visited_ref = reference.visited
+    exitDistance_ref = reference.exitDistance
 
     -- Try to get out if treasure found or if there is no other nodes to visit
-    if eev_weight.exit() and (treasure_found or eev_weight.visited() >= 5) then
+    if reference.exit and (treasure_found or reference.visited >= 5) then
         eev_getOut()
     end
 
     -- Evaluate the current room
     -- Never stay in the same room
-    return - 42 * eev_weight.visited()
-end
-
--- Called with one of the neighbours of the current node
-function _evaluate()
-    if (treasure_found) then
-        -- Treasure is found, we follow our steps back
-        return lastVisit_ref - eev_weight.lastVisit()
-    else
-        -- We try to get a node that has been least visited, and the higher one
-        return (eev_weight.altitude() - altitude_ref) - 2 * (eev_weight.visited() - visited_ref)
+    local evaluations = { - 42 * reference.visited }
+
+    for i = 2, count do
+        local weight = weights[i]
+        if (treasure_found) then
+            -- Treasure is found, we take the shortest way out
+            evaluations[i] = exitDistance_ref - weight.exitDistance
+        else
+            -- We try to get a node that has been least visited, and the higher one
+            evaluations[i] = (weight.altitude - altitude_ref) - 2 * (weight.visited - visited_ref)
+        end
     end
-end
 
+    return evaluations
+end
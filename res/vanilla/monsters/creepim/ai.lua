@@ -8,6 +8,13 @@
 -- who will just explode himself and the room he's in
 -- if a hero comes too close.
 
+----------------
+-- Attributes --
+
+local FUSING_TIME = eev_attribute("fusingTime")
+local RX          = eev_attribute("rx")
+local RY          = eev_attribute("ry")
+
 ------------
 -- Locals --
 
@@ -22,10 +29,10 @@ local fusing        -- Whether the Creepim is exploding
 -- Called on new data
 function _reinit()
     -- Register data
-    eev_initEmptyDataFloat("fusingTime", 0)
+    eev_initEmptyDataFloatID(FUSING_TIME, 0)
 
     -- Was I fusing?
-    fusingTime = eev_getDataFloat("fusingTime")
+    fusingTime = eev_getDataFloatID(FUSING_TIME)
     if fusingTime ~= 0 then
         startFusing(fusingTime)
     end
@@ -34,7 +41,7 @@ end
 -- Called once on object creation
 function _register()
     -- Register callbacks
-    eev_callbackRegister("cbHeroClose", "hero", "distance < 0.7")
+    eev_callbackEnterRegister("cbHeroClose", "hero", "distance < 0.7")
 end
 
 -- Whenever a hero comes too close
@@ -75,8 +82,8 @@ function _update(dt)
     if fusing then
         -- The animation stopped, here we really explode
         if eev_isAnimationStopped() then
-            local rx = eev_getDataFloat("rx")
-            local ry = eev_getDataFloat("ry")
+            local rx = eev_getDataFloatID(RX)
+            local ry = eev_getDataFloatID(RY)
             fusingTime = 0
             fusing = false
 
@@ -86,7 +93,7 @@ function _update(dt)
         -- Else, just saved how far we got into the animation
         else
             fusingTime = fusingTime + dt
-            eev_setDataFloat("fusingTime", fusingTime)
+            eev_setDataFloatID(FUSING_TIME, fusingTime)
         end
     end
 end
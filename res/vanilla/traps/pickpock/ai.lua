@@ -6,6 +6,11 @@
 ---- Description:
 -- A Pick-pock steals dosh from nearby heroes.
 
+----------------
+-- Attributes --
+
+local DOSH = eev_attribute("dosh")
+
 ------------
 -- Locals --
 
@@ -18,23 +23,23 @@ local stealing = false  -- Whether the Pick-pock is already stealing
 
 -- Called on new data
 function _reinit()
-    currentDosh = eev_initEmptyDataU32("dosh", 0)
+    currentDosh = eev_initEmptyDataU32ID(DOSH, 0)
 end
 
 -- Called once on object creation
 function _register()
-    eev_callbackRegister("cbHeroClose", "hero", "distance < 0.3")
+    eev_callbackRegister("cbHeroClose", "hero", "distance < 0.3 and data.dosh > 0")
 
     eev_setDepth(60)
 end
 
--- Whenever a hero comes too close
+-- Whenever a hero with some money on him comes too close
 function cbHeroClose(heroUID)
     if not stealing then
         local heroDosh = eev_getUIDDataU32(heroUID, "dosh")
 
-        -- Steal money if not full and hero has some on him
-        if currentDosh < maxDosh and heroDosh ~= 0 then
+        -- Steal money if not full
+        if currentDosh < maxDosh then
             -- Stop doing anything else
             stealing = true
             eev_selectAnimation("grab")
@@ -45,7 +50,7 @@ function cbHeroClose(heroUID)
             local doshStolen = math.min(maxDosh - currentDosh, heroDosh)
             eev_setUIDDataU32(heroUID, "dosh", heroDosh - doshStolen)
             currentDosh = currentDosh + doshStolen
-            eev_setDataU32("dosh", currentDosh)
+            eev_setDataU32ID(DOSH, currentDosh)
             eev_warnHarvestableDosh();
         end
     end
@@ -68,7 +73,7 @@ end
 -- Called for harvesting money
 function _harvestDosh()
     local dosh = currentDosh
-    currentDosh = eev_setDataU32("dosh", 0)
+    currentDosh = eev_setDataU32ID(DOSH, 0)
     return dosh
 end
 
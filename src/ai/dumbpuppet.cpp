@@ -28,7 +28,7 @@ void DumbPuppet::updateRoutine(const sf::Time&)
     returnif (lerpable->positionLerping());
 
     // Go somethere randomly
-    sf::Vector2f targetPosition(alea::rand(m_minX, m_maxX), localPosition().y);
+    sf::Vector2f targetPosition(alea::rand(m_minX, m_maxX, alea::Stream::VISUAL), localPosition().y);
     lerpable->setTargetPosition(targetPosition);
 
     if (localPosition().x < targetPosition.x)
@@ -0,0 +1,37 @@
+#include "config/jobs.hpp"
+
+#include "config/debug.hpp"
+#include "tools/filesystem.hpp"
+#include "tools/tools.hpp"
+#include "tools/debug.hpp"
+
+#include <pugixml/pugixml.hpp>
+
+using namespace config;
+
+Jobs::Jobs()
+{
+    pugi::xml_document doc;
+    std::wstring file(L"config/jobs.xml");
+
+    // Keep defaults if not existing
+    if (!fileExists(file)) {
+        wdebug_config_1(L"Jobs config file does not seem to exist. Using default parameters.");
+        return;
+    }
+
+    // Checks if we read the file OK
+    doc.load_file(file.c_str());
+    const auto& config = doc.child(L"config");
+    if (!config || config.attribute(L"type").as_string() != std::wstring(L"jobs")) {
+        wdebug_config_1(L"Could not find valid jobs config file. Using default parameters.");
+        return;
+    }
+
+    // File is OK, parsing it
+    for (auto& param : config.children(L"param")) {
+        std::wstring name = param.attribute(L"name").as_string();
+
+        if (name == L"workers") workersCount = param.attribute(L"count").as_uint();
+    }
+}
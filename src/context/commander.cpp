@@ -26,13 +26,11 @@ Commander::~Commander()
 
 void Commander::update(const sf::Time& dt)
 {
+    m_logTime += dt;
+
     while (!m_commandQueue.empty()) {
         const auto& command = m_commandQueue.front();
 
-        // Log the line if it is written
-        if (!command.line.empty())
-            m_logStream << command.line << std::endl;
-
         // Test each commandable
         for (auto pCommandable : m_commandables)
             if (pCommandable->category() == command.category)
@@ -113,6 +111,7 @@ std::vector<Command> Commander::interpret(const std::wstring& commandLine)
     for (auto pInterpreter : m_interpreters) {
         if (pInterpreter->interpreterKey() != key) continue;
         pInterpreter->interpret(commands, tokens);
+        log(commandLine);
         goto end;
     }
 
@@ -205,3 +204,20 @@ void Commander::remove(Interpreter* pInterpreter)
 {
     std::erase_if(m_interpreters, [pInterpreter] (Interpreter* pElement) { return pElement == pInterpreter; } );
 }
+
+//---------------//
+//----- Log -----//
+
+void Commander::log(const std::wstring& commandLine)
+{
+    returnif (!m_logStream.is_open());
+
+    // Whole milliseconds only, the remainder being kept for the next line
+    auto waitTime = m_logTime.asMilliseconds();
+    if (waitTime > 0) {
+        m_logStream << L"wait " << waitTime << std::endl;
+        m_logTime -= sf::milliseconds(waitTime);
+    }
+
+    m_logStream << commandLine << std::endl;
+}
@@ -3,10 +3,50 @@
 #include "tools/tools.hpp"
 #include "tools/math.hpp"
 
+#include <unordered_map>
 #include <stdexcept>
+#include <cstring>
 
 using namespace context;
 
+namespace
+{
+    //! All interned event names.
+    //! Note: Constructed on first use, as IDs are resolved during static initialization.
+    struct EventsTable
+    {
+        std::unordered_map<std::string, EventID> ids;   //!< ID from name.
+        std::vector<std::string> names;                 //!< Name from ID.
+    };
+
+    EventsTable& eventsTable()
+    {
+        static EventsTable eventsTable;
+        return eventsTable;
+    }
+}
+
+//------------------//
+//----- Events -----//
+
+EventID context::eventID(const std::string& name)
+{
+    auto& table = eventsTable();
+    auto found = table.ids.find(name);
+    returnif (found != std::end(table.ids)) found->second;
+
+    massert(table.names.size() < noEvent, "Too many event types.");
+    auto id = static_cast<EventID>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids[name] = id;
+    return id;
+}
+
+const std::string& context::eventName(EventID id)
+{
+    return eventsTable().names[id];
+}
+
 //--------------------------//
 //----- Event receiver -----//
 
@@ -22,15 +62,18 @@ EventReceiver::~EventReceiver()
     setEmitter(nullptr);
 }
 
-void EventReceiver::setEmitter(EventEmitter* emitter)
+void EventReceiver::setEmitter(EventEmitter* emitter, std::initializer_list<EventID> eventTypes)
 {
     if (m_emitter != nullptr)
-        m_emitter->removeReceiver(this);
+        for (auto eventType : m_eventTypes)
+            m_emitter->removeReceiver(this, eventType);
 
     m_emitter = emitter;
+    m_eventTypes = eventTypes;
 
     if (m_emitter != nullptr)
-        m_emitter->addReceiver(this);
+        for (auto eventType : m_eventTypes)
+            m_emitter->addReceiver(this, eventType);
 
 #if DEBUG_GLOBAL > 0
     if (m_emitter == nullptr)
@@ -43,79 +86,134 @@ void EventReceiver::setEmitter(EventEmitter* emitter)
 
 void EventEmitter::broadcast(uint count)
 {
-    count = std::min(count, static_cast<uint>(m_events.size()));
-    returnif (count == 0u);
-
-#if DEBUG_GLOBAL > 0
-    for (auto& receiver : m_receivers)
-        receiver->m_lock = true;
-#endif
+    // Events added while broadcasting will wait for the next call,
+    // and the ones moved to the end by coalescing too
+    count = std::min(count, m_eventsCount);
 
     for (uint i = 0u; i < count; ++i) {
-        const auto& event = m_events[i];
-        for (auto& receiver : m_receivers)
-            receiver->receive(*event);
+        // Copied, as receivers might add events and grow the buffer
+        auto event = m_events[m_eventsFirst];
+        m_eventsFirst = (m_eventsFirst + 1u) & (m_events.size() - 1u);
+        m_eventsCount -= 1u;
+
+        // Coalesced away
+        const auto& pendingEvent = *reinterpret_cast<const Event*>(&event);
+        if (pendingEvent.type == noEvent) continue;
+
+        m_storedCounts[pendingEvent.type] -= 1u;
+        send(pendingEvent);
     }
+}
+
+void EventEmitter::addEvent(EventID eventType, bool direct)
+{
+    Event event;
+    event.type = eventType;
+    addEvent(event, direct);
+}
 
-    m_events.erase(std::begin(m_events), std::begin(m_events) + count);
+//----------------------//
+//----- Coalescing -----//
 
-#if DEBUG_GLOBAL > 0
-    for (auto& receiver : m_receivers)
-        receiver->m_lock = false;
-#endif
+void EventEmitter::setCoalescing(EventID eventType, Coalescing coalescing)
+{
+    if (eventType >= m_coalescings.size())
+        m_coalescings.resize(eventType + 1u, Coalescing::NONE);
+    m_coalescings[eventType] = coalescing;
 }
 
-void EventEmitter::addEvent(std::unique_ptr<Event> event, bool direct)
+//------------------//
+//----- Events -----//
+
+void EventEmitter::send(const Event& event)
 {
-    // Send it
-    if (direct) {
+    returnif (event.type >= m_receivers.size());
+
 #if DEBUG_GLOBAL > 0
-        for (auto& receiver : m_receivers)
-            receiver->m_lock = true;
+    for (auto& receiver : m_receivers[event.type])
+        receiver->m_lock = true;
 #endif
 
-        for (auto& receiver : m_receivers)
-            receiver->receive(*event);
+    // Not using references, as receivers might register new receivers
+    for (uint i = 0u; i < m_receivers[event.type].size(); ++i)
+        m_receivers[event.type][i]->receive(event);
 
 #if DEBUG_GLOBAL > 0
-        for (auto& receiver : m_receivers)
-            receiver->m_lock = false;
+    for (auto& receiver : m_receivers[event.type])
+        receiver->m_lock = false;
 #endif
+}
+
+void EventEmitter::push(const void* event, uint size)
+{
+    // Cleared, so that the whole storage can be compared
+    EventStorage storage;
+    std::memset(&storage, 0, sizeof(EventStorage));
+    std::memcpy(&storage, event, size);
+
+    auto eventType = reinterpret_cast<const Event*>(&storage)->type;
+    if (eventType >= m_storedCounts.size())
+        m_storedCounts.resize(eventType + 1u, 0u);
+
+    // Coalescing with a stored one, if any
+    auto coalescing = (eventType < m_coalescings.size())? m_coalescings[eventType] : Coalescing::NONE;
+    if (coalescing != Coalescing::NONE && m_storedCounts[eventType] != 0u) {
+        if (coalescing == Coalescing::DROP_IF_LAST_EQUAL) {
+            returnif (std::memcmp(&storedEvent(m_eventsCount - 1u), &storage, sizeof(EventStorage)) == 0);
+        }
+        else if (coalescing == Coalescing::MERGE) {
+            returnif (findStoredEvent(storage, false) != -1u);
+        }
+        else if (coalescing == Coalescing::MOVE_TO_END) {
+            auto index = findStoredEvent(storage, true);
+            if (index != -1u) {
+                returnif (index == m_eventsCount - 1u);
+                reinterpret_cast<Event*>(&storedEvent(index))->type = noEvent;
+                m_storedCounts[eventType] -= 1u;
+            }
+        }
     }
 
-    // Add it to the broadcast list
-    else {
-        // TODO Do not add it twice if event already exists in the list
-        // Be careful, though, because something like
-        //  - facility_changed 0 1
-        //  - room_destroyed 0 1
-        //  - room_created 0 1
-        //  - facility_changed 0 1
-        // Could drop the very useful last facility_changed
-        // Two possibilities :
-        //  - Drop the event if the last is the same (quick check and no problem with that)
-        //  - OR Move the event to the end. Leaving it with one copy but being sure the other things are done well before
-        //      (checking the list from the end would be the quickest)
-        m_events.emplace_back(std::move(event));
+    // Full, double the storage, keeping events in order
+    if (m_eventsCount == m_events.size()) {
+        std::vector<EventStorage> events(std::max(16u, 2u * static_cast<uint>(m_events.size())));
+        for (uint i = 0u; i < m_eventsCount; ++i)
+            events[i] = m_events[(m_eventsFirst + i) & (m_events.size() - 1u)];
+        m_events = std::move(events);
+        m_eventsFirst = 0u;
     }
+
+    m_events[(m_eventsFirst + m_eventsCount) & (m_events.size() - 1u)] = storage;
+    m_storedCounts[eventType] += 1u;
+    m_eventsCount += 1u;
 }
 
-void EventEmitter::addEvent(std::string eventType, bool direct)
+EventEmitter::EventStorage& EventEmitter::storedEvent(uint index)
 {
-    auto event = std::make_unique<Event>();
-    event->type = std::move(eventType);
-    addEvent(std::move(event), direct);
+    return m_events[(m_eventsFirst + index) & (m_events.size() - 1u)];
+}
+
+uint EventEmitter::findStoredEvent(const EventStorage& event, bool fromEnd)
+{
+    for (uint i = 0u; i < m_eventsCount; ++i) {
+        auto index = (fromEnd)? m_eventsCount - 1u - i : i;
+        returnif (std::memcmp(&storedEvent(index), &event, sizeof(EventStorage)) == 0) index;
+    }
+
+    return -1u;
 }
 
 //-------------------------------//
 //----- Receiver management -----//
 
-void EventEmitter::addReceiver(EventReceiver* receiver)
+void EventEmitter::addReceiver(EventReceiver* receiver, EventID eventType)
 {
-    m_receivers.emplace_back(receiver);
+    if (eventType >= m_receivers.size())
+        m_receivers.resize(eventType + 1u);
+    m_receivers[eventType].emplace_back(receiver);
 }
 
-void EventEmitter::removeReceiver(EventReceiver* receiver)
+void EventEmitter::removeReceiver(EventReceiver* receiver, EventID eventType)
 {
-    std::erase_if(m_receivers, [=](EventReceiver* inReceiver) { return receiver == inReceiver; });
+    std::erase_if(m_receivers[eventType], [=](EventReceiver* inReceiver) { return receiver == inReceiver; });
 }
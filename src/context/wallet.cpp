@@ -1,6 +1,5 @@
 #include "context/wallet.hpp"
 
-#include "context/event.hpp"
 #include "tools/tools.hpp"
 
 using namespace context;
@@ -74,10 +73,10 @@ bool Wallet::addsub(uint addValue, uint subValue)
 //-------------------//
 //----- Control -----//
 
-void Wallet::setEvents(context::EventEmitter* emitter, std::string eventType)
+void Wallet::setEvents(context::EventEmitter* emitter, EventID eventType)
 {
     m_emitter = emitter;
-    m_eventType = std::move(eventType);
+    m_eventType = eventType;
 }
 
 void Wallet::setFactor(uint factor)
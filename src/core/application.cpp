@@ -2,8 +2,10 @@
 
 #include "core/debug.hpp"
 #include "core/gettext.hpp"
+#include "core/jobsystem.hpp"
 #include "context/context.hpp"
 #include "context/componenter.hpp"
+#include "scene/graph.hpp"
 #include "states/identifiers.hpp"
 #include "tools/vector.hpp"
 #include "tools/string.hpp"
@@ -66,6 +68,7 @@ Application::Application(const std::vector<std::string>& args)
     context::context.windowInfo.title = "Evilly Evil Villains";
     i18n::initLanguagesList();
     refreshFromConfig();
+    s_jobs.start(context::context.jobs.workersCount);
 
     // Load all on start (except textures)
     preloadTextures();
@@ -91,6 +94,7 @@ Application::Application(const std::vector<std::string>& args)
 Application::~Application()
 {
     freeComponents();
+    s_jobs.stop();
 
     if (m_scriptStream.is_open())
         m_scriptStream.close();
@@ -236,6 +240,16 @@ void Application::processInput()
 void Application::synchronizeMouse()
 {
     const auto& mousePosition = sf::Mouse::getPosition(context::context.window);
+    const auto hitTestEpoch = scene::Graph::hitTestEpoch();
+
+    // Nothing moved, neither the mouse nor the scene
+    bool skipped = (mousePosition == m_mousePosition && hitTestEpoch == m_mouseHitTestEpoch);
+    s_visualDebug.addMouseHitTest(skipped);
+    returnif (skipped);
+
+    // Entities reacting to the event might change the scene, and will be tested again
+    m_mousePosition = mousePosition;
+    m_mouseHitTestEpoch = hitTestEpoch;
 
     sf::Event mouseMovedEvent;
     mouseMovedEvent.type = sf::Event::MouseMoved;
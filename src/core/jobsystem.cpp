@@ -0,0 +1,228 @@
+#include "core/jobsystem.hpp"
+
+#include "tools/platform-fixes.hpp" // make_unique
+#include "tools/tools.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    //! The job system which created the current thread, if any.
+    thread_local const JobSystem* t_system = nullptr;
+
+    //! The queue of the current thread within that job system.
+    thread_local uint t_queueIndex = 0u;
+}
+
+//----------------------------//
+//----- Static variables -----//
+
+JobSystem s_jobs;
+
+//-------------------//
+//----- Workers -----//
+
+JobSystem::JobSystem()
+{
+    m_queues.emplace_back(std::make_unique<Queue>());
+}
+
+JobSystem::~JobSystem()
+{
+    stop();
+}
+
+void JobSystem::start(uint workersCount)
+{
+    stop();
+
+    if (workersCount == 0u)
+        workersCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (uint i = 1u; i < workersCount; ++i)
+        m_queues.emplace_back(std::make_unique<Queue>());
+    for (uint i = 1u; i < workersCount; ++i)
+        m_threads.emplace_back(&JobSystem::workerRoutine, this, i);
+}
+
+void JobSystem::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+
+    m_wakeCondition.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+    m_stopping = false;
+
+    // Jobs not taken yet are still run by the threads joining their group
+    auto& jobs = m_queues.front()->jobs;
+    for (uint i = 1u; i < m_queues.size(); ++i)
+        for (auto& job : m_queues[i]->jobs)
+            jobs.emplace_back(std::move(job));
+    m_queues.resize(1u);
+}
+
+//----------------//
+//----- Jobs -----//
+
+void JobSystem::fork(JobGroup& group, const char* name, std::function<void()> function)
+{
+    group.m_pending += 1u;
+    push({name, std::move(function), &group});
+}
+
+void JobSystem::forkAfter(JobGroup& dependency, JobGroup& group, const char* name, std::function<void()> function)
+{
+    group.m_pending += 1u;
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_pending != 0u) {
+            dependency.m_continuations.push_back({name, std::move(function), &group});
+            return;
+        }
+    }
+
+    push({name, std::move(function), &group});
+}
+
+void JobSystem::join(JobGroup& group)
+{
+    while (!group.done()) {
+        Job job;
+        if (pop(job)) execute(job);
+        else std::this_thread::yield();
+    }
+
+    // The last job might still be releasing the group
+    std::lock_guard<std::mutex> lock(group.m_mutex);
+}
+
+void JobSystem::parallelFor(const char* name, uint count, const std::function<void(uint)>& function, uint grain)
+{
+    returnif (count == 0u);
+    grain = std::max(grain, 1u);
+
+    JobGroup group;
+    for (uint begin = 0u; begin < count; begin += grain) {
+        auto end = std::min(begin + grain, count);
+        fork(group, name, [&function, begin, end] {
+            for (uint i = begin; i < end; ++i)
+                function(i);
+        });
+    }
+
+    join(group);
+}
+
+//---------------------------//
+//----- Instrumentation -----//
+
+void JobSystem::setHooks(Hook onStart, Hook onFinish)
+{
+    m_onStart = std::move(onStart);
+    m_onFinish = std::move(onFinish);
+}
+
+//-------------------//
+//----- Threads -----//
+
+uint JobSystem::queueIndex() const
+{
+    return (t_system == this)? t_queueIndex : 0u;
+}
+
+void JobSystem::push(Job job)
+{
+    {
+        auto& queue = *m_queues[queueIndex()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.emplace_back(std::move(job));
+        m_queuedCount += 1u;
+    }
+
+    // Taking the lock, a thread going to sleep cannot miss the notification
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+bool JobSystem::pop(Job& job)
+{
+    returnif (m_queuedCount == 0u) false;
+
+    // Own newest job first
+    const auto ownIndex = queueIndex();
+    {
+        auto& queue = *m_queues[ownIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queuedCount -= 1u;
+            return true;
+        }
+    }
+
+    // Then the oldest ones of the others
+    for (uint i = 1u; i < m_queues.size(); ++i) {
+        auto& queue = *m_queues[(ownIndex + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queuedCount -= 1u;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+    const auto worker = queueIndex();
+
+    if (m_onStart != nullptr) m_onStart(job.name, worker);
+    job.function();
+    if (m_onFinish != nullptr) m_onFinish(job.name, worker);
+
+    finish(*job.group);
+}
+
+void JobSystem::finish(JobGroup& group)
+{
+    std::vector<Job> continuations;
+
+    {
+        std::lock_guard<std::mutex> lock(group.m_mutex);
+        if (--group.m_pending == 0u)
+            continuations.swap(group.m_continuations);
+    }
+
+    for (auto& continuation : continuations)
+        push(std::move(continuation));
+}
+
+void JobSystem::workerRoutine(uint index)
+{
+    t_system = this;
+    t_queueIndex = index;
+
+    while (true) {
+        Job job;
+        if (pop(job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this] { return m_stopping || m_queuedCount != 0u; });
+        returnif (m_stopping);
+    }
+}
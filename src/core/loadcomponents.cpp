@@ -5,6 +5,8 @@
 #include "scene/components/lerpable.hpp"
 #include "scene/components/lightemitter.hpp"
 #include "scene/components/lightnormals.hpp"
+#include "scene/components/luacache.hpp"
+#include "tools/filesystem.hpp"
 
 void Application::loadComponents()
 {
@@ -12,6 +14,10 @@ void Application::loadComponents()
     context::componenter.registerComponentType<scene::Lerpable>();
     context::componenter.registerComponentType<scene::LightEmitter>();
     context::componenter.registerComponentType<scene::LightNormals>();
+
+    // Compiled lua scripts are kept between runs
+    createDirectory(L"cache");
+    scene::s_luaCache.setDirectory("cache/lua");
 }
 
 // FIXME No more game factor.
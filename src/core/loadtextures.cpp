@@ -2,25 +2,62 @@
 
 #include "core/debug.hpp"
 #include "context/context.hpp"
+#include "core/jobsystem.hpp"
 #include "tools/filesystem.hpp"
+#include "tools/platform-fixes.hpp" // make_unique, erase_if
 
-void Application::loadTextures(const std::initializer_list<std::string>& folders)
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+
+void Application::loadTextures(const std::initializer_list<std::string>& folders, bool atlased)
 {
     // Recursively load all files in resource directory
     for (const auto& folder : folders) {
-        uint texturesCount = 0u;
+        std::vector<std::string> filenames;
 
         for (const auto& fileInfo : listFiles("res/" + folder, true)) {
             // Load only png files
             if (fileInfo.isDirectory || fileExtension(fileInfo.name) != "png")
                 continue;
 
-            context::context.textures.load(fileInfo.fullName).setSmooth(true);
+            filenames.emplace_back(fileInfo.fullName);
+        }
+
+        // Sorted, as the atlas depends on the order
+        std::sort(std::begin(filenames), std::end(filenames));
+
+        // Already packed in the atlas saved, only the big ones are left
+        auto& textures = context::context.textures;
+        bool atlasLoaded = atlased && textures.loadAtlas(folder, filenames);
+        auto pending = filenames;
+        if (atlasLoaded)
+            std::erase_if(pending, [&textures] (const std::string& filename) { return textures.fileStored(filename); });
 
-            ++texturesCount;
+        // Decoding is the slow part, and does not need the OpenGL context
+        std::vector<std::unique_ptr<sf::Image>> images(pending.size());
+        s_jobs.parallelFor("decodeTexture", pending.size(), [&pending, &images] (uint index) {
+            auto image = std::make_unique<sf::Image>();
+            if (image->loadFromFile(pending[index]))
+                images[index] = std::move(image);
+        });
+
+        // Packing and uploading stay on this thread
+        if (atlased && !atlasLoaded)
+            textures.packAtlas(folder, pending, images);
+
+        for (uint i = 0u; i < pending.size(); ++i) {
+            if (atlased && textures.fileStored(pending[i])) continue;
+
+            auto texture = std::make_unique<sf::Texture>();
+            if (images[i] == nullptr || !texture->loadFromImage(*images[i]))
+                mquit("Failed to load '" + pending[i] + "'. Ouch.");
+
+            textures.store(pending[i], std::move(texture)).setSmooth(true);
         }
 
-        mdebug_core_2("Loaded " << texturesCount << " textures from " << folder << ".");
+        mdebug_core_2("Loaded " << filenames.size() << " textures from " << folder << (atlasLoaded? ", atlas from cache." : "."));
     }
 }
 
@@ -34,6 +71,10 @@ void Application::freeTextures(const std::initializer_list<std::string>& folders
 
 void Application::preloadTextures()
 {
+    // Atlases are kept between runs
+    createDirectory(L"cache");
+    context::context.textures.setAtlasDirectory("cache/atlases");
+
     loadTextures({"core/default", "core/cursor", "core/global", "core/ltbl", "core/menu/main", "core/menu/loading", "core/nui", "core/posteffects"});
 
     // Force default
@@ -56,7 +56,7 @@ int main(int argc, char *argv[])
         args[i] = argv[i + 1u];
 
     // Initialize randomness
-    alea::s_generator.seed(time(nullptr));
+    alea::seed(time(nullptr));
 
     // As we do not control all libraries,
     // keeping in sync is important to avoid interleaved characters.
@@ -0,0 +1,114 @@
+#include "core/simulation.hpp"
+#include "tools/random.hpp"
+#include "tools/string.hpp"
+#include "tools/tools.hpp"
+
+#include <iostream>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+//! Prints how to use the program.
+void usage()
+{
+    std::cerr << "Usage: eev-sim <world-folder> [--hours N] [--seed S] [--step SECONDS] [--replay FILE] [--threads N]" << std::endl;
+    std::cerr << "    world-folder  The folder of the world, as in saves/worlds.xml (e.g. example/)." << std::endl;
+    std::cerr << "    --hours N     In-game hours to simulate (default 24)." << std::endl;
+    std::cerr << "    --seed S      Seed of all randomness (default 42)." << std::endl;
+    std::cerr << "    --step S      Fixed time step, in real seconds (default 1/71, as the game)." << std::endl;
+    std::cerr << "    --replay F    Replay a commands log (e.g. log/commands_*.eev) instead of running for hours." << std::endl;
+    std::cerr << "    --threads N   Let heroes and monsters decide on N threads before being updated (default 0, as the game)." << std::endl;
+}
+
+//! Read a whole unsigned integer, returns false if the text is something else.
+bool parseUint(const std::string& text, uint& value)
+{
+    returnif (text.empty() || text[0u] < '0' || text[0u] > '9') false;
+
+    char* end = nullptr;
+    errno = 0;
+    auto parsed = std::strtoul(text.c_str(), &end, 10);
+    returnif (*end != '\0' || errno == ERANGE || parsed > std::numeric_limits<uint>::max()) false;
+
+    value = static_cast<uint>(parsed);
+    return true;
+}
+
+//! Read a whole positive float, returns false if the text is something else.
+bool parsePositiveFloat(const std::string& text, float& value)
+{
+    returnif (text.empty()) false;
+
+    char* end = nullptr;
+    errno = 0;
+    auto parsed = std::strtof(text.c_str(), &end);
+    returnif (*end != '\0' || errno == ERANGE || !std::isfinite(parsed) || parsed <= 0.f) false;
+
+    value = parsed;
+    return true;
+}
+
+//! Headless simulation of a dungeon, for balancing and soak tests.
+int main(int argc, char *argv[])
+{
+    //----- Arguments -----//
+
+    std::vector<std::string> args(argc - 1);
+    for (uint i = 0u; i < args.size(); ++i)
+        args[i] = argv[i + 1u];
+
+    // The folder, then pairs of option and value
+    if (args.size() % 2u == 0u || args[0u] == "--help") {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::wstring folder = toWString(args[0u]);
+    uint gameHours = 24u;
+    uint seed = 42u;
+    float step = 1.f / 71.f;
+    std::string replayFile;
+    uint threads = 0u;
+
+    // Unknown options and malformed values are refused
+    for (uint i = 1u; i < args.size(); i += 2u) {
+        const auto& value = args[i + 1u];
+        bool valid = true;
+        if (args[i] == "--hours")        valid = parseUint(value, gameHours);
+        else if (args[i] == "--seed")    valid = parseUint(value, seed);
+        else if (args[i] == "--step")    valid = parsePositiveFloat(value, step);
+        else if (args[i] == "--replay")  replayFile = value;
+        else if (args[i] == "--threads") valid = parseUint(value, threads);
+        else valid = false;
+
+        if (!valid) {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    //----- Simulation -----//
+
+    // Fixed seed, for all streams
+    alea::seed(seed);
+
+    Simulation simulation;
+    simulation.setAIWorkers(threads);
+    if (!simulation.load(folder)) {
+        std::wcerr << L"No world found in folder '" << folder << L"'." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (replayFile.empty()) {
+        simulation.run(gameHours, sf::seconds(step));
+    }
+    else if (!simulation.replay(replayFile, sf::seconds(step))) {
+        std::cerr << "Cannot open commands log '" << replayFile << "'." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    simulation.print(std::cout);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+#include "core/simulation.hpp"
+
+#include "core/application.hpp"
+#include "context/context.hpp"
+#include "context/componenter.hpp"
+#include "context/worlds.hpp"
+#include "core/jobsystem.hpp"
+#include "scene/components/ai.hpp"
+#include "scene/components/lerpable.hpp"
+#include "scene/components/lightemitter.hpp"
+#include "scene/components/lightnormals.hpp"
+#include "scene/components/luacache.hpp"
+#include "tools/filesystem.hpp"
+#include "tools/platform-fixes.hpp" // find_if
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+Simulation::Simulation()
+{
+    // No audio, the window is never created
+    context::context.sounds.setMuted(true);
+
+    // Atlases and compiled lua scripts are kept between runs
+    createDirectory(L"cache");
+    context::context.textures.setAtlasDirectory("cache/atlases");
+    scene::s_luaCache.setDirectory("cache/lua");
+
+    // Only what elements and the inter use, missing ones falling back to defaults
+    Application::loadTextures({"core/default", "core/ltbl", "core/nui", "core/dungeon/effects", "core/dungeon/inter"});
+    Application::loadTextures({"vanilla"}, true);
+    context::context.textures.setDefault("core/default/default");
+
+    context::context.animations.load("core/default/default.scml");
+    context::context.animations.setDefault("default/default");
+    Application::loadAnimations({"core/dungeon/effects", "vanilla"});
+
+    for (const auto& fileInfo : listFiles("res/core/global/fonts", true))
+        if (!fileInfo.isDirectory && fileExtension(fileInfo.name) == "ttf")
+            context::context.fonts.load(fileInfo.fullName);
+
+    // Components, as in the game
+    context::componenter.registerComponentType<scene::AI>();
+    context::componenter.registerComponentType<scene::Lerpable>();
+    context::componenter.registerComponentType<scene::LightEmitter>();
+    context::componenter.registerComponentType<scene::LightNormals>();
+}
+
+Simulation::~Simulation()
+{
+    context::componenter.unregisterComponentType<scene::AI>();
+    context::componenter.unregisterComponentType<scene::Lerpable>();
+    context::componenter.unregisterComponentType<scene::LightEmitter>();
+    context::componenter.unregisterComponentType<scene::LightNormals>();
+}
+
+//-------------------//
+//----- Routine -----//
+
+void Simulation::setAIWorkers(uint workersCount)
+{
+    // Elements sharing a VM cannot decide concurrently, so each script gets one VM per worker
+    returnif (workersCount == 0u);
+    s_jobs.start(workersCount);
+    scene::AI::setVMsPerScript(s_jobs.workersCount());
+    m_inter.setParallelAI(true);
+}
+
+bool Simulation::load(const std::wstring& folder)
+{
+    // The world is selected, as the data need its gamemode
+    context::worlds.load();
+    const auto& worlds = context::worlds.get();
+    auto pWorld = std::find_if(worlds, [&folder] (const context::Worlds::World& world) { return world.folder == folder; });
+    returnif (pWorld == std::end(worlds)) false;
+    context::worlds.select(pWorld->index);
+
+    m_data.load(folder);
+    m_graph.useData(m_data);
+
+    m_root.attachChild(m_inter);
+    m_inter.init();
+    m_inter.useData(m_data);
+    m_inter.setRoomWidth(128.f);
+
+    return true;
+}
+
+const Simulation::Report& Simulation::run(uint gameHours, const sf::Time& step)
+{
+    startReport();
+
+    const auto startTime = m_data.time();
+    while (m_data.time() - startTime < gameHours)
+        tick(step);
+
+    finishReport(startTime);
+    return m_report;
+}
+
+bool Simulation::replay(const std::string& file, const sf::Time& step)
+{
+    std::wifstream stream(file);
+    returnif (!stream.is_open()) false;
+
+    startReport();
+    const auto startTime = m_data.time();
+
+    // Same format as scripts: blank lines and comments are skipped
+    sf::Time waitTime;
+    std::wstring line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || line[0u] == L'#') continue;
+
+        if (line.find(L"wait") == 0u) {
+            int waitMilliseconds = 0;
+            std::wstringstream ss(line.substr(4u));
+            ss >> waitMilliseconds;
+            waitTime += sf::milliseconds(waitMilliseconds);
+            continue;
+        }
+
+        while (waitTime > sf::Time::Zero) {
+            tick(step);
+            waitTime -= step;
+        }
+
+        context::context.commander.push(context::context.commander.interpret(line));
+    }
+
+    // Let the last commands be executed
+    tick(step);
+
+    finishReport(startTime);
+    return true;
+}
+
+void Simulation::print(std::ostream& out) const
+{
+    auto milliseconds = [] (const sf::Time& time) { return time.asMicroseconds() / 1000.f; };
+    const auto totalSeconds = std::max(m_report.total.asSeconds(), 1e-6f);
+
+    out << "Simulated " << m_report.gameHours << " in-game hours in " << m_report.ticks << " ticks" << std::endl;
+    out << "    Wall time: " << milliseconds(m_report.total) << "ms" << std::endl;
+    out << "    Ticks/sec: " << m_report.ticks / totalSeconds << std::endl;
+
+    out << "Timings" << std::endl;
+    out << "    Events:     " << milliseconds(m_report.data.events) << "ms" << std::endl;
+    out << "    Heroes:     " << milliseconds(m_report.data.heroes) << "ms" << std::endl;
+    out << "    Monsters:   " << milliseconds(m_report.data.monsters) << "ms" << std::endl;
+    out << "    Dynamics:   " << milliseconds(m_report.data.dynamics) << "ms" << std::endl;
+    out << "    Elements:   " << milliseconds(m_report.elements) << "ms" << std::endl;
+    out << "    Components: " << milliseconds(m_report.components) << "ms" << std::endl;
+
+    out << "Wallets" << std::endl;
+    out << "    Dosh: " << m_data.doshWallet().value() << std::endl;
+    out << "    Evil: " << m_data.evilWallet().value() << std::endl;
+    out << "    Fame: " << m_data.fameWallet().value() << std::endl;
+    out << "    Soul: " << m_data.soulWallet().value() << std::endl;
+
+    out << "Digest: " << std::hex << m_data.digest() << std::dec << std::endl;
+}
+
+//------------------//
+//----- Report -----//
+
+void Simulation::startReport()
+{
+    m_report = Report();
+    m_data.setUpdateTimed(true);
+    m_clock.restart();
+}
+
+void Simulation::tick(const sf::Time& step)
+{
+    sf::Clock partClock;
+
+    // Same order as the game: commands, data, then the scene, then components
+    context::context.commander.update(step);
+    m_data.update(step);
+
+    partClock.restart();
+    m_root.update(step, 1.f);
+    m_report.elements += partClock.restart();
+
+    context::componenter.update<scene::Lerpable>(step);
+    m_report.components += partClock.restart();
+
+    m_report.ticks += 1u;
+}
+
+void Simulation::finishReport(uint startTime)
+{
+    m_report.total = m_clock.getElapsedTime();
+    m_report.gameHours = m_data.time() - startTime;
+    m_report.data = m_data.updateTimings();
+    m_data.setUpdateTimed(false);
+}
@@ -35,7 +35,8 @@ void VisualDebug::update(const sf::Time& dt)
         if (m_renderedUpdates != 0u)
             str << L"Average LTT (µs): " << m_logicTickTimeSum / m_renderedUpdates << std::endl;
         if (m_renderedFrames != 0u)
-            str << L"Average RTT (µs): " << m_renderTickTimeSum / m_renderedFrames;
+            str << L"Average RTT (µs): " << m_renderTickTimeSum / m_renderedFrames << std::endl;
+        str << L"Mouse hit tests: " << m_mouseHitTests << L" [" << m_mouseHitTestsSkipped << L" skipped]";
         m_text.setString(str.str());
         updateBackgroundSize();
 
@@ -45,6 +46,8 @@ void VisualDebug::update(const sf::Time& dt)
         m_renderedUpdates = 0;
         m_logicTickTimeSum = 0;
         m_renderTickTimeSum = 0;
+        m_mouseHitTests = 0;
+        m_mouseHitTestsSkipped = 0;
     }
 }
 
@@ -62,6 +65,14 @@ void VisualDebug::setRenderTickTime(const sf::Time& t)
     m_renderTickTimeSum += t.asMicroseconds();
 }
 
+void VisualDebug::addMouseHitTest(bool skipped)
+{
+    returnif (!m_visible);
+
+    if (skipped) ++m_mouseHitTestsSkipped;
+    else ++m_mouseHitTests;
+}
+
 void VisualDebug::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     returnif (!m_visible);
@@ -111,5 +122,7 @@ void VisualDebug::switchVisible()
         m_renderedUpdates = 0;
         m_logicTickTimeSum = 0;
         m_renderTickTimeSum = 0;
+        m_mouseHitTests = 0;
+        m_mouseHitTestsSkipped = 0;
     }
 }
@@ -3,6 +3,7 @@
 #include "dcb/debug.hpp"
 #include "dcb/bubble.hpp"
 #include "dcb/answerbox.hpp"
+#include "tools/random.hpp"
 #include "tools/tools.hpp"
 
 #include <pugixml/pugixml.hpp>
@@ -49,7 +50,7 @@ void Controller::continueSequence()
     }
 
     // Pick
-    do { m_selectedQuestion = rand() % m_points.size(); }
+    do { m_selectedQuestion = alea::rand(0u, static_cast<uint>(m_points.size()) - 1u, alea::Stream::DCB); }
     while (m_questionsSeen.find(m_selectedQuestion) != std::end(m_questionsSeen));
     m_questionsSeen.emplace(m_selectedQuestion);
 
@@ -114,29 +115,32 @@ void Controller::addPointsFromType(AnswersPoints& answersPoints, const std::wstr
 {
     Points points;
 
+    // An integer within [0, limit[
+    auto randPoints = [] (uint limit) { return static_cast<float>(alea::rand(0u, limit - 1u, alea::Stream::DCB)); };
+
     if (type == L"lie") {
-        points[GaugesManager::GaugeID::APPRECIATION]    = fmod(rand(), 31.f) - 15.f;
-        points[GaugesManager::GaugeID::CONFUSION]       = -fmod(rand(), 6.f);
-        points[GaugesManager::GaugeID::TRUST]           = -fmod(rand(), 16.f);
-        points[GaugesManager::GaugeID::CONVICTION]      = 15.f + fmod(rand(), 11.f);
+        points[GaugesManager::GaugeID::APPRECIATION]    = randPoints(31u) - 15.f;
+        points[GaugesManager::GaugeID::CONFUSION]       = -randPoints(6u);
+        points[GaugesManager::GaugeID::TRUST]           = -randPoints(16u);
+        points[GaugesManager::GaugeID::CONVICTION]      = 15.f + randPoints(11u);
     }
     else if (type == L"truth") {
-        points[GaugesManager::GaugeID::APPRECIATION]    = 5.f + fmod(rand(), 21.f);
-        points[GaugesManager::GaugeID::CONFUSION]       = -fmod(rand(), 6.f);
-        points[GaugesManager::GaugeID::TRUST]           = fmod(rand(), 31.f) - 15.f;
-        points[GaugesManager::GaugeID::CONVICTION]      = -5.f - fmod(rand(), 16.f);
+        points[GaugesManager::GaugeID::APPRECIATION]    = 5.f + randPoints(21u);
+        points[GaugesManager::GaugeID::CONFUSION]       = -randPoints(6u);
+        points[GaugesManager::GaugeID::TRUST]           = randPoints(31u) - 15.f;
+        points[GaugesManager::GaugeID::CONVICTION]      = -5.f - randPoints(16u);
     }
     else if (type == L"sarcasm") {
-        points[GaugesManager::GaugeID::APPRECIATION]    = -fmod(rand(), 16.f);
-        points[GaugesManager::GaugeID::CONFUSION]       = fmod(rand(), 5.f) - 15.f;
-        points[GaugesManager::GaugeID::TRUST]           = 5.f + fmod(rand(), 21.f);
-        points[GaugesManager::GaugeID::CONVICTION]      = -fmod(rand(), 6.f);
+        points[GaugesManager::GaugeID::APPRECIATION]    = -randPoints(16u);
+        points[GaugesManager::GaugeID::CONFUSION]       = randPoints(5u) - 15.f;
+        points[GaugesManager::GaugeID::TRUST]           = 5.f + randPoints(21u);
+        points[GaugesManager::GaugeID::CONVICTION]      = -randPoints(6u);
     }
     else if (type == L"absurd") {
-        points[GaugesManager::GaugeID::APPRECIATION]    = fmod(rand(), 31.f) - 15.f;
-        points[GaugesManager::GaugeID::CONFUSION]       = 15.f + fmod(rand(), 21.f);
-        points[GaugesManager::GaugeID::TRUST]           = fmod(rand(), 31.f) - 15.f;
-        points[GaugesManager::GaugeID::CONVICTION]      = fmod(rand(), 31.f) - 15.f;
+        points[GaugesManager::GaugeID::APPRECIATION]    = randPoints(31u) - 15.f;
+        points[GaugesManager::GaugeID::CONFUSION]       = 15.f + randPoints(21u);
+        points[GaugesManager::GaugeID::TRUST]           = randPoints(31u) - 15.f;
+        points[GaugesManager::GaugeID::CONVICTION]      = randPoints(31u) - 15.f;
     }
     else {
         mquit("Unknown answer type loading DCB file.");
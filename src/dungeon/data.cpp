@@ -10,18 +10,49 @@
 #include "tools/filesystem.hpp"
 
 #include <pugixml/pugixml.hpp>
+#include <SFML/System/Clock.hpp>
 #include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 
 using namespace dungeon;
 
 Data::Data()
     : m_floorsCount(0u)
     , m_floorRoomsCount(0u)
+    , m_binarySaves(false)
     , m_timeGameHour(1.f)
 {
     // Wallets
-    m_soulWallet.setEvents(this, "soul_changed");
-    m_fameWallet.setEvents(this, "fame_changed");
+    m_soulWallet.setEvents(this, events::soulChanged);
+    m_fameWallet.setEvents(this, events::fameChanged);
+
+    // Events coalescing, receivers read the current state anyway,
+    // so that bulk edits cause only one graph rebuild.
+    // Constructions and destructions are kept, as their order matters.
+    for (auto eventType : {events::dungeonChanged, events::roomChanged, events::roomHideChanged,
+                           events::facilityChanged, events::trapChanged, events::treasureChanged,
+                           events::harvestableDoshChanged})
+        setCoalescing(eventType, context::Coalescing::MOVE_TO_END);
+
+    for (auto eventType : {events::dungeonGraphChanged, events::trapGenericChanged, events::monsterGenericChanged,
+                           events::reserveCountdownChanged, events::timeChanged, events::debtChanged,
+                           events::doshChanged, events::evilChanged, events::soulChanged, events::fameChanged})
+        setCoalescing(eventType, context::Coalescing::MERGE);
+}
+
+Data::~Data()
+{
+    // Let the worker finish what is pending
+    {
+        std::lock_guard<std::mutex> lock(m_savesMutex);
+        m_savesQuit = true;
+    }
+
+    m_savesCondition.notify_all();
+    if (m_savesThread.joinable())
+        m_savesThread.join();
 }
 
 //-------------------//
@@ -35,7 +66,7 @@ void Data::update(const sf::Time& dt)
     while (gameTimeBuffer >= m_timeGameHour) {
         gameTimeBuffer -= m_timeGameHour;
         m_time += 1u;
-        EventEmitter::addEvent("time_changed");
+        EventEmitter::addEvent(events::timeChanged);
 
         // Debt
         // TODO We probably want to let the generalWallet to manage debts (and multiple debts)
@@ -49,7 +80,7 @@ void Data::update(const sf::Time& dt)
                 // TODO Game over if no more dosh
             }
 
-            EventEmitter::addEvent("debt_changed");
+            EventEmitter::addEvent(events::debtChanged);
         }
     }
 
@@ -63,20 +94,31 @@ void Data::update(const sf::Time& dt)
             if (monsterGenericPair.second.countdown == 0u) continue;
             monsterGenericPair.second.countdown -= 1u;
 
-            auto event = std::make_unique<Event>();
-            event->type = "reserve_countdown_changed";
-            event->monster.id = monsterGenericPair.first.c_str();
-            EventEmitter::addEvent(std::move(event));
+            Event event;
+            event.type = events::reserveCountdownChanged;
+            event.monster.id = monsterGenericPair.first.c_str();
+            EventEmitter::addEvent(event);
         }
     }
 
     // Send events
+    sf::Clock clock;
     broadcast();
+    if (m_updateTimed) m_updateTimings.events += clock.restart();
 
     // Managers
     m_heroesManager.update(dt);
+    if (m_updateTimed) m_updateTimings.heroes += clock.restart();
     m_monstersManager.update(dt);
+    if (m_updateTimed) m_updateTimings.monsters += clock.restart();
     m_dynamicsManager.update(dt);
+    if (m_updateTimed) m_updateTimings.dynamics += clock.restart();
+}
+
+void Data::setUpdateTimed(bool updateTimed)
+{
+    m_updateTimed = updateTimed;
+    m_updateTimings = UpdateTimings();
 }
 
 //---------------------------//
@@ -86,6 +128,9 @@ std::wstring Data::load(const std::wstring& folder)
 {
     wdebug_dungeon_1(L"Loading data from folder " << folder);
 
+    // Do not read a file being written
+    waitSaves();
+
     context::villains.load();
     m_villain = context::villains.getFromWorldFolder(folder);
 
@@ -97,20 +142,21 @@ std::wstring Data::load(const std::wstring& folder)
     }
     else {
         uint walletsFactor = (context::worlds.selected().gamemode == context::Gamemode::RICHMAN)? 0u : 1u;
-        m_villain->doshWallet.setEvents(this, "dosh_changed");
+        m_villain->doshWallet.setEvents(this, events::doshChanged);
         m_villain->doshWallet.setFactor(walletsFactor);
-        m_villain->evilWallet.setEvents(this, "evil_changed");
+        m_villain->evilWallet.setEvents(this, events::evilChanged);
         m_villain->evilWallet.setFactor(walletsFactor);
         m_fameWallet.setFactor(walletsFactor);
         m_soulWallet.setFactor(walletsFactor);
     }
 
+    // The most recent save wins, whatever its format
     #if DEBUG_GLOBAL > 0
-        std::wstring mainDungeonFilename = L"saves/" + folder + L"dungeon_saved.xml";
+        std::wstring mainDungeonFilename = mostRecentFile({L"saves/" + folder + L"dungeon_saved.bin", L"saves/" + folder + L"dungeon_saved.xml"});
         if (!fileExists(mainDungeonFilename))
-            mainDungeonFilename = L"saves/" + folder + L"dungeon.xml";
+            mainDungeonFilename = mostRecentFile({L"saves/" + folder + L"dungeon.bin", L"saves/" + folder + L"dungeon.xml"});
     #else
-        std::wstring mainDungeonFilename = L"saves/" + folder + L"dungeon.xml";
+        std::wstring mainDungeonFilename = mostRecentFile({L"saves/" + folder + L"dungeon.bin", L"saves/" + folder + L"dungeon.xml"});
     #endif
 
     loadDungeon(mainDungeonFilename);
@@ -119,13 +165,11 @@ std::wstring Data::load(const std::wstring& folder)
 
 std::wstring Data::save(const std::wstring& folder)
 {
-    #if DEBUG_GLOBAL > 0
-        std::wstring mainDungeonFilename = L"saves/" + folder + L"dungeon_saved.xml";
-    #else
-        std::wstring mainDungeonFilename = L"saves/" + folder + L"dungeon.xml";
-    #endif
+    // Do not write a file being written
+    waitSaves();
 
-    saveDungeon(mainDungeonFilename);
+    auto mainDungeonFilename = saveFilename(folder);
+    saveDungeon(snapshot(), mainDungeonFilename);
 
     wdebug_dungeon_1(L"Saved data to folder " << folder);
 
@@ -134,17 +178,156 @@ std::wstring Data::save(const std::wstring& folder)
     return mainDungeonFilename;
 }
 
+std::wstring Data::saveAsync(const std::wstring& folder)
+{
+    auto mainDungeonFilename = saveFilename(folder);
+    auto pendingSnapshot = std::make_unique<Snapshot>(snapshot());
+
+    // Replace the previous pending snapshot if not written yet
+    {
+        std::lock_guard<std::mutex> lock(m_savesMutex);
+        m_pendingSnapshot = std::move(pendingSnapshot);
+        m_pendingFile = mainDungeonFilename;
+    }
+
+    if (!m_savesThread.joinable())
+        m_savesThread = std::thread(&Data::savesRoutine, this);
+    m_savesCondition.notify_all();
+
+    wdebug_dungeon_1(L"Saving data to folder " << folder << L" in background");
+
+    return mainDungeonFilename;
+}
+
+void Data::waitSaves()
+{
+    std::unique_lock<std::mutex> lock(m_savesMutex);
+    m_savesCondition.wait(lock, [this] { return m_pendingSnapshot == nullptr && !m_saving; });
+}
+
 void Data::createFiles(const std::wstring& folder)
 {
-    saveDungeon(L"saves/" + folder + L"dungeon.xml");
+    saveDungeon(snapshot(), L"saves/" + folder + L"dungeon.xml");
 
     wdebug_dungeon_1(L"Created data files to folder " << folder);
 }
 
+Data::Snapshot Data::snapshot() const
+{
+    Snapshot snapshot;
+
+    snapshot.name = m_name;
+    snapshot.time = m_time;
+    snapshot.floorsCount = m_floorsCount;
+    snapshot.floorRoomsCount = m_floorRoomsCount;
+
+    snapshot.soul = m_soulWallet.value();
+    snapshot.fame = m_fameWallet.value();
+    snapshot.debtPerWeek = m_debtPerWeek;
+    snapshot.debtWeeksLeft = m_debtWeeksLeft;
+
+    snapshot.floors = m_floors;
+    snapshot.trapsGenerics = m_trapsGenerics;
+    snapshot.monstersGenerics = m_monstersGenerics;
+    snapshot.heroes = m_heroesManager.snapshot();
+    snapshot.monsters = m_monstersManager.snapshot();
+    snapshot.dynamics = m_dynamicsManager.snapshot();
+
+    return snapshot;
+}
+
+uint64 Data::digest() const
+{
+    auto buffer = encodeDungeonBinary(snapshot());
+
+    // Villain wallets are not part of the dungeon save
+    BinaryWriter writer;
+    writer.write(static_cast<uint32>(doshWallet().value()));
+    writer.write(static_cast<uint32>(evilWallet().value()));
+    buffer += writer.buffer();
+
+    // FNV-1a
+    uint64 hash = 14695981039346656037ull;
+    for (auto byte : buffer) {
+        hash ^= static_cast<uint8>(byte);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::wstring Data::saveFilename(const std::wstring& folder) const
+{
+    std::wstring extension = m_binarySaves? L".bin" : L".xml";
+
+    #if DEBUG_GLOBAL > 0
+        return L"saves/" + folder + L"dungeon_saved" + extension;
+    #else
+        return L"saves/" + folder + L"dungeon" + extension;
+    #endif
+}
+
+std::wstring Data::mostRecentFile(const std::vector<std::wstring>& files) const
+{
+    std::wstring mostRecent = files.front();
+    uint64 mostRecentTime = 0u;
+
+    for (const auto& file : files) {
+        if (!fileExists(file)) continue;
+        auto time = fileModificationTime(toString(file));
+        if (time <= mostRecentTime) continue;
+        mostRecentTime = time;
+        mostRecent = file;
+    }
+
+    return mostRecent;
+}
+
+//------------------------------//
+//----- Dungeon management -----//
+
+void Data::loadDungeon(const std::wstring& file)
+{
+    if (fileExtension(toString(file)) == "bin") loadDungeonBinary(file);
+    else loadDungeonXML(file);
+
+    // Rooms invalidated before are meaningless now, the graph is to be fully rebuilt
+    if (m_graph != nullptr)
+        m_graph->invalidateAll();
+}
+
+void Data::saveDungeon(const Snapshot& snapshot, const std::wstring& file)
+{
+    if (fileExtension(toString(file)) == "bin") saveDungeonBinary(snapshot, file);
+    else saveDungeonXML(snapshot, file);
+}
+
+void Data::savesRoutine()
+{
+    std::unique_lock<std::mutex> lock(m_savesMutex);
+
+    while (true) {
+        m_savesCondition.wait(lock, [this] { return m_pendingSnapshot != nullptr || m_savesQuit; });
+        returnif (m_pendingSnapshot == nullptr);
+
+        auto snapshot = std::move(m_pendingSnapshot);
+        auto file = std::move(m_pendingFile);
+        m_saving = true;
+
+        // Encoding and writing without blocking the game
+        lock.unlock();
+        saveDungeon(*snapshot, file);
+        lock.lock();
+
+        m_saving = false;
+        m_savesCondition.notify_all();
+    }
+}
+
 //--------------------------//
 //----- XML management -----//
 
-void Data::loadDungeon(const std::wstring& file)
+void Data::loadDungeonXML(const std::wstring& file)
 {
     m_floors.clear();
 
@@ -285,10 +468,10 @@ void Data::loadDungeon(const std::wstring& file)
         }
     }
 
-    EventEmitter::addEvent("dungeon_changed");
+    EventEmitter::addEvent(events::dungeonChanged);
 }
 
-void Data::saveDungeon(const std::wstring& file)
+void Data::saveDungeonXML(const Snapshot& snapshot, const std::wstring& file)
 {
     // Creating XML
     pugi::xml_document doc;
@@ -296,35 +479,35 @@ void Data::saveDungeon(const std::wstring& file)
 
     //---- Dungeon
 
-    dungeon.append_attribute(L"name") = m_name.c_str();
-    dungeon.append_attribute(L"time") = m_time;
-    dungeon.append_attribute(L"floorsCount") = m_floorsCount;
-    dungeon.append_attribute(L"floorRoomsCount") = m_floorRoomsCount;
+    dungeon.append_attribute(L"name") = snapshot.name.c_str();
+    dungeon.append_attribute(L"time") = snapshot.time;
+    dungeon.append_attribute(L"floorsCount") = snapshot.floorsCount;
+    dungeon.append_attribute(L"floorRoomsCount") = snapshot.floorRoomsCount;
 
     //---- Resources
 
     auto resourcesNode = dungeon.append_child(L"resources");
-    resourcesNode.append_child(L"soul").append_attribute(L"value") = m_soulWallet.value();
-    resourcesNode.append_child(L"fame").append_attribute(L"value") = m_fameWallet.value();
+    resourcesNode.append_child(L"soul").append_attribute(L"value") = snapshot.soul;
+    resourcesNode.append_child(L"fame").append_attribute(L"value") = snapshot.fame;
     auto debtNode = resourcesNode.append_child(L"debt");
-    debtNode.append_attribute(L"perWeekDosh") = m_debtPerWeek;
-    debtNode.append_attribute(L"weeksLeft") = m_debtWeeksLeft;
+    debtNode.append_attribute(L"perWeekDosh") = snapshot.debtPerWeek;
+    debtNode.append_attribute(L"weeksLeft") = snapshot.debtWeeksLeft;
 
     //---- Dynamics
 
     auto dynamicsNode = dungeon.append_child(L"dynamics");
-    m_dynamicsManager.save(dynamicsNode);
+    DynamicsManager::save(snapshot.dynamics, dynamicsNode);
 
     //---- Heroes
 
     auto heroesNode = dungeon.append_child(L"heroes");
-    m_heroesManager.save(heroesNode);
+    HeroesManager::save(snapshot.heroes, heroesNode);
 
     //---- Monsters
 
     // Generics
     auto monstersGenericsNode = dungeon.append_child(L"monstersGenerics");
-    for (const auto& monsterGenericPair : m_monstersGenerics) {
+    for (const auto& monsterGenericPair : snapshot.monstersGenerics) {
         auto monsterGenericNode = monstersGenericsNode.append_child(monsterGenericPair.first.c_str());
         monsterGenericNode.append_attribute(L"unlocked") = monsterGenericPair.second.unlocked;
         monsterGenericNode.append_attribute(L"reserve") = monsterGenericPair.second.reserve;
@@ -333,12 +516,12 @@ void Data::saveDungeon(const std::wstring& file)
 
     // Active
     auto monstersNode = dungeon.append_child(L"monsters");
-    m_monstersManager.save(monstersNode);
+    MonstersManager::save(snapshot.monsters, monstersNode);
 
     //---- Traps
 
     auto trapsGenericsNode = dungeon.append_child(L"trapsGenerics");
-    for (const auto& trapGenericPair : m_trapsGenerics) {
+    for (const auto& trapGenericPair : snapshot.trapsGenerics) {
         auto trapGenericNode = trapsGenericsNode.append_child(trapGenericPair.first.c_str());
         trapGenericNode.append_attribute(L"unlocked") = trapGenericPair.second.unlocked;
     }
@@ -346,14 +529,14 @@ void Data::saveDungeon(const std::wstring& file)
     //---- Structure
 
     // Floors
-    for (uint floorPos = 0; floorPos < m_floors.size(); ++floorPos) {
+    for (uint floorPos = 0; floorPos < snapshot.floors.size(); ++floorPos) {
         mdebug_dungeon_2("Saving floor " << floorPos);
         auto floor = dungeon.append_child(L"floor");
         floor.append_attribute(L"pos") = floorPos;
 
         // Rooms
-        for (uint roomPos = 0; roomPos < m_floors[floorPos].rooms.size(); ++roomPos) {
-            auto room = m_floors[floorPos].rooms[roomPos];
+        for (uint roomPos = 0; roomPos < snapshot.floors[floorPos].rooms.size(); ++roomPos) {
+            const auto& room = snapshot.floors[floorPos].rooms[roomPos];
 
             mdebug_dungeon_3("Saving room " << roomPos);
             auto roomNode = floor.append_child(L"room");
@@ -401,7 +584,312 @@ void Data::saveDungeon(const std::wstring& file)
         }
     }
 
-    doc.save_file(file.c_str());
+    // Written aside first, so that a crash never leaves a partial file
+    auto tmpFile = file + L".tmp";
+    if (!doc.save_file(tmpFile.c_str()) || !fileReplace(toString(tmpFile), toString(file)))
+        std::wcerr << L"/!\\ Cannot save dungeon to " << file << L"." << std::endl;
+}
+
+//-----------------------------//
+//----- Binary management -----//
+
+namespace
+{
+    //! Identifies a binary dungeon file.
+    constexpr const char* binaryMagic = "EEVD";
+
+    //! Incremented on incompatible changes, new data should rather go into new chunks.
+    constexpr uint16 binaryVersion = 1u;
+}
+
+void Data::loadDungeonBinary(const std::wstring& file)
+{
+    m_floors.clear();
+
+    // Reading the whole file, parsing is then done in memory
+    std::ifstream stream(toString(file), std::ios::binary);
+    std::string buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    BinaryReader reader(buffer.data(), buffer.size());
+    bool validMagic = reader.expectBytes(binaryMagic, 4u);
+    uint version = reader.readUint16();
+    if (!validMagic || reader.failed() || version != binaryVersion)
+        mquit("File " + toString(file) + " is not a valid dungeon file.");
+
+    // Generics not present in the file keep default values
+    m_monstersGenerics.clear();
+    for (const auto& monsterData : m_monstersDB.get())
+        m_monstersGenerics[monsterData.first].common = &monsterData.second;
+
+    m_trapsGenerics.clear();
+    for (const auto& trapData : m_trapsDB.get())
+        m_trapsGenerics[trapData.first].common = &trapData.second;
+
+    // Unknown chunks are skipped
+    for (const auto& chunk : reader.readChunks()) {
+        BinaryReader chunkReader(chunk);
+
+        //---- Dungeon
+
+        if (chunk.tag == "DUNG") {
+            m_name = chunkReader.readWString();
+            m_time = chunkReader.readUint32();
+            m_floorsCount = chunkReader.readUint32();
+            m_floorRoomsCount = chunkReader.readUint32();
+            m_soulWallet.set(chunkReader.readUint32());
+            m_fameWallet.set(chunkReader.readUint32());
+            m_debtPerWeek = chunkReader.readUint32();
+            m_debtWeeksLeft = chunkReader.readUint32();
+            wdebug_dungeon_1(L"Dungeon is " << m_name << L" of size " << m_floorsCount << L"x" << m_floorRoomsCount << L".");
+            m_floors.reserve(m_floorsCount);
+        }
+
+        //---- Elements
+
+        else if (chunk.tag == "DYNA") m_dynamicsManager.loadBinary(chunkReader);
+        else if (chunk.tag == "HERO") m_heroesManager.loadBinary(chunkReader);
+        else if (chunk.tag == "MONS") m_monstersManager.loadBinary(chunkReader);
+
+        //---- Generics
+
+        else if (chunk.tag == "MONG") {
+            uint monstersGenericsCount = chunkReader.readUint32();
+            for (uint i = 0u; i < monstersGenericsCount && !chunkReader.failed(); ++i) {
+                auto monsterID = chunkReader.readWString();
+                MonsterGeneric monsterGeneric;
+                monsterGeneric.unlocked = chunkReader.readBool();
+                monsterGeneric.reserve = chunkReader.readUint32();
+                monsterGeneric.countdown = chunkReader.readUint32();
+
+                // Monster no longer in the database
+                auto found = m_monstersGenerics.find(monsterID);
+                if (found == std::end(m_monstersGenerics)) continue;
+                monsterGeneric.common = found->second.common;
+                found->second = monsterGeneric;
+            }
+        }
+        else if (chunk.tag == "TRAG") {
+            uint trapsGenericsCount = chunkReader.readUint32();
+            for (uint i = 0u; i < trapsGenericsCount && !chunkReader.failed(); ++i) {
+                auto trapID = chunkReader.readWString();
+                bool unlocked = chunkReader.readBool();
+
+                auto found = m_trapsGenerics.find(trapID);
+                if (found == std::end(m_trapsGenerics)) continue;
+                found->second.unlocked = unlocked;
+            }
+        }
+
+        //---- Structure
+
+        else if (chunk.tag == "FLOR") {
+            uint floorPos = chunkReader.readUint32();
+
+            // Floors are saved in order, and never more than announced
+            if (floorPos != m_floors.size() || floorPos >= m_floorsCount)
+                mquit("File " + toString(file) + " has floor " + std::to_string(floorPos) + " out of order.");
+
+            m_floors.emplace_back();
+            auto& floor = m_floors.back();
+            floor.pos = floorPos;
+            mdebug_dungeon_2("Found floor " << floorPos);
+
+            // Rooms, all of them are saved
+            uint roomsCount = chunkReader.readUint32();
+            if (roomsCount != m_floorRoomsCount)
+                mquit("File " + toString(file) + " has floor " + std::to_string(floorPos) + " with " + std::to_string(roomsCount)
+                      + " rooms instead of " + std::to_string(m_floorRoomsCount) + ".");
+            floor.rooms.reserve(roomsCount);
+            for (uint r = 0u; r < roomsCount && !chunkReader.failed(); ++r) {
+                Room room;
+                room.coords.x = floorPos;
+                room.coords.y = chunkReader.readUint8();
+                room.state = static_cast<RoomState>(chunkReader.readUint8());
+
+                // Trap
+                auto& trap = room.trap;
+                trap.data.loadBinary(chunkReader);
+                if (trap.data.exists()) {
+                    trap.barrier = chunkReader.readBool();
+                    trap.common = &trapsDB().get(trap.data.type());
+                }
+
+                // Facilities
+                uint facilitiesCount = chunkReader.readUint16();
+                room.facilities.reserve(facilitiesCount);
+                for (uint f = 0u; f < facilitiesCount && !chunkReader.failed(); ++f) {
+                    room.facilities.emplace_back();
+                    auto& facility = room.facilities.back();
+                    facility.coords = room.coords;
+                    facility.data.loadBinary(chunkReader);
+                    facility.stronglyLinked = chunkReader.readBool();
+                    facility.barrier = chunkReader.readBool();
+                    facility.treasure = chunkReader.readUint32();
+                    facility.common = &facilitiesDB().get(facility.data.type());
+                    room.hide |= facility.common->hide;
+
+                    // Tunnels
+                    uint tunnelsCount = chunkReader.readUint16();
+                    for (uint t = 0u; t < tunnelsCount && !chunkReader.failed(); ++t) {
+                        Tunnel tunnel;
+                        tunnel.coords.x = chunkReader.readInt32();
+                        tunnel.coords.y = chunkReader.readInt32();
+                        tunnel.relative = chunkReader.readBool();
+                        facility.tunnels.emplace_back(std::move(tunnel));
+                    }
+
+                    // Links
+                    uint linksCount = chunkReader.readUint16();
+                    for (uint l = 0u; l < linksCount && !chunkReader.failed(); ++l) {
+                        FacilityLink link;
+                        bool hasCommon = chunkReader.readBool();
+                        uint linkID = chunkReader.readUint32();
+                        link.coords.x = chunkReader.readUint8();
+                        link.coords.y = chunkReader.readUint8();
+                        link.relink = chunkReader.readBool();
+                        if (hasCommon) link.common = facility.common->linkFind(linkID);
+                        facility.links.emplace_back(std::move(link));
+                    }
+                }
+
+                // Add the room
+                floor.rooms.emplace_back(std::move(room));
+            }
+        }
+
+        if (chunkReader.failed())
+            mquit("File " + toString(file) + " has a corrupted '" + chunk.tag + "' chunk.");
+    }
+
+    if (reader.failed())
+        mquit("File " + toString(file) + " is truncated.");
+
+    EventEmitter::addEvent(events::dungeonChanged);
+}
+
+void Data::saveDungeonBinary(const Snapshot& snapshot, const std::wstring& file)
+{
+    auto buffer = encodeDungeonBinary(snapshot);
+
+    // Written aside first, so that a crash never leaves a partial file
+    auto tmpFile = toString(file + L".tmp");
+    {
+        std::ofstream stream(tmpFile, std::ios::binary);
+        stream.write(buffer.data(), buffer.size());
+        if (!stream.good()) tmpFile.clear();
+    }
+
+    if (tmpFile.empty() || !fileReplace(tmpFile, toString(file)))
+        std::wcerr << L"/!\\ Cannot save dungeon to " << file << L"." << std::endl;
+}
+
+std::string Data::encodeDungeonBinary(const Snapshot& snapshot)
+{
+    BinaryWriter writer;
+    writer.writeBytes(binaryMagic, 4u);
+    writer.write(binaryVersion);
+
+    //---- Dungeon
+
+    auto chunk = writer.beginChunk("DUNG");
+    writer.write(snapshot.name);
+    writer.write(static_cast<uint32>(snapshot.time));
+    writer.write(static_cast<uint32>(snapshot.floorsCount));
+    writer.write(static_cast<uint32>(snapshot.floorRoomsCount));
+    writer.write(static_cast<uint32>(snapshot.soul));
+    writer.write(static_cast<uint32>(snapshot.fame));
+    writer.write(static_cast<uint32>(snapshot.debtPerWeek));
+    writer.write(static_cast<uint32>(snapshot.debtWeeksLeft));
+    writer.endChunk(chunk);
+
+    //---- Elements
+
+    chunk = writer.beginChunk("DYNA");
+    DynamicsManager::saveBinary(snapshot.dynamics, writer);
+    writer.endChunk(chunk);
+
+    chunk = writer.beginChunk("HERO");
+    HeroesManager::saveBinary(snapshot.heroes, writer);
+    writer.endChunk(chunk);
+
+    chunk = writer.beginChunk("MONS");
+    MonstersManager::saveBinary(snapshot.monsters, writer);
+    writer.endChunk(chunk);
+
+    //---- Generics
+
+    chunk = writer.beginChunk("MONG");
+    writer.write(static_cast<uint32>(snapshot.monstersGenerics.size()));
+    for (const auto& monsterGenericPair : snapshot.monstersGenerics) {
+        writer.write(monsterGenericPair.first);
+        writer.write(monsterGenericPair.second.unlocked);
+        writer.write(static_cast<uint32>(monsterGenericPair.second.reserve));
+        writer.write(static_cast<uint32>(monsterGenericPair.second.countdown));
+    }
+    writer.endChunk(chunk);
+
+    chunk = writer.beginChunk("TRAG");
+    writer.write(static_cast<uint32>(snapshot.trapsGenerics.size()));
+    for (const auto& trapGenericPair : snapshot.trapsGenerics) {
+        writer.write(trapGenericPair.first);
+        writer.write(trapGenericPair.second.unlocked);
+    }
+    writer.endChunk(chunk);
+
+    //---- Structure
+
+    // One chunk per floor
+    for (uint floorPos = 0u; floorPos < snapshot.floors.size(); ++floorPos) {
+        mdebug_dungeon_2("Saving floor " << floorPos);
+        const auto& rooms = snapshot.floors[floorPos].rooms;
+
+        chunk = writer.beginChunk("FLOR");
+        writer.write(static_cast<uint32>(floorPos));
+        writer.write(static_cast<uint32>(rooms.size()));
+
+        // Rooms
+        for (uint roomPos = 0u; roomPos < rooms.size(); ++roomPos) {
+            const auto& room = rooms[roomPos];
+            writer.write(static_cast<uint8>(roomPos));
+            writer.write(static_cast<uint8>(room.state));
+
+            // Trap
+            room.trap.data.saveBinary(writer);
+            if (room.trap.data.exists())
+                writer.write(room.trap.barrier);
+
+            // Facilities
+            writer.write(static_cast<uint16>(room.facilities.size()));
+            for (const auto& facility : room.facilities) {
+                facility.data.saveBinary(writer);
+                writer.write(facility.stronglyLinked);
+                writer.write(facility.barrier);
+                writer.write(static_cast<uint32>(facility.treasure));
+
+                // Tunnels
+                writer.write(static_cast<uint16>(facility.tunnels.size()));
+                for (const auto& tunnel : facility.tunnels) {
+                    writer.write(static_cast<int32>(tunnel.coords.x));
+                    writer.write(static_cast<int32>(tunnel.coords.y));
+                    writer.write(tunnel.relative);
+                }
+
+                // Links
+                writer.write(static_cast<uint16>(facility.links.size()));
+                for (const auto& link : facility.links) {
+                    writer.write(link.common != nullptr);
+                    writer.write(static_cast<uint32>((link.common != nullptr)? link.common->id : -1u));
+                    writer.write(link.coords.x);
+                    writer.write(link.coords.y);
+                    writer.write(link.relink);
+                }
+            }
+        }
+
+        writer.endChunk(chunk);
+    }
+
+    return writer.buffer();
 }
 
 //---------------------------//
@@ -428,18 +916,24 @@ void Data::correctFloorsRooms()
         }
     }
 
-    EventEmitter::addEvent("dungeon_structure_changed", true);
+    EventEmitter::addEvent(events::dungeonStructureChanged, true);
 }
 
 //-------------------//
 //----- Emitter -----//
 
-void Data::addEvent(std::string eventType, const RoomCoords& coords)
+void Data::addEvent(context::EventID eventType, const RoomCoords& coords)
 {
-    auto event = std::make_unique<Event>();
-    event->type = std::move(eventType);
-    event->room = {coords.x, coords.y};
-    EventEmitter::addEvent(std::move(event));
+    // The graph will update only these rooms on the next dungeon change
+    if (m_graph != nullptr && (eventType == events::roomConstructed || eventType == events::roomDestroyed
+                               || eventType == events::roomChanged || eventType == events::facilityChanged
+                               || eventType == events::trapChanged))
+        m_graph->invalidateRoom(coords);
+
+    Event event;
+    event.type = eventType;
+    event.room = {coords.x, coords.y};
+    EventEmitter::addEvent(event);
 }
 
 //-----------------//
@@ -477,8 +971,8 @@ void Data::constructRoom(const RoomCoords& coords)
     room(coords).state = RoomState::CONSTRUCTED;
     roomLinksIncomingStrongRecreateFacilities(coords);
 
-    addEvent("room_constructed", coords);
-    EventEmitter::addEvent("dungeon_changed");
+    addEvent(events::roomConstructed, coords);
+    EventEmitter::addEvent(events::dungeonChanged);
 }
 
 void Data::constructRoomsAll()
@@ -500,8 +994,8 @@ void Data::destroyRoom(const RoomCoords& coords)
     // Destroy the room
     room(coords).state = RoomState::EMPTY;
 
-    addEvent("room_destroyed", coords);
-    EventEmitter::addEvent("dungeon_changed");
+    addEvent(events::roomDestroyed, coords);
+    EventEmitter::addEvent(events::dungeonChanged);
 
     updateRoomHide(coords);
 }
@@ -545,7 +1039,7 @@ bool Data::pushRoom(const RoomCoords& coords, Direction direction)
         // Create the new links
         roomLinksIncomingStrongRecreateFacilities(targetCoords);
         roomLinksStrongRecreateFacilities(targetCoords);
-        addEvent("room_changed", targetCoords);
+        addEvent(events::roomChanged, targetCoords);
 
         // Note: It is not our job to move the moving elements (monsters/heroes)
         // We let inter and the managers handle that
@@ -555,7 +1049,7 @@ bool Data::pushRoom(const RoomCoords& coords, Direction direction)
     // Clean the starting room
     destroyRoom(coords);
 
-    EventEmitter::addEvent("dungeon_changed");
+    EventEmitter::addEvent(events::dungeonChanged);
 
     return true;
 }
@@ -579,7 +1073,7 @@ uint Data::stealRoomTreasure(const RoomCoords& coords, uint wantedDosh)
             break;
     }
 
-    addEvent("facility_changed", coords);
+    addEvent(events::facilityChanged, coords);
 
     return stolenDosh;
 }
@@ -630,7 +1124,7 @@ void Data::updateRoomHide(const RoomCoords& coords)
     // Send an event if changed
     returnif (roomInfo.hide == newHide);
     roomInfo.hide = newHide;
-    addEvent("room_hide_changed", coords);
+    addEvent(events::roomHideChanged, coords);
 }
 
 uint8 Data::roomLock(const RoomCoords& coords, bool withPermissive, bool withTrap) const
@@ -702,12 +1196,12 @@ bool Data::facilitiesCreate(const RoomCoords& coords, const std::wstring& facili
     // Note: This event needs to be before the permissive removals,
     //       so that it is correctly queued for dungeon::Inter
     //       (fixing a bug where the lua of ladder was not aware of the ladderExit removal)
-    addEvent("facility_changed", coords);
+    addEvent(events::facilityChanged, coords);
 
     // Send the warnings
     // TODO Make a specific event for the warnings?
     const auto& warnings = facilityData.warnings;
-    warningsSend(warnings, coords, "facility_changed");
+    warningsSend(warnings, coords, events::facilityChanged);
 
     // Remove permissive facilities that are in the way
     facilitiesPermissiveRemoveLocking(coords, facilityData.lock);
@@ -720,7 +1214,7 @@ bool Data::facilitiesCreate(const RoomCoords& coords, const std::wstring& facili
     facility.coords = coords;
 
     if (facility.common->entrance)
-        EventEmitter::addEvent("dungeon_changed");
+        EventEmitter::addEvent(events::dungeonChanged);
 
     updateRoomHide(coords);
 
@@ -738,7 +1232,7 @@ void Data::facilitiesRemove(const RoomCoords& coords, const std::wstring& facili
 
     // Note: This event needs to be before the incoming removals,
     //       so that it is correctly queued for dungeon::Inter
-    addEvent("facility_changed", coords);
+    addEvent(events::facilityChanged, coords);
 
     auto pFacility = std::find_if(roomInfo.facilities, [facilityID] (const FacilityInfo& facilityInfo) { return facilityInfo.data.type() == facilityID; });
     returnif (pFacility == std::end(roomInfo.facilities));
@@ -746,7 +1240,7 @@ void Data::facilitiesRemove(const RoomCoords& coords, const std::wstring& facili
 
     // Send the warnings
     const auto& warnings = pFacility->common->warnings;
-    warningsSend(warnings, coords, "facility_changed");
+    warningsSend(warnings, coords, events::facilityChanged);
 
     // Event checking
     bool dungeonChanged = pFacility->common->entrance;
@@ -755,8 +1249,8 @@ void Data::facilitiesRemove(const RoomCoords& coords, const std::wstring& facili
 
     bool treasureChanged = pFacility->treasure != -1u;
 
-    if (dungeonChanged)     EventEmitter::addEvent("dungeon_changed");
-    if (treasureChanged)    addEvent("treasure_changed", coords);
+    if (dungeonChanged)     EventEmitter::addEvent(events::dungeonChanged);
+    if (treasureChanged)    addEvent(events::treasureChanged, coords);
 
     // Complete removal
     facilityLinksIncomingRemove(coords, facilityID);
@@ -801,7 +1295,7 @@ void Data::facilitiesPermissiveRemoveLocking(const RoomCoords& coords, uint8 loc
 
 //----- Warnings
 
-void Data::warningsSend(const std::vector<Warning>& warnings, const RoomCoords& coords, const std::string& eventType)
+void Data::warningsSend(const std::vector<Warning>& warnings, const RoomCoords& coords, context::EventID eventType)
 {
     for (const auto& warning : warnings) {
         RoomCoords warningCoords{sf::v2u8(warning.coords)};
@@ -828,7 +1322,7 @@ void Data::facilityLinksAdd(FacilityInfo& facilityInfo, const Link* common, cons
     link.coords = linkCoords;
     link.relink = relink;
     if (common != nullptr) link.id = common->id;
-    addEvent("facility_changed", facilityInfo.coords);
+    addEvent(events::facilityChanged, facilityInfo.coords);
 }
 
 void Data::facilityLinkRedirect(FacilityInfo& facilityInfo, const uint8 id, const RoomCoords& linkCoords)
@@ -836,7 +1330,7 @@ void Data::facilityLinkRedirect(FacilityInfo& facilityInfo, const uint8 id, cons
     for (auto& link : facilityInfo.links) {
         if (link.id != id) continue;
         link.coords = linkCoords;
-        addEvent("facility_changed", facilityInfo.coords);
+        addEvent(events::facilityChanged, facilityInfo.coords);
         return;
     }
 }
@@ -852,7 +1346,7 @@ void Data::facilityLinkLastSetID(FacilityInfo& facilityInfo, uint8 id)
 {
     auto& link = facilityInfo.links.back();
     link.id = id;
-    addEvent("facility_changed", facilityInfo.coords);
+    addEvent(events::facilityChanged, facilityInfo.coords);
 }
 
 void Data::facilityLinksRemove(const RoomCoords& coords, const std::wstring& facilityID, const RoomCoords& linkCoords, const std::wstring& linkFacilityID)
@@ -866,7 +1360,7 @@ void Data::facilityLinksRemove(FacilityInfo& facilityInfo, const RoomCoords& lin
 {
     std::erase_if(facilityInfo.links, [&linkCoords, &linkFacilityID] (const FacilityLink& link)
                   { return link.coords == linkCoords && link.common->facilityID == linkFacilityID; });
-    addEvent("facility_changed", facilityInfo.coords);
+    addEvent(events::facilityChanged, facilityInfo.coords);
 }
 
 void Data::facilityLinksRemove(FacilityInfo& facilityInfo, uint8 id)
@@ -879,7 +1373,7 @@ void Data::facilityLinksRemove(FacilityInfo& facilityInfo, uint8 id)
         facilityLinksRemove(iLink->coords, iLink->common->facilityID, facilityInfo.coords, facilityInfo.data.type());
 
     facilityInfo.links.erase(iLink);
-    addEvent("facility_changed", facilityInfo.coords);
+    addEvent(events::facilityChanged, facilityInfo.coords);
 }
 
 void Data::facilityLinksStrongRemoveFacilities(FacilityInfo& facilityInfo)
@@ -994,7 +1488,7 @@ void Data::roomLinksIncomingRemove(const RoomCoords& coords)
         auto newEnd = std::remove_if(std::begin(links), std::end(links), [&coords] (const FacilityLink& link) { return link.coords == coords; });
         if (newEnd != std::end(facility.links)) {
             facility.links.erase(newEnd, std::end(facility.links));
-            addEvent("facility_changed", facility.coords);
+            addEvent(events::facilityChanged, facility.coords);
         }
     }
 }
@@ -1013,7 +1507,7 @@ void Data::roomLinksBreakableRemove(const RoomCoords& coords)
     }
 
     if (facilitiesChanged)
-        addEvent("facility_changed", coords);
+        addEvent(events::facilityChanged, coords);
 }
 
 //----- Barrier
@@ -1024,8 +1518,8 @@ void Data::setRoomFacilityBarrier(const RoomCoords& coords, const std::wstring&
     returnif (pFacilityInfo == nullptr);
 
     pFacilityInfo->barrier = activated;
-    addEvent("facility_changed", coords);
-    EventEmitter::addEvent("dungeon_changed");
+    addEvent(events::facilityChanged, coords);
+    EventEmitter::addEvent(events::dungeonChanged);
 }
 
 //----- Treasure
@@ -1036,7 +1530,7 @@ void Data::setRoomFacilityTreasure(const RoomCoords& coords, const std::wstring&
     returnif (pFacilityInfo == nullptr);
 
     pFacilityInfo->treasure = amount;
-    addEvent("treasure_changed", coords);
+    addEvent(events::treasureChanged, coords);
 }
 
 //----- Tunnels
@@ -1047,7 +1541,8 @@ void Data::addFacilityTunnel(FacilityInfo& facilityInfo, const sf::Vector2i& tun
     tunnel.coords = tunnelCoords;
     tunnel.relative = relative;
     facilityInfo.tunnels.emplace_back(std::move(tunnel));
-    EventEmitter::addEvent("dungeon_changed");
+    addEvent(events::facilityChanged, facilityInfo.coords);
+    EventEmitter::addEvent(events::dungeonChanged);
 }
 
 //-----------------//
@@ -1084,7 +1579,7 @@ void Data::setRoomTrap(const RoomCoords& coords, const std::wstring& trapID)
 
     // Note: This event needs to be before the permissive removals,
     //       so that it is correctly queued for Inter.
-    addEvent("trap_changed", coords);
+    addEvent(events::trapChanged, coords);
 
     // Remove permissive facilities that are in the way
     auto& trapData = m_trapsDB.get(trapID);
@@ -1113,7 +1608,7 @@ void Data::removeRoomTrap(const RoomCoords& coords)
     // Some strongly linked facilities might be able to be recreated
     roomLinksIncomingStrongRecreateFacilities(coords);
 
-    addEvent("trap_changed", coords);
+    addEvent(events::trapChanged, coords);
 }
 
 void Data::setRoomTrapBarrier(const RoomCoords& coords, bool activated)
@@ -1122,21 +1617,21 @@ void Data::setRoomTrapBarrier(const RoomCoords& coords, bool activated)
     returnif (!roomInfo.trap.data.exists());
 
     roomInfo.trap.barrier = activated;
-    addEvent("trap_changed", coords);
-    EventEmitter::addEvent("dungeon_changed");
+    addEvent(events::trapChanged, coords);
+    EventEmitter::addEvent(events::dungeonChanged);
 }
 
 void Data::setTrapsGenericUnlocked(bool unlocked)
 {
     for (auto& trapInfoPair : m_trapsGenerics)
         trapInfoPair.second.unlocked = unlocked;
-    EventEmitter::addEvent("trap_generic_changed");
+    EventEmitter::addEvent(events::trapGenericChanged);
 }
 
 void Data::setTrapGenericUnlocked(const std::wstring& trapID, bool unlocked)
 {
     m_trapsGenerics[trapID].unlocked = unlocked;
-    EventEmitter::addEvent("trap_generic_changed");
+    EventEmitter::addEvent(events::trapGenericChanged);
 }
 
 //--------------------//
@@ -1164,18 +1659,17 @@ void Data::addMonsterToReserve(const std::wstring& monsterID, const uint countdo
     // Reserve
     monsterGenericPair->second.reserve += 1u;
 
-    auto event = std::make_unique<Event>();
-    event->type = "monster_added";
-    event->monster.id = monsterGenericPair->first.c_str();
-    EventEmitter::addEvent(std::move(event));
+    Event event;
+    event.type = events::monsterAdded;
+    event.monster.id = monsterGenericPair->first.c_str();
+    EventEmitter::addEvent(event);
 
     // Increase the countdown
     monsterGenericPair->second.countdown += countdownIncrease;
 
-    event = std::make_unique<Event>();
-    event->type = "reserve_countdown_changed";
-    event->monster.id = monsterGenericPair->first.c_str();
-    EventEmitter::addEvent(std::move(event));
+    event.type = events::reserveCountdownChanged;
+    event.monster.id = monsterGenericPair->first.c_str();
+    EventEmitter::addEvent(event);
 }
 
 void Data::moveMonsterFromReserve(const RoomCoords& coords, const std::wstring& monsterID)
@@ -1189,31 +1683,30 @@ void Data::moveMonsterFromReserve(const RoomCoords& coords, const std::wstring&
     // Add the monster
     m_monstersManager.addRoomMonster(coords, monsterID);
 
-    auto event = std::make_unique<Event>();
-    event->type = "monster_added";
-    event->monster.id = monsterGenericPair->first.c_str();
-    EventEmitter::addEvent(std::move(event));
+    Event event;
+    event.type = events::monsterAdded;
+    event.monster.id = monsterGenericPair->first.c_str();
+    EventEmitter::addEvent(event);
 
     // Reserve
     monsterGenericPair->second.reserve -= 1u;
 
-    event = std::make_unique<Event>();
-    event->type = "reserve_countdown_changed";
-    event->monster.id = monsterGenericPair->first.c_str();
-    EventEmitter::addEvent(std::move(event));
+    event.type = events::reserveCountdownChanged;
+    event.monster.id = monsterGenericPair->first.c_str();
+    EventEmitter::addEvent(event);
 }
 
 void Data::setMonstersGenericUnlocked(bool unlocked)
 {
     for (auto& monsterInfoPair : m_monstersGenerics)
         monsterInfoPair.second.unlocked = unlocked;
-    EventEmitter::addEvent("monster_generic_changed");
+    EventEmitter::addEvent(events::monsterGenericChanged);
 }
 
 void Data::setMonsterGenericUnlocked(const std::wstring& monsterID, bool unlocked)
 {
     m_monstersGenerics[monsterID].unlocked = unlocked;
-    EventEmitter::addEvent("monster_generic_changed");
+    EventEmitter::addEvent(events::monsterGenericChanged);
 }
 
 //---------------------//
@@ -0,0 +1,329 @@
+#include "dungeon/detectcondition.hpp"
+
+#include "dungeon/detectentity.hpp"
+#include "dungeon/elements/elementdata.hpp"
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace dungeon;
+
+namespace
+{
+    //! The index of the room containing the coordinate, all being in the same room if the size is not set.
+    inline int32 roomIndex(float coordinate, float roomSize)
+    {
+        returnif (roomSize <= 0.f) 0;
+        return static_cast<int32>(std::floor(coordinate / roomSize));
+    }
+
+    //! How many results the evaluation stack can hold, one bit each.
+    constexpr uint s_stackSize = 64u;
+}
+
+//-----------------------//
+//----- Compilation -----//
+
+bool DetectCondition::compile(const std::string& condition)
+{
+    m_program.clear();
+    m_keys.clear();
+    m_range = -1.f;
+    m_error.clear();
+    m_token = 0u;
+
+    bool ok = tokenize(condition) && parseOr();
+    if (ok && m_token < m_tokens.size())
+        ok = fail("Unexpected '" + m_tokens[m_token].text + "'");
+    m_tokens.clear();
+
+    // Range bound and stack depth, simulating the program
+    std::vector<float> ranges;
+    const auto unbounded = std::numeric_limits<float>::infinity();
+    for (const auto& instruction : m_program) {
+        if (!ok) break;
+
+        switch (instruction.opcode) {
+        case Opcode::DISTANCE:
+            if (instruction.comparison == Comparison::LESS || instruction.comparison == Comparison::LESS_EQUAL)
+                ranges.emplace_back(std::max(instruction.value, 0.f));
+            else
+                ranges.emplace_back(unbounded);
+            break;
+
+        case Opcode::SAME_ROOM:
+        case Opcode::SAME_FLOOR:
+        case Opcode::KEY:
+        case Opcode::DATA:
+            ranges.emplace_back(unbounded);
+            break;
+
+        case Opcode::NOT:
+            ranges.back() = unbounded;
+            break;
+
+        case Opcode::AND:
+            ranges[ranges.size() - 2u] = std::min(ranges[ranges.size() - 2u], ranges.back());
+            ranges.pop_back();
+            break;
+
+        case Opcode::OR:
+            ranges[ranges.size() - 2u] = std::max(ranges[ranges.size() - 2u], ranges.back());
+            ranges.pop_back();
+            break;
+        }
+
+        if (ranges.size() > s_stackSize)
+            ok = fail("Too many nested conditions");
+    }
+
+    if (!ok) {
+        m_program.clear();
+        return false;
+    }
+
+    m_range = (ranges.back() == unbounded)? -1.f : ranges.back();
+    return true;
+}
+
+//-------------------//
+//----- Parsing -----//
+
+bool DetectCondition::tokenize(const std::string& condition)
+{
+    m_tokens.clear();
+
+    for (uint i = 0u; i < condition.size();) {
+        const auto c = condition[i];
+
+        // Spaces
+        if (std::isspace(c)) {
+            ++i;
+            continue;
+        }
+
+        Token token;
+
+        // Numbers
+        if (std::isdigit(c) || ((c == '-' || c == '.') && i + 1u < condition.size() && std::isdigit(condition[i + 1u]))) {
+            token.number = true;
+            do token.text += condition[i++];
+            while (i < condition.size() && (std::isdigit(condition[i]) || condition[i] == '.'));
+        }
+        // Identifiers
+        else if (std::isalpha(c) || c == '_') {
+            do token.text += condition[i++];
+            while (i < condition.size() && (std::isalnum(condition[i]) || condition[i] == '_' || condition[i] == '.'));
+        }
+        // Operators
+        else if ((c == '<' || c == '>' || c == '=' || c == '!') && i + 1u < condition.size() && condition[i + 1u] == '=') {
+            token.text = condition.substr(i, 2u);
+            i += 2u;
+        }
+        else if (c == '<' || c == '>' || c == '(' || c == ')') {
+            token.text = c;
+            ++i;
+        }
+        else {
+            return fail(std::string("Unexpected character '") + c + "'");
+        }
+
+        m_tokens.emplace_back(std::move(token));
+    }
+
+    return true;
+}
+
+bool DetectCondition::parseOr()
+{
+    returnif (!parseAnd()) false;
+
+    while (m_token < m_tokens.size() && m_tokens[m_token].text == "or") {
+        ++m_token;
+        returnif (!parseAnd()) false;
+        m_program.push_back({Opcode::OR});
+    }
+
+    return true;
+}
+
+bool DetectCondition::parseAnd()
+{
+    returnif (!parseUnary()) false;
+
+    while (m_token < m_tokens.size() && m_tokens[m_token].text == "and") {
+        ++m_token;
+        returnif (!parseUnary()) false;
+        m_program.push_back({Opcode::AND});
+    }
+
+    return true;
+}
+
+bool DetectCondition::parseUnary()
+{
+    returnif (m_token >= m_tokens.size()) fail("Unexpected end");
+    const auto& token = m_tokens[m_token++];
+
+    // Negation
+    if (token.text == "not") {
+        returnif (!parseUnary()) false;
+        m_program.push_back({Opcode::NOT});
+        return true;
+    }
+
+    // Parentheses
+    if (token.text == "(") {
+        returnif (!parseOr()) false;
+        returnif (m_token >= m_tokens.size() || m_tokens[m_token].text != ")") fail("Missing ')'");
+        ++m_token;
+        return true;
+    }
+
+    // Atoms
+    Instruction instruction;
+    if (token.text == "distance") {
+        instruction.opcode = Opcode::DISTANCE;
+        returnif (!parseComparison(instruction, true)) false;
+    }
+    else if (token.text == "same_room") {
+        instruction.opcode = Opcode::SAME_ROOM;
+    }
+    else if (token.text == "same_floor") {
+        instruction.opcode = Opcode::SAME_FLOOR;
+    }
+    else if (token.text == "key") {
+        instruction.opcode = Opcode::KEY;
+        returnif (m_token + 1u >= m_tokens.size()) fail("Unexpected end");
+        const auto& operation = m_tokens[m_token++].text;
+        const auto& key = m_tokens[m_token++];
+        returnif (operation != "==" && operation != "!=") fail("Keys can only be compared with == or !=");
+        returnif (key.number) fail("Invalid key '" + key.text + "'");
+
+        instruction.comparison = (operation == "==")? Comparison::EQUAL : Comparison::NOT_EQUAL;
+        auto found = std::find(std::begin(m_keys), std::end(m_keys), key.text);
+        instruction.index = std::distance(std::begin(m_keys), found);
+        if (found == std::end(m_keys)) m_keys.emplace_back(key.text);
+    }
+    else if (token.text.compare(0u, 5u, "data.") == 0 && token.text.size() > 5u) {
+        instruction.opcode = Opcode::DATA;
+        instruction.index = ElementData::attributeID(token.text.substr(5u));
+        returnif (!parseComparison(instruction, false)) false;
+    }
+    else {
+        return fail("Unknown condition '" + token.text + "'");
+    }
+
+    m_program.emplace_back(instruction);
+    return true;
+}
+
+bool DetectCondition::parseComparison(Instruction& instruction, bool ordering)
+{
+    returnif (m_token + 1u >= m_tokens.size()) fail("Unexpected end");
+    const auto& operation = m_tokens[m_token++].text;
+    const auto& value = m_tokens[m_token++];
+
+    if (operation == "<")       instruction.comparison = Comparison::LESS;
+    else if (operation == "<=") instruction.comparison = Comparison::LESS_EQUAL;
+    else if (operation == ">")  instruction.comparison = Comparison::GREATER;
+    else if (operation == ">=") instruction.comparison = Comparison::GREATER_EQUAL;
+    else if (operation == "==" && !ordering) instruction.comparison = Comparison::EQUAL;
+    else if (operation == "!=" && !ordering) instruction.comparison = Comparison::NOT_EQUAL;
+    else return fail("Invalid comparison '" + operation + "'");
+
+    char* end = nullptr;
+    instruction.value = std::strtof(value.text.c_str(), &end);
+    returnif (!value.number || *end != '\0') fail("Invalid number '" + value.text + "'");
+    return true;
+}
+
+bool DetectCondition::fail(const std::string& error)
+{
+    if (m_error.empty())
+        m_error = error;
+    return false;
+}
+
+//----------------------//
+//----- Evaluation -----//
+
+bool DetectCondition::evaluate(const DetectEntity& detecting, const DetectEntity& entity) const
+{
+    const auto& position = detecting.localPosition();
+    const auto& otherPosition = entity.localPosition();
+    const auto& roomSize = detecting.detectRoomSize();
+
+    // Results are stacked as bits, the top being the lowest one
+    uint64 stack = 0u;
+
+    for (const auto& instruction : m_program) {
+        bool result = false;
+
+        switch (instruction.opcode) {
+        case Opcode::DISTANCE: {
+            const auto offset = otherPosition - position;
+            const auto distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+            result = compare(distance, instruction.comparison, detecting.detectRangeFactor() * instruction.value);
+            break;
+        }
+
+        case Opcode::SAME_ROOM:
+            result = roomIndex(position.x, roomSize.x) == roomIndex(otherPosition.x, roomSize.x)
+                  && roomIndex(position.y, roomSize.y) == roomIndex(otherPosition.y, roomSize.y);
+            break;
+
+        case Opcode::SAME_FLOOR:
+            result = roomIndex(position.y, roomSize.y) == roomIndex(otherPosition.y, roomSize.y);
+            break;
+
+        case Opcode::KEY:
+            result = (entity.detectKey() == m_keys[instruction.index]) == (instruction.comparison == Comparison::EQUAL);
+            break;
+
+        case Opcode::DATA: {
+            float value;
+            result = entity.detectData(instruction.index, value) && compare(value, instruction.comparison, instruction.value);
+            break;
+        }
+
+        case Opcode::NOT:
+            stack ^= 1u;
+            continue;
+
+        case Opcode::AND: {
+            const auto top = stack & 1u;
+            stack = (stack >> 1u) & (~static_cast<uint64>(1u) | top);
+            continue;
+        }
+
+        case Opcode::OR: {
+            const auto top = stack & 1u;
+            stack = (stack >> 1u) | top;
+            continue;
+        }
+        }
+
+        stack = (stack << 1u) | (result? 1u : 0u);
+    }
+
+    return (stack & 1u) != 0u;
+}
+
+bool DetectCondition::compare(float a, Comparison comparison, float b)
+{
+    switch (comparison) {
+    case Comparison::LESS:          return a < b;
+    case Comparison::LESS_EQUAL:    return a <= b;
+    case Comparison::GREATER:       return a > b;
+    case Comparison::GREATER_EQUAL: return a >= b;
+    case Comparison::EQUAL:         return a == b;
+    case Comparison::NOT_EQUAL:     return a != b;
+    }
+
+    return false;
+}
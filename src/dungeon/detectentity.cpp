@@ -1,8 +1,8 @@
 #include "dungeon/detectentity.hpp"
 
 #include "dungeon/detector.hpp"
-#include "tools/string.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace dungeon;
@@ -22,42 +22,58 @@ DetectEntity::~DetectEntity()
 
 void DetectEntity::update(const sf::Time& dt, const float factor)
 {
-    // Run callbacks which condition are met
-    if (m_detectActive)
-        for (const auto& signal : m_detectSignals)
-            for (auto UID : signal.condition())
-                signal.callback(UID);
+    // Run callbacks which event occured, by index as a callback might add signals
+    if (m_detectActive) {
+        for (uint i = 0u; i < m_detectSignals.size(); ++i) {
+            auto& signal = m_detectSignals[i];
+            auto& previousUIDs = signal.detectedUIDs;
+            s_detector.detect(*this, signal.key, signal.condition, m_detectUIDs);
 
-    baseClass::update(dt, factor);
-}
+            // Stay events need no memory
+            if (signal.event == DetectEvent::STAY) {
+                m_detectEventUIDs.swap(m_detectUIDs);
+            }
+            // Enter events are in detection order, exit events in UID order
+            else {
+                m_detectEventUIDs.clear();
+                if (signal.event == DetectEvent::ENTER)
+                    for (auto UID : m_detectUIDs)
+                        if (!std::binary_search(std::begin(previousUIDs), std::end(previousUIDs), UID))
+                            m_detectEventUIDs.emplace_back(UID);
 
-//--------------------//
-//---- Detection -----//
+                std::sort(std::begin(m_detectUIDs), std::end(m_detectUIDs));
+                if (signal.event == DetectEvent::EXIT)
+                    std::set_difference(std::begin(previousUIDs), std::end(previousUIDs), std::begin(m_detectUIDs), std::end(m_detectUIDs),
+                                        std::back_inserter(m_detectEventUIDs));
+                previousUIDs.swap(m_detectUIDs);
+            }
 
-DetectEntity::DetectCondition DetectEntity::interpretDetectCondition(const std::string& key, const std::string &condition)
-{
-    // TODO Make a correct parser out of these
-    auto tokens = split(condition);
-    if (tokens.size() >= 3u) {
-        // In range
-        if (tokens[0u] == "distance" && tokens[1u] == "<") {
-            std::stringstream str;
-            str << tokens[2u];
-            float range;
-            str >> range;
-            return [this, key, range] { return inRangeUIDs(key, range); };
+            for (auto UID : m_detectEventUIDs) {
+                if (i >= m_detectSignals.size()) break;
+                m_detectSignals[i].callback(UID);
+            }
         }
     }
 
-    std::cerr << "[DetectEntity] ERROR: Cannot interpret condition '" << condition << "'." << std::endl;
-    return [] { return std::vector<UID_t>(); };
+    baseClass::update(dt, factor);
+}
+
+void DetectEntity::onLocalPositionChanges()
+{
+    s_detector.refreshEntity(*this);
 }
 
-void DetectEntity::addDetectSignal(const std::string& key, const std::string& condition, DetectCallback callback)
+//--------------------//
+//---- Detection -----//
+
+void DetectEntity::addDetectSignal(const std::string& key, const std::string& condition, DetectCallback callback, DetectEvent event)
 {
     DetectSignal signal;
-    signal.condition = interpretDetectCondition(key, condition);
+    signal.key = key;
+    if (!signal.condition.compile(condition))
+        std::cerr << "[DetectEntity] ERROR: Cannot interpret condition '" << condition << "': " << signal.condition.error() << "." << std::endl;
     signal.callback = std::move(callback);
+    signal.event = event;
     m_detectSignals.emplace_back(std::move(signal));
 }
 
@@ -66,7 +82,7 @@ void DetectEntity::removeDetectSignals()
     m_detectSignals.clear();
 }
 
-std::vector<DetectEntity::UID_t> DetectEntity::inRangeUIDs(const std::string& key, float range) const
+void DetectEntity::inRangeUIDs(const std::string& key, float range, std::vector<UID_t>& UIDs) const
 {
-    return s_detector.inRangeUIDs(*this, key, m_detectRangeFactor * range);
+    s_detector.inRangeUIDs(*this, key, m_detectRangeFactor * range, UIDs);
 }
@@ -1,11 +1,15 @@
 #include "dungeon/detector.hpp"
 
+#include "dungeon/detectcondition.hpp"
 #include "dungeon/detectentity.hpp"
 #include "tools/platform-fixes.hpp" // std::erase_if
 #include "tools/vector.hpp"
 #include "tools/tools.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <limits>
 
 using namespace dungeon;
 
@@ -14,18 +18,151 @@ using namespace dungeon;
 
 Detector dungeon::s_detector;
 
+namespace
+{
+    //! Cells farther than that from the origin are not indexed separately,
+    //! so that cell coordinates always fit the integers.
+    const float maxCell = static_cast<float>(std::numeric_limits<int32>::max() / 2);
+}
+
 //-----------------------//
 //----- Registering -----//
 
 void Detector::addEntity(DetectEntity& entity)
 {
+    // Reuse a free slot if any
+    uint32 slotIndex;
+    if (!m_freeSlots.empty()) {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        massert(m_slots.size() <= s_slotMask, "Too many entities registered in the detector.");
+        slotIndex = m_slots.size();
+        m_slots.emplace_back();
+    }
+
+    auto& slot = m_slots[slotIndex];
+    slot.index = m_entities.size();
     m_entities.emplace_back(&entity);
-    entity.setUID(m_UIDGenerator++);
+
+    entity.setUID((slot.generation << s_slotBits) | slotIndex);
+    entity.m_detectOrder = m_orderGenerator++;
+    cellInsert(entity);
 }
 
 void Detector::removeEntity(DetectEntity& entity)
 {
-    std::erase_if(m_entities, [&entity] (const DetectEntity* pEntity) { return pEntity == &entity; } );
+    cellRemove(entity);
+
+    // Leave a hole, so that entities stay in registering order
+    auto& slot = m_slots[entity.UID() & s_slotMask];
+    m_entities[slot.index] = nullptr;
+    ++m_holesCount;
+
+    // Free the slot, all previous UIDs pointing to it are now stale
+    slot.index = -1u;
+    slot.generation = (slot.generation + 1u) & (-1u >> s_slotBits);
+    if (((slot.generation << s_slotBits) | (entity.UID() & s_slotMask)) == -1u)
+        slot.generation = 0u;
+    m_freeSlots.emplace_back(entity.UID() & s_slotMask);
+
+    // Do not let an applyInRange() in progress call the entity
+    if (m_applyingCandidates != nullptr)
+        for (auto& pEntity : *m_applyingCandidates)
+            if (pEntity == &entity)
+                pEntity = nullptr;
+
+    // Holes are removed once they are the majority
+    if (2u * m_holesCount > m_entities.size())
+        compact();
+}
+
+void Detector::refreshEntity(DetectEntity& entity)
+{
+    returnif (cellKey(entity.localPosition()) == entity.m_detectCell);
+
+    cellRemove(entity);
+    cellInsert(entity);
+}
+
+void Detector::compact()
+{
+    std::erase_if(m_entities, [] (const DetectEntity* pEntity) { return pEntity == nullptr; });
+    m_holesCount = 0u;
+
+    for (uint32 index = 0u; index < m_entities.size(); ++index)
+        m_slots[m_entities[index]->UID() & s_slotMask].index = index;
+}
+
+//-------------------------//
+//----- Spatial index -----//
+
+void Detector::setCellSize(float cellSize)
+{
+    returnif (cellSize <= 0.f || cellSize == m_cellSize);
+    m_cellSize = cellSize;
+
+    // Rebuild the whole index
+    m_cells.clear();
+    for (auto& pEntity : m_entities)
+        if (pEntity != nullptr)
+            cellInsert(*pEntity);
+}
+
+uint64 Detector::cellKey(const sf::Vector2f& position) const
+{
+    auto cx = static_cast<int32>(std::floor(std::min(std::max(position.x / m_cellSize, -maxCell), maxCell)));
+    auto cy = static_cast<int32>(std::floor(std::min(std::max(position.y / m_cellSize, -maxCell), maxCell)));
+    return (static_cast<uint64>(static_cast<uint32>(cx)) << 32u) | static_cast<uint32>(cy);
+}
+
+void Detector::cellInsert(DetectEntity& entity)
+{
+    entity.m_detectCell = cellKey(entity.localPosition());
+    m_cells[entity.m_detectCell].emplace_back(&entity);
+}
+
+void Detector::cellRemove(DetectEntity& entity)
+{
+    auto found = m_cells.find(entity.m_detectCell);
+    returnif (found == std::end(m_cells));
+
+    auto& cell = found->second;
+    std::erase_if(cell, [&entity] (const DetectEntity* pEntity) { return pEntity == &entity; } );
+    if (cell.empty()) m_cells.erase(found);
+}
+
+void Detector::candidatesInRange(const sf::Vector2f& position, float range, std::vector<DetectEntity*>& candidates) const
+{
+    // Scanning everything is cheaper if the range covers too many cells, entities are already in order,
+    // also used for huge or infinite ranges, whose cells would not fit the integers
+    const auto cellsSpan = 2.f * range / m_cellSize + 3.f;
+    const auto farthestCell = (std::max(std::abs(position.x), std::abs(position.y)) + range) / m_cellSize;
+    if (!m_indexed || !(range >= 0.f) || !(cellsSpan * cellsSpan <= m_cells.size()) || !(farthestCell < maxCell)) {
+        std::copy_if(std::begin(m_entities), std::end(m_entities), std::back_inserter(candidates),
+                     [] (const DetectEntity* pEntity) { return pEntity != nullptr; });
+        return;
+    }
+
+    // Cells covering the range, with one cell margin to be safe against rounding errors
+    auto cxMin = static_cast<int32>(std::floor((position.x - range) / m_cellSize)) - 1;
+    auto cxMax = static_cast<int32>(std::floor((position.x + range) / m_cellSize)) + 1;
+    auto cyMin = static_cast<int32>(std::floor((position.y - range) / m_cellSize)) - 1;
+    auto cyMax = static_cast<int32>(std::floor((position.y + range) / m_cellSize)) + 1;
+
+    for (auto cx = cxMin; cx <= cxMax; ++cx) {
+        for (auto cy = cyMin; cy <= cyMax; ++cy) {
+            auto key = (static_cast<uint64>(static_cast<uint32>(cx)) << 32u) | static_cast<uint32>(cy);
+            auto found = m_cells.find(key);
+            if (found == std::end(m_cells)) continue;
+
+            candidates.insert(std::end(candidates), std::begin(found->second), std::end(found->second));
+        }
+    }
+
+    // Keep the registering order
+    std::sort(std::begin(candidates), std::end(candidates), [] (const DetectEntity* a, const DetectEntity* b) { return a->m_detectOrder < b->m_detectOrder; });
 }
 
 //---------------------//
@@ -33,31 +170,39 @@ void Detector::removeEntity(DetectEntity& entity)
 
 DetectEntity* Detector::find(const UID_t UID)
 {
-    for (auto& pEntity : m_entities)
-        if (pEntity->UID() == UID)
-            return pEntity;
-    return nullptr;
+    auto slotIndex = UID & s_slotMask;
+    returnif (slotIndex >= m_slots.size()) nullptr;
+
+    const auto& slot = m_slots[slotIndex];
+    returnif (slot.index == -1u || slot.generation != (UID >> s_slotBits)) nullptr;
+    return m_entities[slot.index];
 }
 
 const DetectEntity* Detector::find(const UID_t UID) const
 {
-    for (const auto& pEntity : m_entities)
-        if (pEntity->UID() == UID)
-            return pEntity;
-    return nullptr;
+    auto slotIndex = UID & s_slotMask;
+    returnif (slotIndex >= m_slots.size()) nullptr;
+
+    const auto& slot = m_slots[slotIndex];
+    returnif (slot.index == -1u || slot.generation != (UID >> s_slotBits)) nullptr;
+    return m_entities[slot.index];
 }
 
-std::vector<Detector::UID_t> Detector::inRangeUIDs(const DetectEntity& entity, const std::string& key, const float range) const
+void Detector::inRangeUIDs(const DetectEntity& entity, const std::string& key, const float range, std::vector<UID_t>& UIDs) const
 {
-    std::vector<Detector::UID_t> UIDs;
+    UIDs.clear();
 
     // Range squared
     const auto sqRange = range * range;
 
     // Check if any in range for all corresponding key
-    // OPTIM Think about implementing a QuadTree for the DetectEntities
+    // The candidates buffer is per thread, as queries might run concurrently
     const auto& position = entity.localPosition();
-    for (const auto& pEntity : m_entities) {
+    thread_local std::vector<DetectEntity*> candidates;
+    candidates.clear();
+    candidatesInRange(position, range, candidates);
+
+    for (const auto& pEntity : candidates) {
         if (!pEntity->detectVisible()) continue;
         if (pEntity->detectKey() != key || pEntity == &entity) continue;
 
@@ -66,8 +211,29 @@ std::vector<Detector::UID_t> Detector::inRangeUIDs(const DetectEntity& entity, c
         if (sqDistance <= sqRange)
             UIDs.emplace_back(pEntity->UID());
     }
+}
+
+void Detector::detect(const DetectEntity& entity, const std::string& key, const DetectCondition& condition, std::vector<UID_t>& UIDs) const
+{
+    UIDs.clear();
+    returnif (!condition.valid());
+
+    // Unbounded conditions check all entities
+    auto range = condition.range();
+    if (range >= 0.f) range *= entity.detectRangeFactor();
 
-    return UIDs;
+    // The candidates buffer is per thread, as queries might run concurrently
+    thread_local std::vector<DetectEntity*> candidates;
+    candidates.clear();
+    candidatesInRange(entity.localPosition(), range, candidates);
+
+    for (const auto& pEntity : candidates) {
+        if (!pEntity->detectVisible() || pEntity == &entity) continue;
+        if (!key.empty() && pEntity->detectKey() != key) continue;
+
+        if (condition.evaluate(entity, *pEntity))
+            UIDs.emplace_back(pEntity->UID());
+    }
 }
 
 void Detector::applyInRange(const sf::Vector2f& position, float range, DetectionLambda rangeEntityFunc)
@@ -75,13 +241,21 @@ void Detector::applyInRange(const sf::Vector2f& position, float range, Detection
     // Range squared
     const auto sqRange = range * range;
 
+    // The lambda might destroy some entities, they are removed from the candidates if so
+    std::vector<DetectEntity*> candidates;
+    candidatesInRange(position, range, candidates);
+    auto previousApplyingCandidates = m_applyingCandidates;
+    m_applyingCandidates = &candidates;
+
     // Check if any in range
-    for (const auto& pEntity : m_entities) {
-        if (!pEntity->detectVisible()) continue;
+    for (const auto& pEntity : candidates) {
+        if (pEntity == nullptr || !pEntity->detectVisible()) continue;
 
         const auto distance = position - pEntity->localPosition();
         const auto sqDistance = distance.x * distance.x + distance.y * distance.y;
         if (sqDistance <= sqRange)
             rangeEntityFunc(*pEntity, std::sqrt(sqDistance));
     }
+
+    m_applyingCandidates = previousApplyingCandidates;
 }
@@ -5,11 +5,20 @@
 
 using namespace dungeon;
 
-Dynamic::Dynamic(Inter& inter)
+Dynamic::Dynamic(uint32 managerHandle, Inter& inter)
     : baseClass(inter)
+    , m_managerHandle(managerHandle)
 {
-    // Lua API
-    lua()["eev_dynamicRemoveSelf"] = [this] { lua_dynamicRemoveSelf(); };
+}
+
+//-------------------//
+//----- Lua API -----//
+
+void Dynamic::registerLuaAPI(scene::LuaVM& vm)
+{
+    baseClass::registerLuaAPI(vm);
+
+    luaBind(vm, "eev_dynamicRemoveSelf", &Dynamic::lua_dynamicRemoveSelf);
 }
 
 //------------------------//
@@ -34,11 +43,12 @@ void Dynamic::bindElementData(ElementData& edata)
     auto sElementID = toString(m_elementID);
 
     // Initial position
-    sf::Vector2f position = m_inter.positionFromRelCoords({m_edata->operator[](L"rx").as_float(), m_edata->operator[](L"ry").as_float()});
+    sf::Vector2f position = m_inter.positionFromRelCoords({m_edata->operator[](attributes::rx).as_float(), m_edata->operator[](attributes::ry).as_float()});
     setLocalPosition(position);
 
     // Reparameter from inter
     setDetectRangeFactor(m_inter.tileSize().x);
+    setDetectRoomSize(m_inter.tileSize());
 
     // First time or new monsterID
     if (firstTime) {
@@ -47,7 +57,7 @@ void Dynamic::bindElementData(ElementData& edata)
 
         // Lua
         std::string luaFilename = "res/vanilla/dynamics/" + sElementID + "/ai.lua";
-        if (!lua().load(luaFilename))
+        if (!loadLua(luaFilename))
             mquit("Failed to load Lua file: '" + luaFilename + "'. It might be a syntax error or a missing file.");
 
         // Clear all previous callbacks
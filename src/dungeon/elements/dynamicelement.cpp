@@ -12,10 +12,10 @@ DynamicElement::DynamicElement(Inter& inter)
 
 uint DynamicElement::lua_getCurrentRoomX() const
 {
-    return static_cast<uint>(m_edata->operator[](L"rx").as_float());
+    return static_cast<uint>(m_edata->operator[](attributes::rx).as_float());
 }
 
 uint DynamicElement::lua_getCurrentRoomY() const
 {
-    return static_cast<uint>(m_edata->operator[](L"ry").as_float());
+    return static_cast<uint>(m_edata->operator[](attributes::ry).as_float());
 }
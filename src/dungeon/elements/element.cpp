@@ -10,14 +10,12 @@
 #include "tools/string.hpp"
 
 using namespace dungeon;
-using namespace std::placeholders;
 
 Element::Element(dungeon::Inter& inter)
     : m_inter(inter)
 {
     // Components
-    auto aiComponent = addComponent<scene::AI>(*this);
-    m_lua = &aiComponent->luaState();
+    m_ai = addComponent<scene::AI>(*this);
 
     // Note: an Element has a size fitting a whole room,
     // so the hitbox cannot be bigger than that.
@@ -25,6 +23,7 @@ Element::Element(dungeon::Inter& inter)
     // Initializing
     // TODO Follow Monster design and delay that to a rebindFromData function
     setDetectRangeFactor(m_inter.tileSize().x);
+    setDetectRoomSize(m_inter.tileSize());
     setLocalScale(m_inter.roomScale());
     setSize(m_inter.tileSize());
     centerOrigin();
@@ -37,64 +36,104 @@ Element::Element(dungeon::Inter& inter)
     attachChild(m_mouseOverlay);
     m_mouseOverlay.setVisible(false);
     m_mouseOverlay.setDepth(-50.f);
+}
+
+Element::~Element()
+{
+    removeComponent<scene::AI>();
+}
+
+//---------------//
+//----- Lua -----//
+
+bool Element::loadLua(const std::string& file)
+{
+    return m_ai->load(file, [this] (scene::LuaVM& vm) { registerLuaAPI(vm); });
+}
+
+void Element::registerLuaAPI(scene::LuaVM& vm)
+{
+    // Only the element itself is accessed by the immediate calls,
+    // the others being deferred or forbidden while deciding concurrently
+    luaBindDeferred(vm, "eev_callbackRegister", &Element::lua_callbackRegister);
+    luaBindDeferred(vm, "eev_callbackEnterRegister", &Element::lua_callbackEnterRegister);
+    luaBindDeferred(vm, "eev_callbackExitRegister", &Element::lua_callbackExitRegister);
+    luaBindDeferred(vm, "eev_callbackClickLeftSet", &Element::lua_callbackClickLeftSet);
+    luaBindDeferred(vm, "eev_callbackClickRightSet", &Element::lua_callbackClickRightSet);
+
+    luaBindDeferred(vm, "eev_roomClickedInteractive", &Element::lua_roomClickedInteractive);
 
-    // Lua API
-    std::function<void(const std::string&, const std::string&, const std::string&)> eev_callbackRegister = std::bind(&Element::lua_callbackRegister, this, _1, _2, _3);
-    std::function<void(const std::string&, const std::string&)> eev_callbackClickLeftSet = std::bind(&Element::lua_callbackClickLeftSet, this, _1, _2);
-    std::function<void(const std::string&, const std::string&)> eev_callbackClickRightSet = std::bind(&Element::lua_callbackClickRightSet, this, _1, _2);
+    // The data belongs to the element alone, so changes are applied immediately, even while deferring
+    luaBind(vm, "eev_setDataBool", &Element::lua_setDataBool);
+    luaBind(vm, "eev_getDataBool", &Element::lua_getDataBool);
+    luaBind(vm, "eev_initEmptyDataBool", &Element::lua_initEmptyDataBool);
+    luaBind(vm, "eev_setDataU32", &Element::lua_setDataU32);
+    luaBind(vm, "eev_getDataU32", &Element::lua_getDataU32);
+    luaBind(vm, "eev_addDataU32", &Element::lua_addDataU32);
+    luaBind(vm, "eev_initEmptyDataU32", &Element::lua_initEmptyDataU32);
+    luaBind(vm, "eev_setDataFloat", &Element::lua_setDataFloat);
+    luaBind(vm, "eev_getDataFloat", &Element::lua_getDataFloat);
+    luaBind(vm, "eev_addDataFloat", &Element::lua_addDataFloat);
+    luaBind(vm, "eev_initEmptyDataFloat", &Element::lua_initEmptyDataFloat);
 
-    lua()["eev_callbackRegister"] = eev_callbackRegister;
-    lua()["eev_callbackClickLeftSet"] = eev_callbackClickLeftSet;
-    lua()["eev_callbackClickRightSet"] = eev_callbackClickRightSet;
+    // Same, from attribute handles resolved once by the script
+    luaBind(vm, "eev_attribute", &Element::lua_attribute);
+    luaBind(vm, "eev_setDataBoolID", &Element::lua_setDataBoolID);
+    luaBind(vm, "eev_getDataBoolID", &Element::lua_getDataBoolID);
+    luaBind(vm, "eev_initEmptyDataBoolID", &Element::lua_initEmptyDataBoolID);
+    luaBind(vm, "eev_setDataU32ID", &Element::lua_setDataU32ID);
+    luaBind(vm, "eev_getDataU32ID", &Element::lua_getDataU32ID);
+    luaBind(vm, "eev_addDataU32ID", &Element::lua_addDataU32ID);
+    luaBind(vm, "eev_initEmptyDataU32ID", &Element::lua_initEmptyDataU32ID);
+    luaBind(vm, "eev_setDataFloatID", &Element::lua_setDataFloatID);
+    luaBind(vm, "eev_getDataFloatID", &Element::lua_getDataFloatID);
+    luaBind(vm, "eev_addDataFloatID", &Element::lua_addDataFloatID);
+    luaBind(vm, "eev_initEmptyDataFloatID", &Element::lua_initEmptyDataFloatID);
 
-    lua()["eev_roomClickedInteractive"] = [this] (const std::string& luaKey) { lua_roomClickedInteractive(luaKey); };
+    luaBindDeferred(vm, "eev_setUIDDataU32", &Element::lua_setUIDDataU32);
+    luaBindSerial(vm, "eev_getUIDDataU32", &Element::lua_getUIDDataU32);
 
-    lua()["eev_setDataBool"] = [this] (const std::string& s, const bool value) { return lua_setDataBool(s, value); };
-    lua()["eev_getDataBool"] = [this] (const std::string& s) { return lua_getDataBool(s); };
-    lua()["eev_initEmptyDataBool"] = [this] (const std::string& s, const bool value) { return lua_initEmptyDataBool(s, value); };
-    lua()["eev_setDataU32"] = [this] (const std::string& s, const uint32 value) { return lua_setDataU32(s, value); };
-    lua()["eev_getDataU32"] = [this] (const std::string& s) { return lua_getDataU32(s); };
-    lua()["eev_addDataU32"] = [this] (const std::string& s, const uint32 value) { return lua_addDataU32(s, value); };
-    lua()["eev_initEmptyDataU32"] = [this] (const std::string& s, const uint32 value) { return lua_initEmptyDataU32(s, value); };
-    lua()["eev_setDataFloat"] = [this] (const std::string& s, const lua_Number value) { return lua_setDataFloat(s, value); };
-    lua()["eev_getDataFloat"] = [this] (const std::string& s) { return lua_getDataFloat(s); };
-    lua()["eev_addDataFloat"] = [this] (const std::string& s, const lua_Number value) { return lua_addDataFloat(s, value); };
-    lua()["eev_initEmptyDataFloat"] = [this] (const std::string& s, const lua_Number value) { return lua_initEmptyDataFloat(s, value); };
+    luaBindDeferred(vm, "eev_selectAnimation", &Element::lua_selectAnimation);
+    luaBind(vm, "eev_isAnimationStopped", &Element::lua_isAnimationStopped);
+    luaBindDeferred(vm, "eev_restartAnimation", &Element::lua_restartAnimation);
+    luaBindDeferred(vm, "eev_forwardAnimation", &Element::lua_forwardAnimation);
 
-    lua()["eev_setUIDDataU32"] = [this] (const uint32 UID, const std::string& s, const uint32 value) { lua_setUIDDataU32(UID, s, value); };
-    lua()["eev_getUIDDataU32"] = [this] (const uint32 UID, const std::string& s) { return lua_getUIDDataU32(UID, s); };
+    luaBindDeferred(vm, "eev_soundPlay", &Element::lua_soundPlay);
 
-    lua()["eev_selectAnimation"] = [this] (const std::string& animationKey) { lua_selectAnimation(animationKey); };
-    lua()["eev_isAnimationStopped"] = [this] { return lua_isAnimationStopped(); };
-    lua()["eev_restartAnimation"] = [this] { lua_restartAnimation(); };
-    lua()["eev_forwardAnimation"] = [this] (const lua_Number offset) { lua_forwardAnimation(offset); };
+    luaBindDeferred(vm, "eev_selectAnimationUID", &Element::lua_selectAnimationUID);
 
-    lua()["eev_soundPlay"] = [this] (const std::string& soundID) { lua_soundPlay(soundID); };
+    luaBindDeferred(vm, "eev_damageRange", &Element::lua_damageRange);
+    luaBindSerial(vm, "eev_spawnDynamic", &Element::lua_spawnDynamic);
+    luaBindDeferred(vm, "eev_setDepth", &Element::lua_setDepth);
+    luaBindDeferred(vm, "eev_setVisible", &Element::lua_setVisible);
 
-    lua()["eev_selectAnimationUID"] = [this] (const uint32 UID, const std::string& animationKey) { lua_selectAnimationUID(UID, animationKey); };
+    luaBindDeferred(vm, "eev_damageUID", &Element::lua_damageUID);
+    luaBindDeferred(vm, "eev_setDepthUID", &Element::lua_setDepthUID);
+    luaBindDeferred(vm, "eev_setVisibleUID", &Element::lua_setVisibleUID);
+    luaBindDeferred(vm, "eev_setDetectVisibleUID", &Element::lua_setDetectVisibleUID);
+    luaBindDeferred(vm, "eev_setDetectActiveUID", &Element::lua_setDetectActiveUID);
+    luaBindDeferred(vm, "eev_resetClipAreasUID", &Element::lua_resetClipAreasUID);
+    luaBindDeferred(vm, "eev_addClipAreaUID", &Element::lua_addClipAreaUID);
 
-    lua()["eev_damageRange"] = [this] (const lua_Number rx, const lua_Number ry, const lua_Number relRange, const lua_Number basePower) { lua_damageRange(rx, ry, relRange, basePower); };
-    lua()["eev_spawnDynamic"] = [this] (const std::string& shortDynamicID, const lua_Number rx, const lua_Number ry) { return lua_spawnDynamic(shortDynamicID, rx, ry); };
-    lua()["eev_setDepth"] = [this] (const lua_Number inDepth) { lua_setDepth(inDepth); };
-    lua()["eev_setVisible"] = [this] (bool isVisible) { lua_setVisible(isVisible); };
+    luaBindSerial(vm, "eev_borrowVillainDosh", &Element::lua_borrowVillainDosh);
+    luaBindDeferred(vm, "eev_giveDosh", &Element::lua_giveDosh);
+    luaBindDeferred(vm, "eev_giveSoul", &Element::lua_giveSoul);
+    luaBindDeferred(vm, "eev_giveFame", &Element::lua_giveFame);
 
-    lua()["eev_damageUID"] = [this] (const uint32 UID, const lua_Number amount) { lua_damageUID(UID, amount); };
-    lua()["eev_setDepthUID"] = [this] (const uint32 UID, const lua_Number inDepth) { lua_setDepthUID(UID, inDepth); };
-    lua()["eev_setVisibleUID"] = [this] (const uint32 UID, bool isVisible) { lua_setVisibleUID(UID, isVisible); };
-    lua()["eev_setDetectVisibleUID"] = [this] (const uint32 UID, bool detectVisible) { lua_setDetectVisibleUID(UID, detectVisible); };
-    lua()["eev_setDetectActiveUID"] = [this] (const uint32 UID, bool detectActive) { lua_setDetectActiveUID(UID, detectActive); };
-    lua()["eev_resetClipAreasUID"] = [this] (const uint32 UID) { lua_resetClipAreasUID(UID); };
-    lua()["eev_addClipAreaUID"] = [this] (const uint32 UID, const lua_Number rx, const lua_Number ry, const lua_Number rw, const lua_Number rh) { lua_addClipAreaUID(UID, rx, ry, rw, rh); };
+    luaBindDeferred(vm, "eev_dungeonExplodeRoom", &Element::lua_dungeonExplodeRoom);
+    luaBindSerial(vm, "eev_dungeonPushRoom", &Element::lua_dungeonPushRoom);
 
-    lua()["eev_borrowVillainDosh"] = [this] (const uint32 amount) { return lua_borrowVillainDosh(amount); };
-    lua()["eev_giveDosh"] = [this] (const uint32 amount) { lua_giveDosh(amount); };
-    lua()["eev_giveSoul"] = [this] (const uint32 amount) { lua_giveSoul(amount); };
-    lua()["eev_giveFame"] = [this] (const uint32 amount) { lua_giveFame(amount); };
+    luaBindDeferred(vm, "eev_log", &Element::lua_log);
+}
 
-    lua()["eev_dungeonExplodeRoom"] = [this] (const uint x, const uint y) { lua_dungeonExplodeRoom(x, y); };
-    lua()["eev_dungeonPushRoom"] = [this] (const uint x, const uint y, const std::string& direction, const uint animationDelay) { return lua_dungeonPushRoom(x, y, direction, animationDelay); };
+//--------------------------//
+//----- Deferred calls -----//
 
-    lua()["eev_log"] = [this] (const std::string& str) { lua_log(str); };
+void Element::applyDeferredCalls()
+{
+    for (const auto& deferredCall : m_deferredCalls)
+        deferredCall();
+    m_deferredCalls.clear();
 }
 
 //-------------------//
@@ -149,6 +188,21 @@ void Element::handleMouseLeft()
     hideMouseOverlay();
 }
 
+//------------------------//
+//----- Element data -----//
+
+bool Element::detectData(uint32 attributeID, float& value) const
+{
+    returnif (m_edata == nullptr || !m_edata->exists(attributeID)) false;
+
+    const auto& data = m_edata->at(attributeID);
+    if (data.type() == MetaType::UINT32)     value = data.as_uint32();
+    else if (data.type() == MetaType::FLOAT) value = data.as_float();
+    else return false;
+
+    return true;
+}
+
 //---------------------//
 //----- Animation -----//
 
@@ -189,6 +243,16 @@ void Element::lua_callbackRegister(const std::string& luaKey, const std::string&
     addDetectSignal(entityType, condition, [this, luaKey] (const uint32 UID) { lua()[luaKey.c_str()](UID); });
 }
 
+void Element::lua_callbackEnterRegister(const std::string& luaKey, const std::string& entityType, const std::string& condition)
+{
+    addDetectSignal(entityType, condition, [this, luaKey] (const uint32 UID) { lua()[luaKey.c_str()](UID); }, DetectEvent::ENTER);
+}
+
+void Element::lua_callbackExitRegister(const std::string& luaKey, const std::string& entityType, const std::string& condition)
+{
+    addDetectSignal(entityType, condition, [this, luaKey] (const uint32 UID) { lua()[luaKey.c_str()](UID); }, DetectEvent::EXIT);
+}
+
 void Element::lua_callbackClickLeftSet(const std::string& luaKey, const std::string& actionName)
 {
     m_leftClickAction.name = actionName;
@@ -219,76 +283,151 @@ void Element::lua_roomClickedInteractive(const std::string& luaKey)
 
 //----- Element data
 
+uint32 Element::lua_attribute(const std::string& s) const
+{
+    return ElementData::attributeID(s);
+}
+
 bool Element::lua_setDataBool(const std::string& s, const bool value)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_bool() = value;
+    return lua_setDataBoolID(ElementData::attributeID(s), value);
 }
 
-bool Element::lua_getDataBool(const std::string& s) const
+bool Element::lua_getDataBool(const std::string& s)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_bool();
+    return lua_getDataBoolID(ElementData::attributeID(s));
 }
 
 bool Element::lua_initEmptyDataBool(const std::string& s, const bool value)
 {
-    auto ws = toWString(s);
-    if (!m_edata->exists(ws))
-        m_edata->operator[](ws).init_bool(value);
-    return m_edata->operator[](ws).as_bool();
+    return lua_initEmptyDataBoolID(ElementData::attributeID(s), value);
 }
 
 uint32 Element::lua_setDataU32(const std::string& s, const uint32 value)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_uint32() = value;
+    return lua_setDataU32ID(ElementData::attributeID(s), value);
 }
 
-uint32 Element::lua_getDataU32(const std::string& s) const
+uint32 Element::lua_getDataU32(const std::string& s)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_uint32();
+    return lua_getDataU32ID(ElementData::attributeID(s));
 }
+
 uint32 Element::lua_addDataU32(const std::string& s, const uint32 value)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_uint32() += value;
+    return lua_addDataU32ID(ElementData::attributeID(s), value);
 }
 
 uint32 Element::lua_initEmptyDataU32(const std::string& s, const uint32 value)
 {
-    auto ws = toWString(s);
-    if (!m_edata->exists(ws))
-        m_edata->operator[](ws).init_uint32(value);
-
-    return m_edata->operator[](ws).as_uint32();
+    return lua_initEmptyDataU32ID(ElementData::attributeID(s), value);
 }
 
 lua_Number Element::lua_setDataFloat(const std::string& s, const lua_Number value)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_float() = static_cast<float>(value);
+    return lua_setDataFloatID(ElementData::attributeID(s), value);
 }
 
-lua_Number Element::lua_getDataFloat(const std::string& s) const
+lua_Number Element::lua_getDataFloat(const std::string& s)
 {
-    auto ws = toWString(s);
-    return static_cast<lua_Number>(m_edata->operator[](ws).as_float());
+    return lua_getDataFloatID(ElementData::attributeID(s));
 }
 
 lua_Number Element::lua_addDataFloat(const std::string& s, const lua_Number value)
 {
-    auto ws = toWString(s);
-    return m_edata->operator[](ws).as_float() += static_cast<float>(value);
+    return lua_addDataFloatID(ElementData::attributeID(s), value);
 }
 
 lua_Number Element::lua_initEmptyDataFloat(const std::string& s, const lua_Number value)
 {
-    auto ws = toWString(s);
-    if (!m_edata->exists(ws))
-        m_edata->operator[](ws).init_float(static_cast<float>(value));
-    return m_edata->operator[](ws).as_float();
+    return lua_initEmptyDataFloatID(ElementData::attributeID(s), value);
+}
+
+//----- Element data from attribute
+
+bool Element::checkAttribute(const uint32 id)
+{
+    returnif (ElementData::attributeInterned(id)) true;
+
+    // Reported with the recorded calls while deferring, so from the main thread
+    auto report = [this, id] {
+        std::cerr << "/!\\ LUA [" << detectKey() << "] Invalid attribute " << id << ", use eev_attribute()." << std::endl;
+    };
+    if (m_deferring) m_deferredCalls.emplace_back(std::move(report));
+    else report();
+    return false;
+}
+
+bool Element::lua_setDataBoolID(const uint32 id, const bool value)
+{
+    returnif (!checkAttribute(id)) false;
+    return m_edata->operator[](id).as_bool() = value;
+}
+
+bool Element::lua_getDataBoolID(const uint32 id)
+{
+    returnif (!checkAttribute(id)) false;
+    return m_edata->operator[](id).as_bool();
+}
+
+bool Element::lua_initEmptyDataBoolID(const uint32 id, const bool value)
+{
+    returnif (!checkAttribute(id)) false;
+    if (!m_edata->exists(id))
+        m_edata->operator[](id).init_bool(value);
+    return m_edata->operator[](id).as_bool();
+}
+
+uint32 Element::lua_setDataU32ID(const uint32 id, const uint32 value)
+{
+    returnif (!checkAttribute(id)) 0u;
+    return m_edata->operator[](id).as_uint32() = value;
+}
+
+uint32 Element::lua_getDataU32ID(const uint32 id)
+{
+    returnif (!checkAttribute(id)) 0u;
+    return m_edata->operator[](id).as_uint32();
+}
+
+uint32 Element::lua_addDataU32ID(const uint32 id, const uint32 value)
+{
+    returnif (!checkAttribute(id)) 0u;
+    return m_edata->operator[](id).as_uint32() += value;
+}
+
+uint32 Element::lua_initEmptyDataU32ID(const uint32 id, const uint32 value)
+{
+    returnif (!checkAttribute(id)) 0u;
+    if (!m_edata->exists(id))
+        m_edata->operator[](id).init_uint32(value);
+    return m_edata->operator[](id).as_uint32();
+}
+
+lua_Number Element::lua_setDataFloatID(const uint32 id, const lua_Number value)
+{
+    returnif (!checkAttribute(id)) 0.;
+    return m_edata->operator[](id).as_float() = static_cast<float>(value);
+}
+
+lua_Number Element::lua_getDataFloatID(const uint32 id)
+{
+    returnif (!checkAttribute(id)) 0.;
+    return static_cast<lua_Number>(m_edata->operator[](id).as_float());
+}
+
+lua_Number Element::lua_addDataFloatID(const uint32 id, const lua_Number value)
+{
+    returnif (!checkAttribute(id)) 0.;
+    return m_edata->operator[](id).as_float() += static_cast<float>(value);
+}
+
+lua_Number Element::lua_initEmptyDataFloatID(const uint32 id, const lua_Number value)
+{
+    returnif (!checkAttribute(id)) 0.;
+    if (!m_edata->exists(id))
+        m_edata->operator[](id).init_float(static_cast<float>(value));
+    return m_edata->operator[](id).as_float();
 }
 
 //----- Element data from UID
@@ -299,8 +438,8 @@ void Element::lua_setUIDDataU32(const uint32 UID, const std::string& s, const ui
     auto* element = dynamic_cast<Element*>(entity);
     returnif (element == nullptr);
 
-    auto ws = toWString(s);
-    element->edata()[ws].as_uint32() = value;
+    auto id = ElementData::attributeID(s);
+    element->edata()[id].as_uint32() = value;
 }
 
 uint32 Element::lua_getUIDDataU32(const uint32 UID, const std::string& s) const
@@ -309,8 +448,8 @@ uint32 Element::lua_getUIDDataU32(const uint32 UID, const std::string& s) const
     const auto* element = dynamic_cast<const Element*>(entity);
     returnif (element == nullptr) 0u;
 
-    auto ws = toWString(s);
-    return element->edata().at(ws).as_uint32();
+    auto id = ElementData::attributeID(s);
+    return element->edata().at(id).as_uint32();
 }
 
 //----- Animation
@@ -1,31 +1,109 @@
 #include "dungeon/elements/elementdata.hpp"
 
-#include <stdexcept>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 using namespace dungeon;
 
+namespace
+{
+    //! All interned attribute names.
+    //! Note: Constructed on first use, as IDs might be resolved during static initialization.
+    //! Note: Shared by the AI workers and the autosave thread, names are never moved once interned.
+    struct SymbolTable
+    {
+        std::unordered_map<std::wstring, AttributeID> ids;      //!< ID from name.
+        std::unordered_map<std::string, AttributeID> narrowIds; //!< ID from name, as given by lua.
+        std::deque<std::wstring> names;                         //!< Name from ID.
+        std::shared_timed_mutex mutex;                          //!< Readers share it, interning is exclusive.
+    };
+
+    SymbolTable& symbolTable()
+    {
+        static SymbolTable symbolTable;
+        return symbolTable;
+    }
+}
+
+//----------------------------//
+//----- Static variables -----//
+
+const AttributeID attributes::rx = ElementData::attributeID(L"rx");
+const AttributeID attributes::ry = ElementData::attributeID(L"ry");
+const AttributeID attributes::tx = ElementData::attributeID(L"tx");
+const AttributeID attributes::ty = ElementData::attributeID(L"ty");
+const AttributeID attributes::dosh = ElementData::attributeID(L"dosh");
+
 //------------------------//
 //----- Manipulation -----//
 
 void ElementData::clear()
 {
     m_exists = false;
-    m_attributes.clear();
+    m_ids.clear();
+    m_values.clear();
 }
 
 void ElementData::create(std::wstring type)
 {
-    m_attributes.clear();
+    m_ids.clear();
+    m_values.clear();
     m_type = std::move(type);
     m_exists = true;
 }
 
-bool ElementData::exists(const std::wstring& name) const
+//-------------------//
+//----- Symbols -----//
+
+AttributeID ElementData::attributeID(const std::wstring& name)
+{
+    auto& table = symbolTable();
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(table.mutex);
+        auto found = table.ids.find(name);
+        returnif (found != std::end(table.ids)) found->second;
+    }
+
+    // Someone might have interned it meanwhile
+    std::lock_guard<std::shared_timed_mutex> lock(table.mutex);
+    auto found = table.ids.find(name);
+    returnif (found != std::end(table.ids)) found->second;
+
+    auto id = static_cast<AttributeID>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids[name] = id;
+    return id;
+}
+
+AttributeID ElementData::attributeID(const std::string& name)
 {
-    returnif (!m_exists) false;
-    auto found = m_attributes.find(name);
-    returnif (found == std::end(m_attributes)) false;
-    return !found->second.type().empty();
+    auto& table = symbolTable();
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(table.mutex);
+        auto found = table.narrowIds.find(name);
+        returnif (found != std::end(table.narrowIds)) found->second;
+    }
+
+    auto id = attributeID(toWString(name));
+    std::lock_guard<std::shared_timed_mutex> lock(table.mutex);
+    table.narrowIds[name] = id;
+    return id;
+}
+
+bool ElementData::attributeInterned(AttributeID id)
+{
+    auto& table = symbolTable();
+    std::shared_lock<std::shared_timed_mutex> lock(table.mutex);
+    return id < table.names.size();
+}
+
+const std::wstring& ElementData::attributeName(AttributeID id)
+{
+    auto& table = symbolTable();
+    std::shared_lock<std::shared_timed_mutex> lock(table.mutex);
+    return table.names[id];
 }
 
 //---------------------------//
@@ -39,33 +117,34 @@ void ElementData::saveXML(pugi::xml_node& node) const
     node.append_attribute(L"type") = m_type.c_str();
 
     // Export all its attributes
-    for (const auto& attribute : m_attributes) {
-        const auto& type = attribute.second.type();
-        auto child = node.append_child(attribute.first.c_str());
-        child.append_attribute(L"type") = type.c_str();
+    for (uint i = 0u; i < m_ids.size(); ++i) {
+        const auto& value = m_values[i];
+        const auto type = value.type();
+        auto child = node.append_child(attributeName(m_ids[i]).c_str());
+        child.append_attribute(L"type") = metaTypeName(type);
 
-        if (type == L"bool")       child.append_attribute(L"value") = attribute.second.as_bool();
+        if (type == MetaType::BOOL)       child.append_attribute(L"value") = value.as_bool();
 
-        else if (type == L"int8")  child.append_attribute(L"value") = static_cast<int>(attribute.second.as_int8());
-        else if (type == L"int16") child.append_attribute(L"value") = static_cast<int>(attribute.second.as_int16());
-        else if (type == L"int32") child.append_attribute(L"value") = static_cast<int>(attribute.second.as_int32());
-        else if (type == L"int64") child.append_attribute(L"value") = static_cast<long long>(attribute.second.as_int64());
+        else if (type == MetaType::INT8)  child.append_attribute(L"value") = static_cast<int>(value.as_int8());
+        else if (type == MetaType::INT16) child.append_attribute(L"value") = static_cast<int>(value.as_int16());
+        else if (type == MetaType::INT32) child.append_attribute(L"value") = static_cast<int>(value.as_int32());
+        else if (type == MetaType::INT64) child.append_attribute(L"value") = static_cast<long long>(value.as_int64());
 
-        else if (type == L"uint8")  child.append_attribute(L"value") = static_cast<unsigned int>(attribute.second.as_uint8());
-        else if (type == L"uint16") child.append_attribute(L"value") = static_cast<unsigned int>(attribute.second.as_uint16());
-        else if (type == L"uint32") child.append_attribute(L"value") = static_cast<unsigned int>(attribute.second.as_uint32());
-        else if (type == L"uint64") child.append_attribute(L"value") = static_cast<unsigned long long>(attribute.second.as_uint64());
+        else if (type == MetaType::UINT8)  child.append_attribute(L"value") = static_cast<unsigned int>(value.as_uint8());
+        else if (type == MetaType::UINT16) child.append_attribute(L"value") = static_cast<unsigned int>(value.as_uint16());
+        else if (type == MetaType::UINT32) child.append_attribute(L"value") = static_cast<unsigned int>(value.as_uint32());
+        else if (type == MetaType::UINT64) child.append_attribute(L"value") = static_cast<unsigned long long>(value.as_uint64());
 
-        else if (type == L"float")  child.append_attribute(L"value") = attribute.second.as_float();
-        else if (type == L"double") child.append_attribute(L"value") = attribute.second.as_double();
+        else if (type == MetaType::FLOAT)  child.append_attribute(L"value") = value.as_float();
+        else if (type == MetaType::DOUBLE) child.append_attribute(L"value") = value.as_double();
 
-        else if (type == L"v2uint8") {
-            const auto& v = attribute.second.as_v2uint8();
+        else if (type == MetaType::V2UINT8) {
+            const auto& v = value.as_v2uint8();
             child.append_attribute(L"x") = static_cast<unsigned int>(v.x);
             child.append_attribute(L"y") = static_cast<unsigned int>(v.y);
         }
-        else if (type == L"v2float") {
-            const auto& v = attribute.second.as_v2float();
+        else if (type == MetaType::V2FLOAT) {
+            const auto& v = value.as_v2float();
             child.append_attribute(L"x") = v.x;
             child.append_attribute(L"y") = v.y;
         }
@@ -89,37 +168,129 @@ void ElementData::loadXML(const pugi::xml_node& node)
         if (!child.attribute(L"type"))
             continue;
 
-        std::wstring name = child.name();
-        std::wstring type = child.attribute(L"type").as_string();
-        m_attributes[name].setType(type);
+        auto type = metaTypeFromName(child.attribute(L"type").as_string());
+        auto& attribute = operator[](attributeID(child.name()));
+        attribute.setType(type);
 
-        if (type == L"bool")       m_attributes[name] = child.attribute(L"value").as_bool();
+        if (type == MetaType::BOOL)       attribute = child.attribute(L"value").as_bool();
 
-        else if (type == L"int8")  m_attributes[name] = static_cast<int8>(child.attribute(L"value").as_int());
-        else if (type == L"int16") m_attributes[name] = static_cast<int16>(child.attribute(L"value").as_int());
-        else if (type == L"int32") m_attributes[name] = static_cast<int32>(child.attribute(L"value").as_int());
-        else if (type == L"int64") m_attributes[name] = static_cast<int64>(child.attribute(L"value").as_llong());
+        else if (type == MetaType::INT8)  attribute = static_cast<int8>(child.attribute(L"value").as_int());
+        else if (type == MetaType::INT16) attribute = static_cast<int16>(child.attribute(L"value").as_int());
+        else if (type == MetaType::INT32) attribute = static_cast<int32>(child.attribute(L"value").as_int());
+        else if (type == MetaType::INT64) attribute = static_cast<int64>(child.attribute(L"value").as_llong());
 
-        else if (type == L"uint8")  m_attributes[name] = static_cast<uint8>(child.attribute(L"value").as_uint());
-        else if (type == L"uint16") m_attributes[name] = static_cast<uint16>(child.attribute(L"value").as_uint());
-        else if (type == L"uint32") m_attributes[name] = static_cast<uint32>(child.attribute(L"value").as_uint());
-        else if (type == L"uint64") m_attributes[name] = static_cast<uint64>(child.attribute(L"value").as_ullong());
+        else if (type == MetaType::UINT8)  attribute = static_cast<uint8>(child.attribute(L"value").as_uint());
+        else if (type == MetaType::UINT16) attribute = static_cast<uint16>(child.attribute(L"value").as_uint());
+        else if (type == MetaType::UINT32) attribute = static_cast<uint32>(child.attribute(L"value").as_uint());
+        else if (type == MetaType::UINT64) attribute = static_cast<uint64>(child.attribute(L"value").as_ullong());
 
-        else if (type == L"float")  m_attributes[name] = child.attribute(L"value").as_float();
-        else if (type == L"double") m_attributes[name] = child.attribute(L"value").as_double();
+        else if (type == MetaType::FLOAT)  attribute = child.attribute(L"value").as_float();
+        else if (type == MetaType::DOUBLE) attribute = child.attribute(L"value").as_double();
 
-        else if (type == L"v2uint8") {
+        else if (type == MetaType::V2UINT8) {
             Vec2<uint8> v;
             v.x = child.attribute(L"x").as_uint();
             v.y = child.attribute(L"y").as_uint();
-            m_attributes[name] = v;
+            attribute = v;
         }
-        else if (type == L"v2float") {
+        else if (type == MetaType::V2FLOAT) {
             Vec2<float> v;
             v.x = child.attribute(L"x").as_float();
             v.y = child.attribute(L"y").as_float();
-            m_attributes[name] = v;
+            attribute = v;
         }
         else mquit("Some MetaData (loadXML) has an invalid type.");
     }
 }
+
+//------------------------------//
+//----- Binary interaction -----//
+
+void ElementData::saveBinary(BinaryWriter& writer) const
+{
+    writer.write(m_exists);
+    returnif (!m_exists);
+
+    writer.write(m_type);
+    writer.write(static_cast<uint16>(m_ids.size()));
+
+    // Names are saved, as IDs are only valid for this run
+    for (uint i = 0u; i < m_ids.size(); ++i) {
+        const auto& value = m_values[i];
+        const auto type = value.type();
+        writer.write(attributeName(m_ids[i]));
+        writer.write(static_cast<uint8>(type));
+
+        if (type == MetaType::BOOL)       writer.write(value.as_bool());
+
+        else if (type == MetaType::INT8)  writer.write(static_cast<int32>(value.as_int8()));
+        else if (type == MetaType::INT16) writer.write(static_cast<int32>(value.as_int16()));
+        else if (type == MetaType::INT32) writer.write(value.as_int32());
+        else if (type == MetaType::INT64) writer.write(value.as_int64());
+
+        else if (type == MetaType::UINT8)  writer.write(value.as_uint8());
+        else if (type == MetaType::UINT16) writer.write(value.as_uint16());
+        else if (type == MetaType::UINT32) writer.write(value.as_uint32());
+        else if (type == MetaType::UINT64) writer.write(value.as_uint64());
+
+        else if (type == MetaType::FLOAT)  writer.write(value.as_float());
+        else if (type == MetaType::DOUBLE) writer.write(value.as_double());
+
+        else if (type == MetaType::V2UINT8) {
+            writer.write(value.as_v2uint8().x);
+            writer.write(value.as_v2uint8().y);
+        }
+        else if (type == MetaType::V2FLOAT) {
+            writer.write(value.as_v2float().x);
+            writer.write(value.as_v2float().y);
+        }
+
+        else mquit("Some MetaData (saveBinary) has an invalid type.");
+    }
+}
+
+void ElementData::loadBinary(BinaryReader& reader)
+{
+    // Reset state
+    clear();
+    returnif (!reader.readBool());
+
+    m_exists = true;
+    m_type = reader.readWString();
+
+    uint attributesCount = reader.readUint16();
+    m_ids.reserve(attributesCount);
+    m_values.reserve(attributesCount);
+
+    for (uint i = 0u; i < attributesCount && !reader.failed(); ++i) {
+        auto id = attributeID(reader.readWString());
+        auto type = static_cast<MetaType>(reader.readUint8());
+        auto& data = operator[](id).setType(type);
+
+        if (type == MetaType::BOOL)       data.as_bool = reader.readBool();
+
+        else if (type == MetaType::INT8)  data.as_int8 = static_cast<int8>(reader.readInt32());
+        else if (type == MetaType::INT16) data.as_int16 = static_cast<int16>(reader.readInt32());
+        else if (type == MetaType::INT32) data.as_int32 = reader.readInt32();
+        else if (type == MetaType::INT64) data.as_int64 = reader.readInt64();
+
+        else if (type == MetaType::UINT8)  data.as_uint8 = reader.readUint8();
+        else if (type == MetaType::UINT16) data.as_uint16 = reader.readUint16();
+        else if (type == MetaType::UINT32) data.as_uint32 = reader.readUint32();
+        else if (type == MetaType::UINT64) data.as_uint64 = reader.readUint64();
+
+        else if (type == MetaType::FLOAT)  data.as_float = reader.readFloat();
+        else if (type == MetaType::DOUBLE) data.as_double = reader.readDouble();
+
+        else if (type == MetaType::V2UINT8) {
+            data.as_v2uint8.x = reader.readUint8();
+            data.as_v2uint8.y = reader.readUint8();
+        }
+        else if (type == MetaType::V2FLOAT) {
+            data.as_v2float.x = reader.readFloat();
+            data.as_v2float.y = reader.readFloat();
+        }
+
+        else mquit("Some MetaData (loadBinary) has an invalid type.");
+    }
+}
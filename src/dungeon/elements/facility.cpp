@@ -26,65 +26,72 @@ Facility::Facility(const RoomCoords& coords, ElementData& edata, dungeon::Inter&
     // FIXME We're all vanilla for now, but sElementID should probably hold the modID too
     m_sprite.load("vanilla/facilities/" + sElementID + "/anim");
 
-    // Lua API
-    lua()["eev_hasSiblingFacility"] = [this] (const std::string& facilityID) { return lua_hasSiblingFacility(facilityID); };
-    lua()["eev_getSiblingFacility"] = [this] (const std::string& facilityID) { return lua_getSiblingFacility(facilityID); };
+    // Load lua file
+    std::string luaFilename = "res/vanilla/facilities/" + sElementID + "/ai.lua";
+    if (!loadLua(luaFilename))
+        mquit("Failed to load Lua file: '" + luaFilename + "'. It might be a syntax error or a missing file.");
+    lua()["_register"]();
+}
+
+Facility::~Facility()
+{
+    // Might not exist
+    removeComponent<scene::LightEmitter>();
+
+    // Remove all our locks
+    m_inter.facilityRoomLocksClear(m_coords, m_elementID);
+}
+
+//-------------------//
+//----- Lua API -----//
+
+void Facility::registerLuaAPI(scene::LuaVM& vm)
+{
+    baseClass::registerLuaAPI(vm);
+
+    luaBind(vm, "eev_hasSiblingFacility", &Facility::lua_hasSiblingFacility);
+    luaBind(vm, "eev_getSiblingFacility", &Facility::lua_getSiblingFacility);
 
-    lua()["eev_facilityExists"] = [this] (const uint32 x, const uint32 y, const std::string& facilityID) { return lua_facilityExists(x, y, facilityID); };
-    lua()["eev_facilityExistsRelative"] = [this] (const int x, const int y, const std::string& facilityID) { return lua_facilityExistsRelative(x, y, facilityID); };
+    luaBind(vm, "eev_facilityExists", &Facility::lua_facilityExists);
+    luaBind(vm, "eev_facilityExistsRelative", &Facility::lua_facilityExistsRelative);
 
-    lua()["eev_getCurrentRoomX"] = [this] { return lua_getCurrentRoomX(); };
-    lua()["eev_getCurrentRoomY"] = [this] { return lua_getCurrentRoomY(); };
-    lua()["eev_hasTreasure"] = [this] { return lua_hasTreasure(); };
-    lua()["eev_setTreasure"] = [this] (const uint32 value) { lua_setTreasure(value); };
+    luaBind(vm, "eev_getCurrentRoomX", &Facility::lua_getCurrentRoomX);
+    luaBind(vm, "eev_getCurrentRoomY", &Facility::lua_getCurrentRoomY);
+    luaBind(vm, "eev_hasTreasure", &Facility::lua_hasTreasure);
+    luaBind(vm, "eev_setTreasure", &Facility::lua_setTreasure);
 
     // Links
-    lua()["eev_linkExists"]   = [this] (uint32 linkID) { return lua_linkExists(linkID); };
-    lua()["eev_linkGet"]      = [this] (uint32 linkID) { return lua_linkGet(linkID); };
-    lua()["eev_linkRedirect"] = [this] (uint32 linkID, uint32 linkX, uint32 linkY) { lua_linkRedirect(linkID, linkX, linkY); };
+    luaBind(vm, "eev_linkExists", &Facility::lua_linkExists);
+    luaBind(vm, "eev_linkGet", &Facility::lua_linkGet);
+    luaBind(vm, "eev_linkRedirect", &Facility::lua_linkRedirect);
 
-    lua()["eev_linksAdd"] = [this] (uint32 linkX, uint32 linkY) { lua_linksAdd(linkX, linkY); };
-    lua()["eev_linksRemove"] = [this] (uint32 linkID) { lua_linksRemove(linkID); };
-    lua()["eev_linksLastBind"] = [this] (uint32 linkID) { lua_linksLastBind(linkID); };
+    luaBind(vm, "eev_linksAdd", &Facility::lua_linksAdd);
+    luaBind(vm, "eev_linksRemove", &Facility::lua_linksRemove);
+    luaBind(vm, "eev_linksLastBind", &Facility::lua_linksLastBind);
 
-    lua()["eev_facilityLinksAdd"] = [this] (uint32 x, uint32 y, const std::string& facilityID, uint32 linkX, uint32 linkY) { lua_facilityLinksAdd(x, y, facilityID, linkX, linkY); };
-    lua()["eev_facilityLinksRemove"] = [this] (uint32 x, uint32 y, const std::string& facilityID, uint32 linkID) { lua_facilityLinksRemove(x, y, facilityID, linkID); };
-    lua()["eev_facilityLinksLastBind"] = [this] (uint32 x, uint32 y, const std::string& facilityID, uint32 linkID) { lua_facilityLinksLastBind(x, y, facilityID, linkID); };
+    luaBind(vm, "eev_facilityLinksAdd", &Facility::lua_facilityLinksAdd);
+    luaBind(vm, "eev_facilityLinksRemove", &Facility::lua_facilityLinksRemove);
+    luaBind(vm, "eev_facilityLinksLastBind", &Facility::lua_facilityLinksLastBind);
 
     // Energy
-    lua()["eev_energySendPulseRoom"] = [this] (const uint32 x, const uint32 y) { return lua_energySendPulseRoom(x, y); };
+    luaBind(vm, "eev_energySendPulseRoom", &Facility::lua_energySendPulseRoom);
 
     // Tunnels
-    lua()["eev_hasTunnel"] = [this] { return lua_hasTunnel(); };
-    lua()["eev_addTunnel"] = [this] (const int32 x, const int32 y, bool relative) { lua_addTunnel(x, y, relative); };
-    lua()["eev_removeTunnels"] = [this] { lua_removeTunnels(); };
+    luaBind(vm, "eev_hasTunnel", &Facility::lua_hasTunnel);
+    luaBind(vm, "eev_addTunnel", &Facility::lua_addTunnel);
+    luaBind(vm, "eev_removeTunnels", &Facility::lua_removeTunnels);
 
     // Barriers
-    lua()["eev_hasBarrier"] = [this] { return lua_hasBarrier(); };
-    lua()["eev_setBarrier"] = [this] (bool activated) { lua_setBarrier(activated); };
+    luaBind(vm, "eev_hasBarrier", &Facility::lua_hasBarrier);
+    luaBind(vm, "eev_setBarrier", &Facility::lua_setBarrier);
 
     // Room locks
-    lua()["eev_roomLocksClear"] = [this] () { lua_roomLocksClear(); };
-    lua()["eev_roomLocksAdd"] = [this] (const uint x, const uint y) { lua_roomLocksAdd(x, y); };
+    luaBind(vm, "eev_roomLocksClear", &Facility::lua_roomLocksClear);
+    luaBind(vm, "eev_roomLocksAdd", &Facility::lua_roomLocksAdd);
 
     // Lighting
-    lua()["eev_lightAddPoint"] = [this] (lua_Number x, lua_Number y, lua_Number s) { return lua_lightAddPoint(x, y, s); };
-    lua()["eev_lightSetColor"] = [this] (uint32 lightID, uint r, uint g, uint b) { return lua_lightSetColor(lightID, r, g, b); };
-
-    // Load lua file
-    std::string luaFilename = "res/vanilla/facilities/" + sElementID + "/ai.lua";
-    if (!lua().load(luaFilename))
-        mquit("Failed to load Lua file: '" + luaFilename + "'. It might be a syntax error or a missing file.");
-    lua()["_register"]();
-}
-
-Facility::~Facility()
-{
-    // Might not exist
-    removeComponent<scene::LightEmitter>();
-
-    // Remove all our locks
-    m_inter.facilityRoomLocksClear(m_coords, m_elementID);
+    luaBind(vm, "eev_lightAddPoint", &Facility::lua_lightAddPoint);
+    luaBind(vm, "eev_lightSetColor", &Facility::lua_lightSetColor);
 }
 
 //------------------------//
@@ -255,7 +262,7 @@ void Facility::lua_removeTunnels()
 {
     // TODO Let data do that properly...
     m_facilityInfo->tunnels.clear();
-    m_inter.data().addEvent("dungeon_changed", m_coords);
+    m_inter.data().addEvent(events::dungeonChanged, m_coords);
 }
 
 //----- Barrier
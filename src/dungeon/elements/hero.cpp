@@ -12,13 +12,23 @@
 
 using namespace dungeon;
 
-Hero::Hero(HeroesManager& manager, Inter& inter, Graph& graph)
+Hero::Hero(HeroesManager& manager, uint32 managerHandle, Inter& inter, Graph& graph)
     : baseClass("vanilla/heroes/", inter, graph)
     , m_manager(manager)
+    , m_managerHandle(managerHandle)
 {
-    // Lua API
-    lua()["eev_getOut"] = [this] { lua_getOut(); };
-    lua()["eev_stealTreasure"] = [this] { return lua_stealTreasure(); };
+}
+
+//-------------------//
+//----- Lua API -----//
+
+void Hero::registerLuaAPI(scene::LuaVM& vm)
+{
+    baseClass::registerLuaAPI(vm);
+
+    luaBindDeferred(vm, "eev_getOut", &Hero::lua_getOut);
+    luaBindSerial(vm, "eev_stealTreasure", &Hero::lua_stealTreasure);
+    luaBindDeferred(vm, "eev_stealTreasureInto", &Hero::lua_stealTreasureInto);
 }
 
 //----------------------//
@@ -61,6 +71,11 @@ void Hero::lua_getOut()
 uint Hero::lua_stealTreasure()
 {
     auto maxStolenDosh = std::min(100u, m_currentNode->treasure);
-    auto stolenDosh = 1u + rand() % maxStolenDosh;
+    auto stolenDosh = alea::rand(1u, maxStolenDosh, alea::Stream::ELEMENTS);
     return m_manager.heroStealsTreasure(this, m_currentNode->coords, stolenDosh);
 }
+
+void Hero::lua_stealTreasureInto(const std::string& attribute)
+{
+    lua_addDataU32(attribute, lua_stealTreasure());
+}
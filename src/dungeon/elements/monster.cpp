@@ -5,8 +5,9 @@
 
 using namespace dungeon;
 
-Monster::Monster(Inter& inter, Graph& graph)
+Monster::Monster(uint32 managerHandle, Inter& inter, Graph& graph)
     : baseClass("vanilla/monsters/", inter, graph)
+    , m_managerHandle(managerHandle)
 {
 }
 
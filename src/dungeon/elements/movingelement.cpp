@@ -5,20 +5,32 @@
 #include "scene/components/lerpable.hpp"
 #include "tools/random.hpp"
 
+#include <algorithm>
+#include <iostream>
+
 using namespace dungeon;
 
+namespace
+{
+    //! The fields of a weight, as the eev_weight getters are named.
+    const char* const weightFields[] = {"visited", "lastVisit", "altitude", "treasure", "exit",
+                                        "exitDistance", "treasureDistance", "x", "y"};
+
+    //! An eev_weight getter, returning the field (second upvalue) of the values table (first upvalue).
+    int weightGetter(lua_State* L)
+    {
+        lua_pushvalue(L, lua_upvalueindex(2));
+        lua_rawget(L, lua_upvalueindex(1));
+        return 1;
+    }
+}
+
 MovingElement::MovingElement(std::string folder, Inter& inter, Graph& graph)
     : baseClass(inter)
     , m_graph(graph)
     , m_folder(std::move(folder))
 {
     addComponent<scene::Lerpable>(*this);
-
-    // Lua API
-    lua()["eev_setMoving"] = [this] (bool moving) { lua_setMoving(moving); };
-    lua()["eev_isLookingDirection"] = [this] (const std::string& direction) { return lua_isLookingDirection(direction); };
-    lua()["eev_getCurrentRoomX"] = [this] { return lua_getCurrentRoomX(); };
-    lua()["eev_getCurrentRoomY"] = [this] { return lua_getCurrentRoomY(); };
 }
 
 MovingElement::~MovingElement()
@@ -26,26 +38,46 @@ MovingElement::~MovingElement()
     removeComponent<scene::Lerpable>();
 }
 
+//-------------------//
+//----- Lua API -----//
+
+void MovingElement::registerLuaAPI(scene::LuaVM& vm)
+{
+    baseClass::registerLuaAPI(vm);
+
+    luaBindDeferred(vm, "eev_setMoving", &MovingElement::lua_setMoving);
+    luaBind(vm, "eev_isLookingDirection", &MovingElement::lua_isLookingDirection);
+    luaBind(vm, "eev_getCurrentRoomX", &MovingElement::lua_getCurrentRoomX);
+    luaBind(vm, "eev_getCurrentRoomY", &MovingElement::lua_getCurrentRoomY);
+    luaBind(vm, "eev_pathNext", &MovingElement::lua_pathNext);
+    luaBind(vm, "eev_distanceTo", &MovingElement::lua_distanceTo);
+}
+
 //------------------//
 //---- Routine -----//
 
 void MovingElement::updateAI(const sf::Time& dt)
 {
-    returnif (!m_moving);
-
-    // Quit if still moving
-    returnif (getComponent<scene::Lerpable>()->positionLerping());
-
-    // Quit if pause intended
-    if (m_pauseTime >= 0.f) {
-        m_pauseTime += dt.asSeconds();
-        returnif (m_pauseTime < m_pauseDelay);
-        m_pauseTime = -1.f;
+    // Decided beforehand, recorded calls are applied first, as if done meanwhile
+    if (m_decision.pending) {
+        m_decision.pending = false;
+        applyDeferredCalls();
+        returnif (!m_decision.due || !m_moving);
+
+        if (m_currentNode != nullptr) {
+            // The graph changed since, the node was already visited though
+            if (m_decision.graphVersion != m_graph.version() || m_decision.node != m_currentNode)
+                findBestNodes(m_currentNode);
+            setCurrentNode(alea::rand(m_bestNodes, alea::Stream::ELEMENTS));
+        }
     }
+    else {
+        returnif (!aiDue(dt));
 
-    // Get next room
-    if (m_currentNode != nullptr)
-        setCurrentNode(findNextNode(m_currentNode));
+        // Get next room
+        if (m_currentNode != nullptr)
+            setCurrentNode(findNextNode(m_currentNode));
+    }
 
     // Forward to lua
     lua()["_update"](static_cast<lua_Number>(dt.asSeconds()));
@@ -55,48 +87,87 @@ void MovingElement::updateRoutine(const sf::Time& dt)
 {
     // Update to current position
     auto relPosition = m_inter.relCoordsFromPosition(localPosition());
-    m_edata->operator[](L"rx").as_float() = relPosition.x;
-    m_edata->operator[](L"ry").as_float() = relPosition.y;
+    m_edata->operator[](attributes::rx).as_float() = relPosition.x;
+    m_edata->operator[](attributes::ry).as_float() = relPosition.y;
 
     baseClass::updateRoutine(dt);
     updateAI(dt);
 }
 
+//--------------------//
+//----- Decision -----//
+
+void MovingElement::decide(const sf::Time& dt)
+{
+    m_decision.pending = true;
+    m_decision.due = aiDue(dt);
+    m_decision.node = nullptr;
+    returnif (!m_decision.due || m_currentNode == nullptr);
+
+    setDeferring(true);
+    visit(m_currentNode);
+    findBestNodes(m_currentNode);
+    setDeferring(false);
+
+    m_decision.graphVersion = m_graph.version();
+    m_decision.node = m_currentNode;
+}
+
 //-------------------------------//
 //----- Graph AI evaluation -----//
 
 MovingElement::NodeWay MovingElement::findNextNode(const Graph::NodeData* currentNode)
 {
-    NodeWay nodeWay;
-
     // That's not a node...
-    returnif (currentNode == nullptr) nodeWay;
+    returnif (currentNode == nullptr) NodeWay();
+
+    visit(currentNode);
+    findBestNodes(currentNode);
+
+    // Return a new node randomly from the best ones
+    return alea::rand(m_bestNodes, alea::Stream::ELEMENTS);
+}
 
+void MovingElement::visit(const Graph::NodeData* node)
+{
     // First visit to this node
-    if (m_nodeInfos[currentNode->coords].visits == 0u)
+    auto& info = nodeInfo(node->coords);
+    if (info.visits == 0u)
         lua()["nonVisitedNodes"] = static_cast<uint>(lua()["nonVisitedNodes"]) - 1u;
 
-    m_nodeInfos[currentNode->coords].visits += 1u;
-    m_nodeInfos[currentNode->coords].lastVisit = m_tick++;
+    info.visits += 1u;
+    info.lastVisit = m_tick++;
+}
 
-    // No neighbours
+void MovingElement::findBestNodes(const Graph::NodeData* currentNode)
+{
+    NodeWay nodeWay;
     nodeWay.nodeData = currentNode;
-    returnif (currentNode->node->neighbours.size() == 0u) nodeWay;
+    m_bestNodes.clear();
+
+    // No neighbours
+    const auto& neighbours = currentNode->node->neighbours;
+    if (neighbours.size() == 0u) {
+        m_bestNodes.emplace_back(std::move(nodeWay));
+        return;
+    }
+
+    // Get the evaluations from lua
+    evaluate(currentNode, m_evaluations);
 
     // Consider that the current room might be the best node
-    std::vector<NodeWay> bestNodes;
-    int maxEvaluation = call("_evaluateReference", currentNode);
-    bestNodes.emplace_back(std::move(nodeWay));
+    int maxEvaluation = m_evaluations.front();
+    m_bestNodes.emplace_back(std::move(nodeWay));
 
-    // Get the evaluation from lua
-    for (const auto& neighbour : currentNode->node->neighbours) {
+    for (uint i = 0u; i < neighbours.size(); ++i) {
+        const auto& neighbour = neighbours[i];
         auto nodeData = reinterpret_cast<const Graph::NodeData*>(neighbour.node->data);
-        int evaluation = call("_evaluate", nodeData);
+        int evaluation = m_evaluations[i + 1u];
 
         // Found a new limit for the best nodes
         if (evaluation > maxEvaluation) {
             maxEvaluation = evaluation;
-            bestNodes.clear();
+            m_bestNodes.clear();
         }
 
         // This node is among the best ones
@@ -104,12 +175,84 @@ MovingElement::NodeWay MovingElement::findNextNode(const Graph::NodeData* curren
             auto neighbourData = reinterpret_cast<const Graph::NeighbourData*>(neighbour.data);
             nodeWay.nodeData = nodeData;
             nodeWay.neighbourData = neighbourData;
-            bestNodes.emplace_back(std::move(nodeWay));
+            m_bestNodes.emplace_back(std::move(nodeWay));
         }
     }
+}
 
-    // Return a new node randomly from the best ones
-    return alea::rand(bestNodes);
+void MovingElement::evaluate(const Graph::NodeData* currentNode, std::vector<int>& evaluations)
+{
+    returnif (evaluateAll(currentNode, evaluations));
+
+    // Legacy scripts, one call per node
+    const auto& neighbours = currentNode->node->neighbours;
+    evaluations.resize(neighbours.size() + 1u);
+    evaluations[0u] = call("_evaluateReference", currentNode);
+    for (uint i = 0u; i < neighbours.size(); ++i)
+        evaluations[i + 1u] = call("_evaluate", reinterpret_cast<const Graph::NodeData*>(neighbours[i].node->data));
+}
+
+bool MovingElement::evaluateAll(const Graph::NodeData* currentNode, std::vector<int>& evaluations)
+{
+    auto scope = lua();
+    auto L = scope.raw();
+
+    lua_getglobal(L, "_evaluateAll");
+    if (!lua_isfunction(L, -1)) {
+        lua_pop(L, 1);
+        return false;
+    }
+
+    // The array of weights, kept in the instance environment to reuse its tables
+    lua_getglobal(L, "eev_weights");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "eev_weights");
+    }
+
+    // The current node first, then the neighbours
+    const auto& neighbours = currentNode->node->neighbours;
+    const uint count = neighbours.size() + 1u;
+    for (uint i = 0u; i < count; ++i) {
+        auto nodeData = (i == 0u)? currentNode : reinterpret_cast<const Graph::NodeData*>(neighbours[i - 1u].node->data);
+
+        lua_rawgeti(L, -1, i + 1u);
+        if (!lua_istable(L, -1)) {
+            lua_pop(L, 1);
+            lua_createtable(L, 0, 9);
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, -3, i + 1u);
+        }
+
+        pushWeight(L, getWeight(nodeData));
+        lua_pop(L, 1);
+    }
+
+    // Records from a previous bigger neighbourhood are hidden
+    lua_pushnil(L);
+    lua_rawseti(L, -2, count + 1u);
+
+    // The evaluations are returned as an array
+    evaluations.assign(count, 0);
+    lua_pushinteger(L, count);
+    if (lua_pcall(L, 2, 1, 0) != LUA_OK) {
+        std::cerr << "/!\\ LUA " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return true;
+    }
+
+    if (lua_istable(L, -1)) {
+        for (uint i = 0u; i < count; ++i) {
+            lua_rawgeti(L, -1, i + 1u);
+            evaluations[i] = static_cast<int>(lua_tonumber(L, -1));
+            lua_pop(L, 1);
+        }
+    }
+
+    lua_pop(L, 1);
+    return true;
 }
 
 //---------------------------//
@@ -127,6 +270,26 @@ bool MovingElement::lua_isLookingDirection(const std::string& direction) const
     else mquit("Unknown direction '" + direction + "' from LUA isLookingDirection().");
 }
 
+std::tuple<uint32, uint32> MovingElement::lua_pathNext(uint32 x, uint32 y)
+{
+    returnif (m_currentNode == nullptr) std::make_tuple(x, y);
+
+    // A room outside the dungeon has no way to it
+    const auto& coords = m_currentNode->coords;
+    returnif (x >= m_graph.floorsCount() || y >= m_graph.floorRoomsCount()) std::make_tuple(coords.x, coords.y);
+
+    auto nextNode = m_graph.nextTowards(coords, {static_cast<uint8>(x), static_cast<uint8>(y)});
+    if (nextNode == nullptr) return std::make_tuple(coords.x, coords.y);
+    return std::make_tuple(nextNode->coords.x, nextNode->coords.y);
+}
+
+uint32 MovingElement::lua_distanceTo(uint32 x, uint32 y)
+{
+    returnif (m_currentNode == nullptr) -1u;
+    returnif (x >= m_graph.floorsCount() || y >= m_graph.floorRoomsCount()) -1u;
+    return m_graph.distance(m_currentNode->coords, {static_cast<uint8>(x), static_cast<uint8>(y)});
+}
+
 //---------------------------//
 //----- Node management -----//
 
@@ -180,7 +343,7 @@ void MovingElement::setCurrentNode(const NodeWay& nodeWay)
 
 void MovingElement::updateFromGraph()
 {
-    RoomRelCoords relCoords(m_edata->operator[](L"tx").as_float(), m_edata->operator[](L"ty").as_float());
+    RoomRelCoords relCoords(m_edata->operator[](attributes::tx).as_float(), m_edata->operator[](attributes::ty).as_float());
     auto coords = toCoords(relCoords);
     auto nodeData = m_graph.nodeData(coords);
 
@@ -188,8 +351,8 @@ void MovingElement::updateFromGraph()
     // by resetting the current node to the current position
     if (nodeData == nullptr || nodeData->constructed == false) {
         setNewTargetPosition(localPosition());
-        relCoords.x = m_edata->operator[](L"tx").as_float();
-        relCoords.y = m_edata->operator[](L"ty").as_float();
+        relCoords.x = m_edata->operator[](attributes::tx).as_float();
+        relCoords.y = m_edata->operator[](attributes::ty).as_float();
         coords = toCoords(relCoords);
         nodeData = m_graph.nodeData(coords);
     }
@@ -202,37 +365,135 @@ void MovingElement::updateFromGraph()
 //-----------------------------------//
 //----- Artificial intelligence -----//
 
+bool MovingElement::aiDue(const sf::Time& dt)
+{
+    returnif (!m_moving) false;
+
+    // Quit if still moving
+    returnif (getComponent<scene::Lerpable>()->positionLerping()) false;
+
+    // Quit if pause intended
+    if (m_pauseTime >= 0.f) {
+        m_pauseTime += dt.asSeconds();
+        returnif (m_pauseTime < m_pauseDelay) false;
+        m_pauseTime = -1.f;
+    }
+
+    return true;
+}
+
 void MovingElement::reinit()
 {
     m_tick = 0u;
     lua()["_init"]();
     lua()["eev_nonVisitedNodes"] = m_graph.uniqueNodesCount();
-    m_nodeInfos.clear();
+
+    // Reset in place, only reallocated if the dungeon size changed
+    resizeNodeInfos();
+    std::fill(std::begin(m_nodeInfos), std::end(m_nodeInfos), NodeInfo());
 }
 
 Monster::Weight MovingElement::getWeight(const Graph::NodeData* node)
 {
     Weight weight;
-    weight.visited =    m_nodeInfos[node->coords].visits;
-    weight.lastVisit =  m_nodeInfos[node->coords].lastVisit;
+    const auto& info = nodeInfo(node->coords);
+    weight.visited =    info.visits;
+    weight.lastVisit =  info.lastVisit;
     weight.altitude =   node->altitude;
     weight.treasure =   node->treasure;
     weight.exit =       node->entrance;
+    weight.exitDistance =       m_graph.entranceDistance(node->coords);
+    weight.treasureDistance =   m_graph.treasureDistance(node->coords);
+    weight.x =          node->coords.x;
+    weight.y =          node->coords.y;
     return weight;
 }
 
+MovingElement::NodeInfo& MovingElement::nodeInfo(const RoomCoords& coords)
+{
+    if (m_nodeInfosFloorsCount != m_graph.floorsCount() || m_nodeInfosFloorRoomsCount != m_graph.floorRoomsCount())
+        resizeNodeInfos();
+
+    return m_nodeInfos[coords.x * m_nodeInfosFloorRoomsCount + coords.y];
+}
+
+void MovingElement::resizeNodeInfos()
+{
+    auto floorsCount = m_graph.floorsCount();
+    auto floorRoomsCount = m_graph.floorRoomsCount();
+    returnif (m_nodeInfosFloorsCount == floorsCount && m_nodeInfosFloorRoomsCount == floorRoomsCount);
+
+    // Rooms keep their coordinates when the dungeon grows or shrinks
+    std::vector<NodeInfo> nodeInfos(floorsCount * floorRoomsCount);
+    for (uint floor = 0u; floor < std::min(floorsCount, m_nodeInfosFloorsCount); ++floor)
+    for (uint room = 0u; room < std::min(floorRoomsCount, m_nodeInfosFloorRoomsCount); ++room)
+        nodeInfos[floor * floorRoomsCount + room] = m_nodeInfos[floor * m_nodeInfosFloorRoomsCount + room];
+
+    m_nodeInfos = std::move(nodeInfos);
+    m_nodeInfosFloorsCount = floorsCount;
+    m_nodeInfosFloorRoomsCount = floorRoomsCount;
+}
+
 uint MovingElement::call(const char* function, const Graph::NodeData* node)
 {
-    Weight weight = getWeight(node);
+    auto scope = lua();
+    auto L = scope.raw();
+
+    pushWeightValues(L);
+    pushWeight(L, getWeight(node));
+    lua_pop(L, 1);
 
-    lua()["eev_weight"].SetObj(weight,
-                               "visited",   &Weight::visited,
-                               "lastVisit", &Weight::lastVisit,
-                               "altitude",  &Weight::altitude,
-                               "treasure",  &Weight::treasure,
-                               "exit",      &Weight::exit);
+    return scope[function]();
+}
+
+void MovingElement::pushWeightValues(lua_State* L)
+{
+    // Already created, the getters share the values table as first upvalue
+    lua_getglobal(L, "eev_weight");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "x");
+        if (lua_tocfunction(L, -1) == weightGetter && lua_getupvalue(L, -1, 1) != nullptr) {
+            lua_replace(L, -3);
+            lua_pop(L, 1);
+            return;
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+
+    // Legacy scripts call eev_weight.altitude(), so fields are getters on a plain values table,
+    // kept in the instance environment, the VM holding nothing pointing to C++ memory
+    lua_createtable(L, 0, 9);
+    lua_createtable(L, 0, 9);
+    for (auto field : weightFields) {
+        lua_pushvalue(L, -2);
+        lua_pushstring(L, field);
+        lua_pushcclosure(L, weightGetter, 2);
+        lua_setfield(L, -2, field);
+    }
+    lua_setglobal(L, "eev_weight");
+}
 
-    return lua()[function]();
+void MovingElement::pushWeight(lua_State* L, const Weight& weight)
+{
+    lua_pushinteger(L, weight.visited);
+    lua_setfield(L, -2, "visited");
+    lua_pushinteger(L, weight.lastVisit);
+    lua_setfield(L, -2, "lastVisit");
+    lua_pushinteger(L, weight.altitude);
+    lua_setfield(L, -2, "altitude");
+    lua_pushinteger(L, weight.treasure);
+    lua_setfield(L, -2, "treasure");
+    lua_pushboolean(L, weight.exit);
+    lua_setfield(L, -2, "exit");
+    lua_pushinteger(L, weight.exitDistance);
+    lua_setfield(L, -2, "exitDistance");
+    lua_pushinteger(L, weight.treasureDistance);
+    lua_setfield(L, -2, "treasureDistance");
+    lua_pushinteger(L, weight.x);
+    lua_setfield(L, -2, "x");
+    lua_pushinteger(L, weight.y);
+    lua_setfield(L, -2, "y");
 }
 
 //-----------------------//
@@ -250,9 +511,9 @@ void MovingElement::bindElementData(ElementData& edata)
     rebindElementData();
 
     // Was there a target position saved?
-    if (!m_edata->exists(L"tx")) {
-        m_edata->operator[](L"tx").init_float(m_edata->operator[](L"rx").as_float());
-        m_edata->operator[](L"ty").init_float(m_edata->operator[](L"ry").as_float());
+    if (!m_edata->exists(attributes::tx)) {
+        m_edata->operator[](attributes::tx).init_float(m_edata->operator[](attributes::rx).as_float());
+        m_edata->operator[](attributes::ty).init_float(m_edata->operator[](attributes::ry).as_float());
     }
 
     // Initial position
@@ -261,6 +522,7 @@ void MovingElement::bindElementData(ElementData& edata)
 
     // Reparameter from inter
     setDetectRangeFactor(m_inter.tileSize().x);
+    setDetectRoomSize(m_inter.tileSize());
 
     // First time or new elementID
     if (firstTime) {
@@ -269,7 +531,7 @@ void MovingElement::bindElementData(ElementData& edata)
 
         // Lua
         std::string luaFilename = "res/" + m_folder + sElementID + "/ai.lua";
-        if (!lua().load(luaFilename))
+        if (!loadLua(luaFilename))
             mquit("Failed to load Lua file: '" + luaFilename + "'. It might be a syntax error or a missing file.");
 
         // Clear all previous callbacks
@@ -291,8 +553,8 @@ void MovingElement::refreshPosition()
 {
     returnif (m_edata == nullptr);
 
-    sf::Vector2f position = m_inter.positionFromRelCoords({m_edata->operator[](L"rx").as_float(), m_edata->operator[](L"ry").as_float()});
-    sf::Vector2f targetPosition  = m_inter.positionFromRelCoords({m_edata->operator[](L"tx").as_float(), m_edata->operator[](L"ty").as_float()});
+    sf::Vector2f position = m_inter.positionFromRelCoords({m_edata->operator[](attributes::rx).as_float(), m_edata->operator[](attributes::ry).as_float()});
+    sf::Vector2f targetPosition  = m_inter.positionFromRelCoords({m_edata->operator[](attributes::tx).as_float(), m_edata->operator[](attributes::ty).as_float()});
     getComponent<scene::Lerpable>()->setTargetPosition(targetPosition);
     setLocalPosition(position);
 }
@@ -305,8 +567,8 @@ void MovingElement::setNewTargetPosition(const sf::Vector2f& targetPosition)
     getComponent<scene::Lerpable>()->setTargetPosition(targetPosition);
 
     auto relTargetPosition = m_inter.relCoordsFromPosition(targetPosition);
-    m_edata->operator[](L"tx").as_float() = relTargetPosition.x;
-    m_edata->operator[](L"ty").as_float() = relTargetPosition.y;
+    m_edata->operator[](attributes::tx).as_float() = relTargetPosition.x;
+    m_edata->operator[](attributes::ty).as_float() = relTargetPosition.y;
 }
 
 void MovingElement::refreshPositionFromNode()
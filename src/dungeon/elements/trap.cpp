@@ -4,7 +4,6 @@
 #include "tools/random.hpp"
 
 using namespace dungeon;
-using namespace std::placeholders;
 
 Trap::Trap(const RoomCoords& coords, ElementData& edata, Inter& inter)
     : baseClass(inter)
@@ -23,19 +22,26 @@ Trap::Trap(const RoomCoords& coords, ElementData& edata, Inter& inter)
     // Decorum
     m_sprite.load("vanilla/traps/" + sTrapID + "/anim");
 
-    // Lua API
-    lua()["eev_warnHarvestableDosh"] = [this] { lua_warnHarvestableDosh(); };
-
-    lua()["eev_hasBarrier"] = [this] { return lua_hasBarrier(); };
-    lua()["eev_setBarrier"] = [this] (bool activated) { lua_setBarrier(activated); };
-
     // Lua
     std::string luaFilename = "res/vanilla/traps/" + sTrapID + "/ai.lua";
-    if (!lua().load(luaFilename))
+    if (!loadLua(luaFilename))
         mquit("Failed to load Lua file: '" + luaFilename + "'. It might be a syntax error or a missing file.");
     lua()["_register"]();
 }
 
+//-------------------//
+//----- Lua API -----//
+
+void Trap::registerLuaAPI(scene::LuaVM& vm)
+{
+    baseClass::registerLuaAPI(vm);
+
+    luaBind(vm, "eev_warnHarvestableDosh", &Trap::lua_warnHarvestableDosh);
+
+    luaBind(vm, "eev_hasBarrier", &Trap::lua_hasBarrier);
+    luaBind(vm, "eev_setBarrier", &Trap::lua_setBarrier);
+}
+
 //------------------------//
 //----- Element data -----//
 
@@ -65,7 +71,7 @@ uint32 Trap::harvestableDosh()
 
 void Trap::lua_warnHarvestableDosh()
 {
-    m_inter.data().addEvent("harvestable_dosh_changed", m_coords);
+    m_inter.data().addEvent(events::harvestableDoshChanged, m_coords);
 }
 
 bool Trap::lua_hasBarrier() const
@@ -0,0 +1,28 @@
+#include "dungeon/event.hpp"
+
+using namespace dungeon;
+
+//----------------------------//
+//----- Static variables -----//
+
+const context::EventID events::dungeonChanged          = context::eventID("dungeon_changed");
+const context::EventID events::dungeonStructureChanged = context::eventID("dungeon_structure_changed");
+const context::EventID events::dungeonGraphChanged     = context::eventID("dungeon_graph_changed");
+const context::EventID events::roomConstructed         = context::eventID("room_constructed");
+const context::EventID events::roomDestroyed           = context::eventID("room_destroyed");
+const context::EventID events::roomChanged             = context::eventID("room_changed");
+const context::EventID events::roomHideChanged         = context::eventID("room_hide_changed");
+const context::EventID events::facilityChanged         = context::eventID("facility_changed");
+const context::EventID events::trapChanged             = context::eventID("trap_changed");
+const context::EventID events::treasureChanged         = context::eventID("treasure_changed");
+const context::EventID events::harvestableDoshChanged  = context::eventID("harvestable_dosh_changed");
+const context::EventID events::trapGenericChanged      = context::eventID("trap_generic_changed");
+const context::EventID events::monsterGenericChanged   = context::eventID("monster_generic_changed");
+const context::EventID events::monsterAdded            = context::eventID("monster_added");
+const context::EventID events::reserveCountdownChanged = context::eventID("reserve_countdown_changed");
+const context::EventID events::timeChanged             = context::eventID("time_changed");
+const context::EventID events::debtChanged             = context::eventID("debt_changed");
+const context::EventID events::doshChanged             = context::eventID("dosh_changed");
+const context::EventID events::evilChanged             = context::eventID("evil_changed");
+const context::EventID events::soulChanged             = context::eventID("soul_changed");
+const context::EventID events::fameChanged             = context::eventID("fame_changed");
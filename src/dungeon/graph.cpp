@@ -4,8 +4,32 @@
 #include "dungeon/data.hpp"
 #include "tools/debug.hpp"
 
+#include <algorithm>
+
 using namespace dungeon;
 
+namespace
+{
+    //! The targets of the entrances field.
+    bool isEntrance(const Graph::NodeData& nodeData)
+    {
+        return nodeData.entrance;
+    }
+
+    //! The targets of the treasures field.
+    bool hasTreasure(const Graph::NodeData& nodeData)
+    {
+        return nodeData.treasure > 0u;
+    }
+}
+
+Graph::~Graph()
+{
+    // Data should not invalidate our rooms anymore
+    if (m_data != nullptr && m_data->m_graph == this)
+        m_data->m_graph = nullptr;
+}
+
 //-----------------------//
 //----- Interaction -----//
 
@@ -25,6 +49,57 @@ const Graph::NodeData* Graph::nodeData(const RoomCoords& coords) const
     return &m_nodes[coords.x][coords.y];
 }
 
+//---------------------//
+//----- Distances -----//
+
+void Graph::refreshDistances()
+{
+    refreshField(m_entrancesField, isEntrance);
+    refreshField(m_treasuresField, hasTreasure);
+}
+
+uint Graph::entranceDistance(const RoomCoords& coords)
+{
+    returnif (coords.x >= m_floorsCount || coords.y >= m_floorRoomsCount) -1u;
+
+    refreshField(m_entrancesField, isEntrance);
+    return m_entrancesField.distances[coords.x * m_floorRoomsCount + coords.y];
+}
+
+uint Graph::treasureDistance(const RoomCoords& coords)
+{
+    returnif (coords.x >= m_floorsCount || coords.y >= m_floorRoomsCount) -1u;
+
+    refreshField(m_treasuresField, hasTreasure);
+    return m_treasuresField.distances[coords.x * m_floorRoomsCount + coords.y];
+}
+
+uint Graph::distance(const RoomCoords& from, const RoomCoords& to)
+{
+    returnif (from.x >= m_floorsCount || from.y >= m_floorRoomsCount) -1u;
+    returnif (to.x >= m_floorsCount || to.y >= m_floorRoomsCount) -1u;
+
+    const auto& field = roomField(to.x * m_floorRoomsCount + to.y);
+    return field.distances[from.x * m_floorRoomsCount + from.y];
+}
+
+const Graph::NodeData* Graph::nextTowards(const RoomCoords& from, const RoomCoords& to)
+{
+    auto fromDistance = distance(from, to);
+    returnif (fromDistance == 0u || fromDistance == -1u) nullptr;
+
+    // A neighbour one move closer, there is always one
+    const auto& field = roomField(to.x * m_floorRoomsCount + to.y);
+    for (const auto& neighbour : m_nodes[from.x][from.y].node->neighbours) {
+        auto neighbourData = reinterpret_cast<const NodeData*>(neighbour.node->data);
+        const auto& coords = neighbourData->coords;
+        if (field.distances[coords.x * m_floorRoomsCount + coords.y] == fromDistance - 1u)
+            return neighbourData;
+    }
+
+    return nullptr;
+}
+
 //------------------//
 //----- Events -----//
 
@@ -33,11 +108,16 @@ void Graph::receive(const context::Event& event)
     returnif (m_data == nullptr || m_nodes.empty());
 
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
-    if (event.type == "treasure_changed")
-        refreshTreasure(m_nodes.at(devent.room.x).at(devent.room.y));
-    else if (event.type == "dungeon_changed")
-        updateFromData();
-    else if (event.type == "dungeon_structure_changed")
+    if (event.type == events::treasureChanged) {
+        auto& nodeData = m_nodes.at(devent.room.x).at(devent.room.y);
+        bool hadTreasure = (nodeData.treasure > 0u);
+        refreshTreasure(nodeData);
+        if (hadTreasure != (nodeData.treasure > 0u))
+            m_version += 1u;
+    }
+    else if (event.type == events::dungeonChanged)
+        updateFromInvalidRooms();
+    else if (event.type == events::dungeonStructureChanged)
         reconstructFromData();
 }
 
@@ -49,26 +129,79 @@ void Graph::useData(Data& data)
     m_data = &data;
     m_data->useGraph(*this);
 
-    setEmitter(m_data);
+    setEmitter(m_data, {events::treasureChanged, events::dungeonChanged, events::dungeonStructureChanged});
     reconstructFromData();
 }
 
+void Graph::invalidateRoom(const RoomCoords& coords)
+{
+    m_invalidRooms.emplace_back(coords);
+}
+
+void Graph::invalidateAll()
+{
+    m_invalidRooms.clear();
+    m_invalidAll = true;
+}
+
 //------------------------------//
 //----- Graph construction -----//
 
-void Graph::addNodeNeighbour(NodeData& nodeData, const RoomCoords& neighbourCoords, const std::wstring& tunnelFacilityID)
+Graph::NeighbourData* Graph::neighbourData(const std::wstring& tunnelFacilityID)
 {
-    auto& neighbourNodeData = m_nodes[neighbourCoords.x][neighbourCoords.y];
+    auto found = m_neighboursData.find(tunnelFacilityID);
+    returnif (found != std::end(m_neighboursData)) &found->second;
 
-    auto neighbourData = std::make_unique<NeighbourData>();
-    neighbourData->tunnelFacilityID = tunnelFacilityID;
+    auto& neighbourData = m_neighboursData[tunnelFacilityID];
+    neighbourData.tunnelFacilityID = tunnelFacilityID;
+    return &neighbourData;
+}
 
+void Graph::addNodeNeighbour(const RoomCoords& neighbourCoords, const std::wstring& tunnelFacilityID)
+{
     ai::Neighbour neighbour;
-    neighbour.node = neighbourNodeData.node;
-    neighbour.data = neighbourData.get();
-    nodeData.node->neighbours.emplace_back(std::move(neighbour));
+    neighbour.node = m_nodes[neighbourCoords.x][neighbourCoords.y].node;
+    neighbour.data = neighbourData(tunnelFacilityID);
+    m_patchEdges.emplace_back(std::move(neighbour));
+}
 
-    nodeData.neighbours.emplace_back(std::move(neighbourData));
+void Graph::rebuildNode(NodeData& nodeData)
+{
+    const auto& coords = nodeData.coords;
+    nodeData.entrance = false;
+    nodeData.constructed = m_data->isRoomConstructed(coords);
+    refreshTreasure(nodeData);
+
+    returnif (!nodeData.constructed);
+
+    // Check facilities
+    const auto& room = m_data->room(coords);
+    for (const auto& facilityInfo : room.facilities) {
+        // Entrance
+        if (facilityInfo.common->entrance)
+            nodeData.entrance = true;
+
+        // Tunnels, remembered even if not walkable, as it might become so
+        for (const auto& tunnel : facilityInfo.tunnels) {
+            auto tunnelCoords = sf::v2u8(tunnel.coords);
+            if (tunnel.relative) tunnelCoords += coords;
+            if (tunnelCoords.x < m_floorsCount && tunnelCoords.y < m_floorRoomsCount) {
+                auto& tunnelSources = m_tunnelSources[tunnelCoords.x * m_floorRoomsCount + tunnelCoords.y];
+                if (std::find(std::begin(tunnelSources), std::end(tunnelSources), m_rebuiltIndex) == std::end(tunnelSources))
+                    tunnelSources.emplace_back(m_rebuiltIndex);
+            }
+
+            if (m_data->isRoomWalkable(tunnelCoords))
+                addNodeNeighbour(tunnelCoords, facilityInfo.data.type());
+        }
+    }
+
+    // Check neighbourhood
+    for (auto direction : {EAST, WEST}) {
+        auto neighbourCoords = m_data->roomNeighbourCoords(coords, direction);
+        if (m_data->isRoomWalkable(neighbourCoords))
+            addNodeNeighbour(neighbourCoords);
+    }
 }
 
 //-----------------------------------//
@@ -94,10 +227,11 @@ void Graph::reconstructFromData()
 
     m_floorsCount = m_data->floorsCount();
     m_floorRoomsCount = m_data->floorRoomsCount();
+    uint nodesCount = m_floorsCount * m_floorRoomsCount;
 
-    // Soft reset: will keep memory as it was if same dungeon size.
-    if (m_floorsCount != m_nodes.size() || m_floorRoomsCount != m_nodes[0u].size()) {
-        reset(m_floorsCount * m_floorRoomsCount);
+    // Soft reset: will keep node data memory as it was if same dungeon size.
+    reset(nodesCount);
+    if (m_nodes.empty() || m_floorsCount != m_nodes.size() || m_floorRoomsCount != m_nodes[0u].size()) {
         m_nodes.resize(m_floorsCount);
         for (auto& floorNodes : m_nodes)
             floorNodes.resize(m_floorRoomsCount);
@@ -109,58 +243,225 @@ void Graph::reconstructFromData()
         auto& nodeData = m_nodes.at(floorIndex).at(roomIndex);
         nodeData.coords = {floorIndex, roomIndex};
         nodeData.altitude = floorIndex + 1u;
+        nodeData.edgesOffset = 0u;
         nodeData.node = &addNode(&nodeData);
     }
 
+    m_edges.clear();
+    m_dirtyNodes.assign(nodesCount, false);
+    m_dirtyIndices.clear();
+    m_tunnelSources.resize(nodesCount);
+
     updateFromData();
 }
 
 void Graph::updateFromData()
 {
-    resetStartingNodes();
+    // Everything is rebuilt, forget about previous tunnels
+    m_invalidRooms.clear();
+    m_invalidAll = false;
+    for (auto& tunnelSources : m_tunnelSources)
+        tunnelSources.clear();
 
     for (auto& floorNodes : m_nodes)
-    for (auto& nodeData : floorNodes) {
-        auto& node = *nodeData.node;
-
-        // Cleaning
-        node.neighbours.clear();
-        nodeData.entrance = false;
-        nodeData.constructed = m_data->isRoomConstructed(nodeData.coords);
-
-        if (!nodeData.constructed)
-            continue;
-
-        const auto& coords = nodeData.coords;
-        auto& room = m_data->room(coords);
-
-        // Check facilities
-        for (auto facilityInfo : room.facilities) {
-            // Entrance
-            if (facilityInfo.common->entrance) {
-                nodeData.entrance = true;
-                addStartingNode(&node);
-            }
+    for (auto& nodeData : floorNodes)
+        markDirty(nodeData.coords);
 
-            // Treasure
-            refreshTreasure(nodeData);
+    rebuildDirtyNodes();
+    m_version += 1u;
+    emitter()->addEvent(events::dungeonGraphChanged);
+}
+
+void Graph::updateFromInvalidRooms()
+{
+    // Nothing said about what changed, or everything did
+    if (m_invalidAll || m_invalidRooms.empty()) {
+        updateFromData();
+        return;
+    }
+
+    // A room changing affects the nodes having a passage to it
+    for (const auto& coords : m_invalidRooms) {
+        markDirty(coords);
+        markDirty(m_data->roomNeighbourCoords(coords, EAST));
+        markDirty(m_data->roomNeighbourCoords(coords, WEST));
+
+        if (coords.x < m_floorsCount && coords.y < m_floorRoomsCount)
+            for (auto tunnelSource : m_tunnelSources[coords.x * m_floorRoomsCount + coords.y])
+                markDirty(m_nodes[tunnelSource / m_floorRoomsCount][tunnelSource % m_floorRoomsCount].coords);
+    }
+
+    m_invalidRooms.clear();
+
+    rebuildDirtyNodes();
+    m_version += 1u;
+    emitter()->addEvent(events::dungeonGraphChanged);
+}
+
+void Graph::rebuildDirtyNodes()
+{
+    returnif (m_dirtyIndices.empty());
+    std::sort(std::begin(m_dirtyIndices), std::end(m_dirtyIndices));
+
+    // Rebuild the nodes in the patch
+    bool sameCounts = true;
+    m_patchEdges.clear();
+    m_patchOffsets.clear();
+    for (auto index : m_dirtyIndices) {
+        auto& nodeData = m_nodes[index / m_floorRoomsCount][index % m_floorRoomsCount];
+        m_patchOffsets.emplace_back(m_patchEdges.size());
+        m_rebuiltIndex = index;
+        rebuildNode(nodeData);
+        sameCounts = sameCounts && (m_patchEdges.size() - m_patchOffsets.back() == nodeData.node->neighbours.count);
+    }
+    m_patchOffsets.emplace_back(m_patchEdges.size());
+
+    // Same neighbours count, patching edges in place
+    if (sameCounts) {
+        for (uint i = 0u; i < m_dirtyIndices.size(); ++i) {
+            auto index = m_dirtyIndices[i];
+            const auto& nodeData = m_nodes[index / m_floorRoomsCount][index % m_floorRoomsCount];
+            std::copy(std::begin(m_patchEdges) + m_patchOffsets[i], std::begin(m_patchEdges) + m_patchOffsets[i + 1u],
+                      std::begin(m_edges) + nodeData.edgesOffset);
+        }
+    }
 
-            // Tunnels
-            for (const auto& tunnel : facilityInfo.tunnels) {
-                auto tunnelCoords = sf::v2u8(tunnel.coords);
-                if (tunnel.relative) tunnelCoords += coords;
-                if (m_data->isRoomWalkable(tunnelCoords))
-                    addNodeNeighbour(nodeData, tunnelCoords, facilityInfo.data.type());
+    // Otherwise, rebuild all edges, with clean nodes keeping theirs
+    else {
+        m_edgesBuffer.clear();
+        uint patchIndex = 0u;
+        for (uint index = 0u; index < m_dirtyNodes.size(); ++index) {
+            auto& nodeData = m_nodes[index / m_floorRoomsCount][index % m_floorRoomsCount];
+            uint edgesOffset = m_edgesBuffer.size();
+
+            if (m_dirtyNodes[index]) {
+                m_edgesBuffer.insert(std::end(m_edgesBuffer), std::begin(m_patchEdges) + m_patchOffsets[patchIndex],
+                                     std::begin(m_patchEdges) + m_patchOffsets[patchIndex + 1u]);
+                patchIndex += 1u;
+            }
+            else {
+                auto edgesBegin = std::begin(m_edges) + nodeData.edgesOffset;
+                m_edgesBuffer.insert(std::end(m_edgesBuffer), edgesBegin, edgesBegin + nodeData.node->neighbours.count);
             }
+
+            nodeData.edgesOffset = edgesOffset;
+            nodeData.node->neighbours.count = m_edgesBuffer.size() - edgesOffset;
+        }
+
+        std::swap(m_edges, m_edgesBuffer);
+
+        // Storage might have moved
+        for (auto& floorNodes : m_nodes)
+        for (auto& nodeData : floorNodes)
+            nodeData.node->neighbours.first = m_edges.data() + nodeData.edgesOffset;
+    }
+
+    for (auto index : m_dirtyIndices)
+        m_dirtyNodes[index] = false;
+    m_dirtyIndices.clear();
+
+    refreshStartingNodes();
+}
+
+void Graph::markDirty(const RoomCoords& coords)
+{
+    returnif (coords.x >= m_floorsCount || coords.y >= m_floorRoomsCount);
+
+    uint index = coords.x * m_floorRoomsCount + coords.y;
+    returnif (m_dirtyNodes[index]);
+
+    m_dirtyNodes[index] = true;
+    m_dirtyIndices.emplace_back(index);
+}
+
+void Graph::refreshStartingNodes()
+{
+    resetStartingNodes();
+
+    for (auto& floorNodes : m_nodes)
+    for (auto& nodeData : floorNodes)
+        if (nodeData.entrance)
+            addStartingNode(nodeData.node);
+}
+
+//---------------------------//
+//----- Distance fields -----//
+
+void Graph::refreshField(DistanceField& field, const std::function<bool(const NodeData&)>& isTarget)
+{
+    returnif (field.version == m_version);
+    field.version = m_version;
+    refreshReverseEdges();
+
+    const uint nodesCount = m_floorsCount * m_floorRoomsCount;
+    field.distances.assign(nodesCount, -1u);
+
+    // Breadth-first search from all targets at once
+    m_fieldQueue.clear();
+    for (uint index = 0u; index < nodesCount; ++index) {
+        const auto& nodeData = m_nodes[index / m_floorRoomsCount][index % m_floorRoomsCount];
+        if (!nodeData.constructed || !isTarget(nodeData)) continue;
+        field.distances[index] = 0u;
+        m_fieldQueue.emplace_back(index);
+    }
+
+    for (uint i = 0u; i < m_fieldQueue.size(); ++i) {
+        auto index = m_fieldQueue[i];
+        for (uint r = m_reverseOffsets[index]; r < m_reverseOffsets[index + 1u]; ++r) {
+            auto sourceIndex = m_reverseEdges[r];
+            if (field.distances[sourceIndex] != -1u) continue;
+            field.distances[sourceIndex] = field.distances[index] + 1u;
+            m_fieldQueue.emplace_back(sourceIndex);
         }
+    }
+}
 
-        // Check neighbourhood
-        for (auto direction : {EAST, WEST}) {
-            auto neighbourCoords = m_data->roomNeighbourCoords(coords, direction);
-            if (m_data->isRoomWalkable(neighbourCoords))
-                addNodeNeighbour(nodeData, neighbourCoords);
+const Graph::DistanceField& Graph::roomField(uint targetIndex)
+{
+    // Fields already computed are left untouched until the graph changes,
+    // so the one returned can be read without lock
+    std::lock_guard<std::mutex> lock(m_roomsFieldsMutex);
+
+    // Fields of a previous graph are dropped, so that only the targets still asked for are kept
+    if (m_roomsFieldsVersion != m_version) {
+        m_roomsFieldsVersion = m_version;
+        m_roomsFields.clear();
+    }
+
+    auto& field = m_roomsFields[targetIndex];
+    refreshField(field, [this, targetIndex] (const NodeData& nodeData) {
+        return nodeData.coords.x * m_floorRoomsCount + nodeData.coords.y == targetIndex;
+    });
+    return field;
+}
+
+void Graph::refreshReverseEdges()
+{
+    returnif (m_reverseVersion == m_version);
+    m_reverseVersion = m_version;
+
+    // Counting sources of each node first
+    const uint nodesCount = m_floorsCount * m_floorRoomsCount;
+    m_reverseOffsets.assign(nodesCount + 1u, 0u);
+    for (const auto& floorNodes : m_nodes)
+    for (const auto& nodeData : floorNodes) {
+        for (const auto& neighbour : nodeData.node->neighbours) {
+            const auto& coords = reinterpret_cast<const NodeData*>(neighbour.node->data)->coords;
+            m_reverseOffsets[coords.x * m_floorRoomsCount + coords.y + 1u] += 1u;
         }
     }
 
-    emitter()->addEvent("dungeon_graph_changed");
+    for (uint index = 0u; index < nodesCount; ++index)
+        m_reverseOffsets[index + 1u] += m_reverseOffsets[index];
+
+    // Then filling, the queue being used as insertion cursors
+    m_reverseEdges.resize(m_reverseOffsets.back());
+    m_fieldQueue.assign(std::begin(m_reverseOffsets), std::end(m_reverseOffsets) - 1u);
+    for (uint index = 0u; index < nodesCount; ++index) {
+        const auto& nodeData = m_nodes[index / m_floorRoomsCount][index % m_floorRoomsCount];
+        for (const auto& neighbour : nodeData.node->neighbours) {
+            const auto& coords = reinterpret_cast<const NodeData*>(neighbour.node->data)->coords;
+            m_reverseEdges[m_fieldQueue[coords.x * m_floorRoomsCount + coords.y]++] = index;
+        }
+    }
 }
@@ -1,10 +1,12 @@
 #include "dungeon/inter.hpp"
 
 #include "core/gettext.hpp"
+#include "core/jobsystem.hpp"
 #include "context/context.hpp"
 #include "context/worlds.hpp"
 #include "context/villains.hpp"
 #include "dungeon/managers/heroesmanager.hpp"
+#include "dungeon/detector.hpp"
 #include "tools/debug.hpp"
 #include "tools/event.hpp"
 #include "tools/tools.hpp"
@@ -83,6 +85,10 @@ void Inter::updateRoutine(const sf::Time& dt)
     // Effecter update
     m_effecter.update(dt);
 
+    // Moving elements decide beforehand, applying their decisions during their own update
+    if (m_parallelAI && m_data != nullptr)
+        decideMovingElements(dt);
+
     // Moving rooms
     returnif (m_movingRooms.empty());
 
@@ -124,6 +130,33 @@ void Inter::updateRoutine(const sf::Time& dt)
     std::erase_if(m_movingRooms, [] (const MovingRoom& movingRoom) { return movingRoom.animationTime >= movingRoom.animationDelay; });
 }
 
+void Inter::decideMovingElements(const sf::Time& dt)
+{
+    // Distances are read concurrently afterwards
+    m_data->graph().refreshDistances();
+
+    // Elements sharing a VM decide on the same thread, in update order
+    for (auto& job : m_aiJobs)
+        job.clear();
+    m_aiJobsIndices.clear();
+
+    for (auto child : children()) {
+        auto movingElement = dynamic_cast<MovingElement*>(child);
+        if (movingElement == nullptr || movingElement->vm() == nullptr) continue;
+
+        auto inserted = m_aiJobsIndices.emplace(movingElement->vm(), m_aiJobsIndices.size());
+        auto jobIndex = inserted.first->second;
+        if (jobIndex >= m_aiJobs.size())
+            m_aiJobs.emplace_back();
+        m_aiJobs[jobIndex].emplace_back(movingElement);
+    }
+
+    s_jobs.parallelFor("ai", m_aiJobsIndices.size(), [this, &dt] (uint jobIndex) {
+        for (auto movingElement : m_aiJobs[jobIndex])
+            movingElement->decide(dt);
+    });
+}
+
 void Inter::onSizeChanges()
 {
     m_grid.setSize(size());
@@ -231,32 +264,32 @@ void Inter::receive(const context::Event& event)
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
     RoomCoords coords(devent.room.x, devent.room.y);
 
-    if (event.type == "room_destroyed") {
+    if (event.type == events::roomDestroyed) {
         refreshTile(coords);
         refreshNeighboursLayers(coords);
     }
-    else if (event.type == "room_constructed") {
+    else if (event.type == events::roomConstructed) {
         refreshTile(coords);
         refreshNeighboursLayers(coords);
     }
-    else if (event.type == "room_changed") {
+    else if (event.type == events::roomChanged) {
         refreshTile(coords);
         refreshNeighboursLayers(coords);
     }
-    else if (event.type == "room_hide_changed") {
+    else if (event.type == events::roomHideChanged) {
         refreshTileLayers(coords);
     }
-    else if (event.type == "facility_changed") {
+    else if (event.type == events::facilityChanged) {
         refreshTileFacilities(coords);
         refreshTileDoshLabel(coords);
     }
-    else if (event.type == "trap_changed") {
+    else if (event.type == events::trapChanged) {
         refreshTileTraps(coords);
     }
-    else if (event.type == "harvestable_dosh_changed") {
+    else if (event.type == events::harvestableDoshChanged) {
         refreshTileDoshLabel(coords);
     }
-    else if (event.type == "dungeon_structure_changed") {
+    else if (event.type == events::dungeonStructureChanged) {
         refreshFromData();
     }
 }
@@ -273,7 +306,8 @@ void Inter::useData(Data& data)
 
     m_effecter.useInter(*this);
 
-    setEmitter(m_data);
+    setEmitter(m_data, {events::roomDestroyed, events::roomConstructed, events::roomChanged, events::roomHideChanged,
+                        events::facilityChanged, events::trapChanged, events::harvestableDoshChanged, events::dungeonStructureChanged});
     refreshFromData();
 }
 
@@ -525,7 +559,7 @@ void Inter::showEditTreasureDialog(const RoomCoords& coords)
         treasureDosh = newValue;
 
         // Global dosh changed
-        m_data->addEvent("facility_changed", coords);
+        m_data->addEvent(events::facilityChanged, coords);
     });
 }
 
@@ -1038,6 +1072,9 @@ void Inter::refreshSize()
     const auto& floorsCount = m_data->floorsCount();
     const auto roomSize = m_roomScale * m_refRoomSize;
     setSize({roomSize.x * floorRoomsCount, roomSize.y * floorsCount});
+
+    // Detection ranges are expressed in rooms
+    s_detector.setCellSize(roomSize.x);
 }
 
 void Inter::refreshTiles()
@@ -13,9 +13,8 @@ DynamicsManager::DynamicsManager()
 
 void DynamicsManager::update(const sf::Time& dt)
 {
-    // Update dynamics
-    bool dynamicsCountChanged = false;
-    for (auto it = std::begin(m_dynamicsInfo); it != std::end(m_dynamicsInfo); ) {
+    // Update dynamics, the others never moving when one is added or removed
+    for (auto it = std::begin(m_dynamicsInfo); it != std::end(m_dynamicsInfo); ++it) {
         auto& dynamicInfo = *it;
 
         // Spawn dynamic
@@ -24,24 +23,16 @@ void DynamicsManager::update(const sf::Time& dt)
 
             // Create the dynamic object and add it as an Inter child
             auto& dynamic = dynamicInfo.dynamic;
-            dynamic = std::make_unique<Dynamic>(*m_inter);
+            dynamic = std::make_unique<Dynamic>(it.handle(), *m_inter);
             dynamic->bindElementData(dynamicInfo.data);
             m_inter->attachChild(*dynamic);
         }
 
         // Remove the dynamic
         else if (dynamicInfo.status == DynamicStatus::TO_BE_REMOVED) {
-            it = m_dynamicsInfo.erase(it);
-            dynamicsCountChanged = true;
-            continue;
+            m_dynamicsInfo.erase(it.handle());
         }
-
-        ++it;
     }
-
-    // Dynamics count changed, update all reference to their data
-    if (dynamicsCountChanged)
-        refreshDynamicsData();
 }
 
 //------------------//
@@ -51,7 +42,7 @@ void DynamicsManager::receive(const context::Event& event)
 {
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
 
-    if (devent.type == "dungeon_graph_changed") {
+    if (devent.type == events::dungeonGraphChanged) {
         refreshDynamicsData();
     }
 }
@@ -64,22 +55,53 @@ void DynamicsManager::load(const pugi::xml_node& node)
     m_dynamicsInfo.clear();
 
     for (const auto& dynamicNode : node.children(L"dynamic")) {
-        m_dynamicsInfo.emplace_back();
-        auto& dynamicInfo = m_dynamicsInfo.back();
+        auto& dynamicInfo = *m_dynamicsInfo.get(m_dynamicsInfo.emplace());
         dynamicInfo.status = DynamicStatus::TO_SPAWN;
         dynamicInfo.data.loadXML(dynamicNode);
     }
 }
 
-void DynamicsManager::save(pugi::xml_node node)
+DynamicsManager::Snapshot DynamicsManager::snapshot() const
 {
+    Snapshot snapshot;
+    snapshot.dynamics.reserve(m_dynamicsInfo.size());
+
     for (const auto& dynamicInfo : m_dynamicsInfo) {
         if (dynamicInfo.status == DynamicStatus::TO_BE_REMOVED) continue;
+        snapshot.dynamics.emplace_back(dynamicInfo.data);
+    }
+
+    return snapshot;
+}
+
+void DynamicsManager::save(const Snapshot& snapshot, pugi::xml_node node)
+{
+    for (const auto& data : snapshot.dynamics) {
         auto dynamicNode = node.append_child(L"dynamic");
-        dynamicInfo.data.saveXML(dynamicNode);
+        data.saveXML(dynamicNode);
+    }
+}
+
+void DynamicsManager::loadBinary(BinaryReader& reader)
+{
+    m_dynamicsInfo.clear();
+
+    uint dynamicsCount = reader.readUint32();
+    for (uint i = 0u; i < dynamicsCount && !reader.failed(); ++i) {
+        auto& dynamicInfo = *m_dynamicsInfo.get(m_dynamicsInfo.emplace());
+        dynamicInfo.status = DynamicStatus::TO_SPAWN;
+        dynamicInfo.data.loadBinary(reader);
     }
 }
 
+void DynamicsManager::saveBinary(const Snapshot& snapshot, BinaryWriter& writer)
+{
+    writer.write(static_cast<uint32>(snapshot.dynamics.size()));
+
+    for (const auto& data : snapshot.dynamics)
+        data.saveBinary(writer);
+}
+
 //-------------------------------//
 //----- Dungeon interaction -----//
 
@@ -87,7 +109,7 @@ void DynamicsManager::useInter(Inter& inter)
 {
     m_inter = &inter;
     m_data = &m_inter->data();
-    setEmitter(m_data);
+    setEmitter(m_data, {events::dungeonGraphChanged});
 }
 
 //----------------------------//
@@ -95,26 +117,26 @@ void DynamicsManager::useInter(Inter& inter)
 
 uint32 DynamicsManager::create(const sf::Vector2f& rpos, const std::wstring& id)
 {
-    DynamicInfo dynamicInfo;
+    auto handle = m_dynamicsInfo.emplace();
+    auto& dynamicInfo = *m_dynamicsInfo.get(handle);
     dynamicInfo.data.create(id);
-    dynamicInfo.data[L"rx"].init_float(rpos.x);
-    dynamicInfo.data[L"ry"].init_float(rpos.y);
+    dynamicInfo.data[attributes::rx].init_float(rpos.x);
+    dynamicInfo.data[attributes::ry].init_float(rpos.y);
     dynamicInfo.status = DynamicStatus::RUNNING;
-    dynamicInfo.dynamic = std::make_unique<Dynamic>(*m_inter);
-    m_dynamicsInfo.emplace_back(std::move(dynamicInfo));
+    dynamicInfo.dynamic = std::make_unique<Dynamic>(handle, *m_inter);
 
-    refreshDynamicsData();
-
-    auto& dynamic = *m_dynamicsInfo.back().dynamic;
+    // Bound once, as the data never moves
+    auto& dynamic = *dynamicInfo.dynamic;
+    dynamic.bindElementData(dynamicInfo.data);
     m_inter->attachChild(dynamic);
     return dynamic.UID();
 }
 
 void DynamicsManager::remove(const Dynamic* pDynamic)
 {
-    for (auto& dynamicInfo : m_dynamicsInfo)
-        if (dynamicInfo.dynamic.get() == pDynamic)
-            dynamicInfo.status = DynamicStatus::TO_BE_REMOVED;
+    auto pDynamicInfo = m_dynamicsInfo.get(pDynamic->managerHandle());
+    returnif (pDynamicInfo == nullptr);
+    pDynamicInfo->status = DynamicStatus::TO_BE_REMOVED;
 }
 
 //---------------//
@@ -18,9 +18,8 @@ void HeroesManager::update(const sf::Time& dt)
 {
     returnif (m_graph == nullptr);
 
-    // Update heroes
-    bool heroesCountChanged = false;
-    for (auto it = std::begin(m_heroesInfo); it != std::end(m_heroesInfo); ) {
+    // Update heroes, the others never moving when one is added or removed
+    for (auto it = std::begin(m_heroesInfo); it != std::end(m_heroesInfo); ++it) {
         auto& heroInfo = *it;
 
         // Hero is running
@@ -38,7 +37,7 @@ void HeroesManager::update(const sf::Time& dt)
         // Spawn hero or update delay before spawning
         else if (heroInfo.status == HeroStatus::TO_SPAWN) {
             heroInfo.spawnDelay -= dt.asSeconds();
-            if (heroInfo.spawnDelay > 0.f) goto _continue;
+            if (heroInfo.spawnDelay > 0.f) continue;
             heroInfo.status = HeroStatus::RUNNING;
 
             // If we are really spawning it (choosing an entrance, etc.)
@@ -49,44 +48,30 @@ void HeroesManager::update(const sf::Time& dt)
                     heroInfo.status = HeroStatus::TO_BE_REMOVED;
                     context::context.sounds.play("core/heroes/no_entrance");
                     m_data->fameWallet().sub(2u);
-                    goto _continue;
+                    continue;
                 }
 
                 // Choose an entrance
-                auto startingNode = alea::rand(startingNodes);
+                auto startingNode = alea::rand(startingNodes, alea::Stream::HEROES);
                 auto coords = toNodeData(startingNode)->coords;
-                heroInfo.data[L"rx"].init_float(coords.x + 0.5f);
-                heroInfo.data[L"ry"].init_float(coords.y + 0.5f);
+                heroInfo.data[attributes::rx].init_float(coords.x + 0.5f);
+                heroInfo.data[attributes::ry].init_float(coords.y + 0.5f);
             }
 
             // Create the hero object and add it as an Inter child
             auto& hero = heroInfo.hero;
-            hero = std::make_unique<Hero>(*this, *m_inter, *m_graph);
+            hero = std::make_unique<Hero>(*this, it.handle(), *m_inter, *m_graph);
             hero->bindElementData(heroInfo.data);
             m_inter->attachChild(*hero);
         }
 
         // Remove the hero
         else if (heroInfo.status == HeroStatus::TO_BE_REMOVED) {
-            if (heroInfo.locked) goto _continue;
-            it = m_heroesInfo.erase(it);
-            heroesCountChanged = true;
-            continue;
+            if (heroInfo.locked) continue;
+            m_heroesInfo.erase(it.handle());
         }
-
-        _continue:
-        ++it;
     }
 
-    // Heroes count changed, update all reference to their data
-    // TODO This could use a lighter version of refreshHeroesData
-    // because we are only interested in keeping the reference (pointer) OK,
-    // and not to reinitialize LUA/etc.
-    // Ultimately, we won't need _reinit() function in lua (just one _register on _init)
-    // Do that for all managers
-    if (heroesCountChanged)
-        refreshHeroesData();
-
     // Next group
     m_nextGroupDelay -= dt.asSeconds();
     if (m_nextGroupDelay <= 0.f)
@@ -102,10 +87,10 @@ void HeroesManager::receive(const context::Event& event)
     RoomCoords coords = {devent.room.x, devent.room.y};
 
     // FIXME This event should slowly kills the hero via asphyxia
-    if (devent.type == "room_destroyed") {
+    if (devent.type == events::roomDestroyed) {
         removeRoomHeroes(coords);
     }
-    else if (devent.type == "dungeon_graph_changed") {
+    else if (devent.type == events::dungeonGraphChanged) {
         refreshHeroesFromGraph();
     }
 }
@@ -120,8 +105,7 @@ void HeroesManager::load(const pugi::xml_node& node)
     m_nextGroupDelay = node.attribute(L"nextWaveDelay").as_float(10.f);
 
     for (const auto& heroNode : node.children(L"hero")) {
-        m_heroesInfo.emplace_back();
-        auto& heroInfo = m_heroesInfo.back();
+        auto& heroInfo = *m_heroesInfo.get(m_heroesInfo.emplace());
         heroInfo.data.loadXML(heroNode);
         heroInfo.hp = heroNode.attribute(L"hp").as_float();
 
@@ -136,31 +120,83 @@ void HeroesManager::load(const pugi::xml_node& node)
             heroInfo.spawnHard = true;
         }
     }
-
-    refreshHeroesData();
 }
 
-void HeroesManager::save(pugi::xml_node node)
+HeroesManager::Snapshot HeroesManager::snapshot() const
 {
-    node.append_attribute(L"nextWaveDelay") = m_nextGroupDelay;
+    Snapshot snapshot;
+    snapshot.nextGroupDelay = m_nextGroupDelay;
+    snapshot.heroes.reserve(m_heroesInfo.size());
 
     for (const auto& heroInfo : m_heroesInfo) {
         if (heroInfo.status == HeroStatus::TO_BE_REMOVED) continue;
+        snapshot.heroes.push_back({heroInfo.data, heroInfo.status, heroInfo.spawnDelay, heroInfo.hp, heroInfo.spawnHard});
+    }
+
+    return snapshot;
+}
 
+void HeroesManager::save(const Snapshot& snapshot, pugi::xml_node node)
+{
+    node.append_attribute(L"nextWaveDelay") = snapshot.nextGroupDelay;
+
+    for (const auto& hero : snapshot.heroes) {
         auto heroNode = node.append_child(L"hero");
-        heroInfo.data.saveXML(heroNode);
-        heroNode.append_attribute(L"hp") = heroInfo.hp;
+        hero.data.saveXML(heroNode);
+        heroNode.append_attribute(L"hp") = hero.hp;
 
-        if (heroInfo.status == HeroStatus::TO_SPAWN) {
-            heroNode.append_attribute(L"status") = heroInfo.spawnHard? L"running" : L"spawning";
-            heroNode.append_attribute(L"spawnDelay") = heroInfo.spawnDelay;
+        if (hero.status == HeroStatus::TO_SPAWN) {
+            heroNode.append_attribute(L"status") = hero.spawnHard? L"running" : L"spawning";
+            heroNode.append_attribute(L"spawnDelay") = hero.spawnDelay;
         }
-        else if (heroInfo.status == HeroStatus::RUNNING) {
+        else if (hero.status == HeroStatus::RUNNING) {
             heroNode.append_attribute(L"status") = L"running";
         }
     }
 }
 
+void HeroesManager::loadBinary(BinaryReader& reader)
+{
+    m_heroesInfo.clear();
+
+    m_nextGroupDelay = reader.readFloat();
+
+    uint heroesCount = reader.readUint32();
+    for (uint i = 0u; i < heroesCount && !reader.failed(); ++i) {
+        auto& heroInfo = *m_heroesInfo.get(m_heroesInfo.emplace());
+        heroInfo.data.loadBinary(reader);
+        heroInfo.hp = reader.readFloat();
+
+        // Same status semantics as XML: 1 for spawning, 2 for running
+        auto status = reader.readUint8();
+        auto spawnDelay = reader.readFloat();
+        if (status == 1u) {
+            heroInfo.status = HeroStatus::TO_SPAWN;
+            heroInfo.spawnDelay = spawnDelay;
+        }
+        else if (status == 2u) {
+            heroInfo.status = HeroStatus::TO_SPAWN;
+            heroInfo.spawnDelay = 0.f;
+            heroInfo.spawnHard = true;
+        }
+    }
+}
+
+void HeroesManager::saveBinary(const Snapshot& snapshot, BinaryWriter& writer)
+{
+    writer.write(snapshot.nextGroupDelay);
+    writer.write(static_cast<uint32>(snapshot.heroes.size()));
+
+    for (const auto& hero : snapshot.heroes) {
+        hero.data.saveBinary(writer);
+        writer.write(hero.hp);
+
+        bool running = (hero.status == HeroStatus::RUNNING) || hero.spawnHard;
+        writer.write(static_cast<uint8>(running? 2u : 1u));
+        writer.write(hero.spawnDelay);
+    }
+}
+
 //-------------------------------//
 //----- Dungeon interaction -----//
 
@@ -168,7 +204,7 @@ void HeroesManager::useInter(Inter& inter)
 {
     m_inter = &inter;
     m_data = &m_inter->data();
-    setEmitter(m_data);
+    setEmitter(m_data, {events::roomDestroyed, events::dungeonGraphChanged});
 }
 
 void HeroesManager::useGraph(Graph& graph)
@@ -188,31 +224,27 @@ const Graph::NodeData* HeroesManager::toNodeData(const ai::Node* node)
 void HeroesManager::spawnHeroesGroup()
 {
     // FIXME We should make a more complex group theory
-    uint newHeroesCount = 1u + rand() % 5u;
+    uint newHeroesCount = alea::rand(1u, 5u, alea::Stream::HEROES);
     std::vector<std::wstring> heroesID(newHeroesCount);
     const auto& heroesData = m_data->heroesDB().get();
 
     float delay = 0.f;
     for (uint i = 0u; i < newHeroesCount; ++i) {
-        m_heroesInfo.emplace_back();
-        auto& heroInfo = m_heroesInfo.back();
+        auto& heroInfo = *m_heroesInfo.get(m_heroesInfo.emplace());
 
-        const auto& hero = alea::rand(heroesData);
+        const auto& hero = alea::rand(heroesData, alea::Stream::HEROES);
         const auto& heroID = hero.first;
         const auto& heroData = hero.second;
 
         heroInfo.data.create(heroID);
-        heroInfo.data[L"dosh"].init_uint32(0u);
+        heroInfo.data[attributes::dosh].init_uint32(0u);
         heroInfo.spawnDelay = delay;
         heroInfo.hp = heroData.startingHP;
 
-        delay += 3.f + static_cast<float>(rand() % 20u);
+        delay += 3.f + static_cast<float>(alea::rand(0u, 19u, alea::Stream::HEROES));
     }
 
-    // Refresh all element data, as pending reference might be lost
-    refreshHeroesData();
-
-    m_nextGroupDelay = delay + 10.f + static_cast<float>(rand() % 120u);
+    m_nextGroupDelay = delay + 10.f + static_cast<float>(alea::rand(0u, 119u, alea::Stream::HEROES));
 }
 
 //--------------------------//
@@ -220,25 +252,23 @@ void HeroesManager::spawnHeroesGroup()
 
 void HeroesManager::damage(const Hero* hero, float amount)
 {
-    for (auto& heroInfo : m_heroesInfo) {
-        if (heroInfo.hero.get() != hero) continue;
+    auto pHeroInfo = m_heroesInfo.get(hero->managerHandle());
+    returnif (pHeroInfo == nullptr);
+    auto& heroInfo = *pHeroInfo;
 
-        heroInfo.hp -= amount;
-        if (heroInfo.hp <= 0.f) {
-            heroInfo.status = HeroStatus::TO_BE_REMOVED;
-            if (heroInfo.hero != nullptr) {
-                heroInfo.hero->onDeath();
-                m_data->evilWallet().add(7u);  // TODO What to do with that, move it in onDeath()?
-            }
+    heroInfo.hp -= amount;
+    if (heroInfo.hp <= 0.f) {
+        heroInfo.status = HeroStatus::TO_BE_REMOVED;
+        if (heroInfo.hero != nullptr) {
+            heroInfo.hero->onDeath();
+            m_data->evilWallet().add(7u);  // TODO What to do with that, move it in onDeath()?
         }
-
-        // Player feedback
-        heroInfo.hero->setDamaged(true);
-        heroInfo.damageFeedbackTime = 0.05f;
-        heroInfo.damageFeedback = true;
-
-        return;
     }
+
+    // Player feedback
+    heroInfo.hero->setDamaged(true);
+    heroInfo.damageFeedbackTime = 0.05f;
+    heroInfo.damageFeedback = true;
 }
 
 void HeroesManager::listRoomHeroes(const RoomCoords& coords, std::vector<Hero*>& heroesList) const
@@ -247,8 +277,8 @@ void HeroesManager::listRoomHeroes(const RoomCoords& coords, std::vector<Hero*>&
 
     for (auto& heroInfo : m_heroesInfo) {
         if (heroInfo.status != HeroStatus::RUNNING) continue;
-        if (static_cast<uint>(heroInfo.data.at(L"rx").as_float()) != coords.x) continue;
-        if (static_cast<uint>(heroInfo.data.at(L"ry").as_float()) != coords.y) continue;
+        if (static_cast<uint>(heroInfo.data.at(attributes::rx).as_float()) != coords.x) continue;
+        if (static_cast<uint>(heroInfo.data.at(attributes::ry).as_float()) != coords.y) continue;
 
         heroesList.emplace_back(heroInfo.hero.get());
     }
@@ -256,13 +286,11 @@ void HeroesManager::listRoomHeroes(const RoomCoords& coords, std::vector<Hero*>&
 
 void HeroesManager::setLocked(const Hero* hero, bool locked)
 {
-    for (auto& heroInfo : m_heroesInfo) {
-        if (heroInfo.hero.get() != hero) continue;
-        if (heroInfo.status != HeroStatus::RUNNING) continue;
-        heroInfo.hero->setMoving(!locked);
-        heroInfo.locked = locked;
-        return;
-    }
+    auto pHeroInfo = m_heroesInfo.get(hero->managerHandle());
+    returnif (pHeroInfo == nullptr || pHeroInfo->status != HeroStatus::RUNNING);
+
+    pHeroInfo->hero->setMoving(!locked);
+    pHeroInfo->locked = locked;
 }
 
 void HeroesManager::removeRoomHeroes(const RoomCoords& coords)
@@ -271,8 +299,8 @@ void HeroesManager::removeRoomHeroes(const RoomCoords& coords)
         if (heroInfo.status != HeroStatus::RUNNING) continue;
 
         RoomCoords heroCoords;
-        heroCoords.x = static_cast<uint>(heroInfo.data[L"rx"].as_float());
-        heroCoords.y = static_cast<uint>(heroInfo.data[L"ry"].as_float());
+        heroCoords.x = static_cast<uint>(heroInfo.data[attributes::rx].as_float());
+        heroCoords.y = static_cast<uint>(heroInfo.data[attributes::ry].as_float());
 
         if (heroCoords == coords) {
             heroInfo.status = HeroStatus::TO_BE_REMOVED;
@@ -286,13 +314,13 @@ void HeroesManager::removeRoomHeroes(const RoomCoords& coords)
 
 void HeroesManager::heroGetsOut(Hero* hero)
 {
-    auto pHeroInfo = std::find_if(m_heroesInfo, [hero] (const HeroInfo& heroInfo) { return heroInfo.hero.get() == hero; });
-    returnif (pHeroInfo == std::end(m_heroesInfo));
+    auto pHeroInfo = m_heroesInfo.get(hero->managerHandle());
+    returnif (pHeroInfo == nullptr);
     auto& heroInfo = *pHeroInfo;
 
     // If no dosh stolen, hero is unhappy, fame decrease
     // TODO This should be part of Hero Lua
-    if (heroInfo.data[L"dosh"].as_uint32() == 0u)
+    if (heroInfo.data[attributes::dosh].as_uint32() == 0u)
         m_data->fameWallet().sub(4u);
     else
         m_data->fameWallet().add(1u);
@@ -310,13 +338,6 @@ uint HeroesManager::heroStealsTreasure(Hero*, const RoomCoords& coords, const ui
 //---------------//
 //----- ICU -----//
 
-void HeroesManager::refreshHeroesData()
-{
-    for (auto& heroInfo : m_heroesInfo)
-        if (heroInfo.status == HeroStatus::RUNNING)
-            heroInfo.hero->bindElementData(heroInfo.data);
-}
-
 void HeroesManager::refreshHeroesFromGraph()
 {
     for (auto& heroInfo : m_heroesInfo)
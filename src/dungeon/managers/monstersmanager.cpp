@@ -18,9 +18,8 @@ void MonstersManager::update(const sf::Time& dt)
 {
     returnif (m_graph == nullptr);
 
-    // Update monsters
-    bool monstersCountChanged = false;
-    for (auto it = std::begin(m_monstersInfo); it != std::end(m_monstersInfo); ) {
+    // Update monsters, the others never moving when one is added or removed
+    for (auto it = std::begin(m_monstersInfo); it != std::end(m_monstersInfo); ++it) {
         auto& monsterInfo = *it;
 
         // Monster is running
@@ -41,26 +40,17 @@ void MonstersManager::update(const sf::Time& dt)
 
             // Create the monster object and add it as an Inter child
             auto& monster = monsterInfo.monster;
-            monster = std::make_unique<Monster>(*m_inter, *m_graph);
+            monster = std::make_unique<Monster>(it.handle(), *m_inter, *m_graph);
             monster->bindElementData(monsterInfo.data);
             m_inter->attachChild(*monster);
         }
 
         // Remove the monster
         else if (monsterInfo.status == MonsterStatus::TO_BE_REMOVED) {
-            if (monsterInfo.locked) goto _continue;
-            it = m_monstersInfo.erase(it);
-            monstersCountChanged = true;
-            continue;
+            if (monsterInfo.locked) continue;
+            m_monstersInfo.erase(it.handle());
         }
-
-        _continue:
-        ++it;
     }
-
-    // Monsters count changed, update all reference to their data
-    if (monstersCountChanged)
-        refreshMonstersData();
 }
 
 //------------------//
@@ -71,10 +61,10 @@ void MonstersManager::receive(const context::Event& event)
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
     RoomCoords coords = {devent.room.x, devent.room.y};
 
-    if (devent.type == "room_destroyed") {
+    if (devent.type == events::roomDestroyed) {
         removeRoomMonsters(coords);
     }
-    else if (devent.type == "dungeon_graph_changed") {
+    else if (devent.type == events::dungeonGraphChanged) {
         refreshMonstersFromGraph();
     }
 }
@@ -87,8 +77,7 @@ void MonstersManager::load(const pugi::xml_node& node)
     m_monstersInfo.clear();
 
     for (const auto& monsterNode : node.children(L"monster")) {
-        m_monstersInfo.emplace_back();
-        auto& monsterInfo = m_monstersInfo.back();
+        auto& monsterInfo = *m_monstersInfo.get(m_monstersInfo.emplace());
         monsterInfo.data.loadXML(monsterNode);
         monsterInfo.hp = monsterNode.attribute(L"hp").as_float();
 
@@ -100,25 +89,55 @@ void MonstersManager::load(const pugi::xml_node& node)
             monsterInfo.status = MonsterStatus::TO_SPAWN;
         }
     }
-
-    refreshMonstersData();
 }
 
-void MonstersManager::save(pugi::xml_node node)
+MonstersManager::Snapshot MonstersManager::snapshot() const
 {
+    Snapshot snapshot;
+    snapshot.monsters.reserve(m_monstersInfo.size());
+
     for (const auto& monsterInfo : m_monstersInfo) {
         if (monsterInfo.status == MonsterStatus::TO_BE_REMOVED) continue;
+        snapshot.monsters.push_back({monsterInfo.data, monsterInfo.hp, monsterInfo.status == MonsterStatus::RUNNING});
+    }
 
+    return snapshot;
+}
+
+void MonstersManager::save(const Snapshot& snapshot, pugi::xml_node node)
+{
+    for (const auto& monster : snapshot.monsters) {
         auto monsterNode = node.append_child(L"monster");
-        monsterInfo.data.saveXML(monsterNode);
-        monsterNode.append_attribute(L"hp") = monsterInfo.hp;
+        monster.data.saveXML(monsterNode);
+        monsterNode.append_attribute(L"hp") = monster.hp;
+        monsterNode.append_attribute(L"status") = monster.running? L"running" : L"spawning";
+    }
+}
 
-        if (monsterInfo.status == MonsterStatus::TO_SPAWN) {
-            monsterNode.append_attribute(L"status") = L"spawning";
-        }
-        else if (monsterInfo.status == MonsterStatus::RUNNING) {
-            monsterNode.append_attribute(L"status") = L"running";
-        }
+void MonstersManager::loadBinary(BinaryReader& reader)
+{
+    m_monstersInfo.clear();
+
+    uint monstersCount = reader.readUint32();
+    for (uint i = 0u; i < monstersCount && !reader.failed(); ++i) {
+        auto& monsterInfo = *m_monstersInfo.get(m_monstersInfo.emplace());
+        monsterInfo.data.loadBinary(reader);
+        monsterInfo.hp = reader.readFloat();
+
+        // Spawning and running monsters are both respawned, as with XML
+        reader.readUint8();
+        monsterInfo.status = MonsterStatus::TO_SPAWN;
+    }
+}
+
+void MonstersManager::saveBinary(const Snapshot& snapshot, BinaryWriter& writer)
+{
+    writer.write(static_cast<uint32>(snapshot.monsters.size()));
+
+    for (const auto& monster : snapshot.monsters) {
+        monster.data.saveBinary(writer);
+        writer.write(monster.hp);
+        writer.write(static_cast<uint8>(monster.running? 2u : 1u));
     }
 }
 
@@ -129,7 +148,7 @@ void MonstersManager::useInter(Inter& inter)
 {
     m_inter = &inter;
     m_data = &m_inter->data();
-    setEmitter(m_data);
+    setEmitter(m_data, {events::roomDestroyed, events::dungeonGraphChanged});
 }
 
 void MonstersManager::useGraph(Graph& graph)
@@ -142,28 +161,26 @@ void MonstersManager::useGraph(Graph& graph)
 
 void MonstersManager::damage(const Monster* monster, float amount)
 {
-    for (auto& monsterInfo : m_monstersInfo) {
-        if (monsterInfo.monster.get() != monster) continue;
-
-        monsterInfo.hp -= amount;
-        if (monsterInfo.hp <= 0.f)
-            monsterInfo.status = MonsterStatus::TO_BE_REMOVED;
-
-        // Player feedback
-        monsterInfo.monster->setDamaged(true);
-        monsterInfo.damageFeedbackTime = 0.05f;
-        monsterInfo.damageFeedback = true;
-
-        return;
-    }
+    auto pMonsterInfo = m_monstersInfo.get(monster->managerHandle());
+    returnif (pMonsterInfo == nullptr);
+    auto& monsterInfo = *pMonsterInfo;
+
+    monsterInfo.hp -= amount;
+    if (monsterInfo.hp <= 0.f)
+        monsterInfo.status = MonsterStatus::TO_BE_REMOVED;
+
+    // Player feedback
+    monsterInfo.monster->setDamaged(true);
+    monsterInfo.damageFeedbackTime = 0.05f;
+    monsterInfo.damageFeedback = true;
 }
 
 void MonstersManager::removeRoomMonsters(const RoomCoords& coords)
 {
     for (auto& monsterInfo : m_monstersInfo) {
         RoomCoords monsterCoords;
-        monsterCoords.x = static_cast<uint>(monsterInfo.data[L"rx"].as_float());
-        monsterCoords.y = static_cast<uint>(monsterInfo.data[L"ry"].as_float());
+        monsterCoords.x = static_cast<uint>(monsterInfo.data[attributes::rx].as_float());
+        monsterCoords.y = static_cast<uint>(monsterInfo.data[attributes::ry].as_float());
 
         if (monsterCoords == coords)
             monsterInfo.status = MonsterStatus::TO_BE_REMOVED;
@@ -172,18 +189,14 @@ void MonstersManager::removeRoomMonsters(const RoomCoords& coords)
 
 void MonstersManager::addRoomMonster(const RoomCoords& coords, const std::wstring& monsterID)
 {
-    MonsterInfo monsterInfo;
+    auto& monsterInfo = *m_monstersInfo.get(m_monstersInfo.emplace());
     const auto& monsterData = m_data->monstersDB().get(monsterID);
 
     monsterInfo.status = MonsterStatus::TO_SPAWN;
     monsterInfo.data.create(monsterID);
-    monsterInfo.data[L"rx"].init_float(coords.x + 0.5f);
-    monsterInfo.data[L"ry"].init_float(coords.y + 0.5f);
+    monsterInfo.data[attributes::rx].init_float(coords.x + 0.5f);
+    monsterInfo.data[attributes::ry].init_float(coords.y + 0.5f);
     monsterInfo.hp = monsterData.startingHP;
-
-    m_monstersInfo.emplace_back(std::move(monsterInfo));
-
-    refreshMonstersData();
 }
 
 void MonstersManager::listRoomMonsters(const RoomCoords& coords, std::vector<Monster*>& monstersList) const
@@ -192,8 +205,8 @@ void MonstersManager::listRoomMonsters(const RoomCoords& coords, std::vector<Mon
 
     for (auto& monsterInfo : m_monstersInfo) {
         if (monsterInfo.status != MonsterStatus::RUNNING) continue;
-        if (static_cast<uint>(monsterInfo.data.at(L"rx").as_float()) != coords.x) continue;
-        if (static_cast<uint>(monsterInfo.data.at(L"ry").as_float()) != coords.y) continue;
+        if (static_cast<uint>(monsterInfo.data.at(attributes::rx).as_float()) != coords.x) continue;
+        if (static_cast<uint>(monsterInfo.data.at(attributes::ry).as_float()) != coords.y) continue;
 
         monstersList.emplace_back(monsterInfo.monster.get());
     }
@@ -201,25 +214,16 @@ void MonstersManager::listRoomMonsters(const RoomCoords& coords, std::vector<Mon
 
 void MonstersManager::setLocked(const Monster* monster, bool locked)
 {
-    for (auto& monsterInfo : m_monstersInfo) {
-        if (monsterInfo.monster.get() != monster) continue;
-        if (monsterInfo.status != MonsterStatus::RUNNING) continue;
-        monsterInfo.monster->setMoving(!locked);
-        monsterInfo.locked = locked;
-        return;
-    }
+    auto pMonsterInfo = m_monstersInfo.get(monster->managerHandle());
+    returnif (pMonsterInfo == nullptr || pMonsterInfo->status != MonsterStatus::RUNNING);
+
+    pMonsterInfo->monster->setMoving(!locked);
+    pMonsterInfo->locked = locked;
 }
 
 //---------------//
 //----- ICU -----//
 
-void MonstersManager::refreshMonstersData()
-{
-    for (auto& monsterInfo : m_monstersInfo)
-        if (monsterInfo.status == MonsterStatus::RUNNING)
-            monsterInfo.monster->bindElementData(monsterInfo.data);
-}
-
 void MonstersManager::refreshMonstersFromGraph()
 {
     for (auto& monsterInfo : m_monstersInfo)
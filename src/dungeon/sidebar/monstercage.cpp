@@ -22,7 +22,7 @@ MonsterCage::MonsterCage(std::wstring monsterID, Inter& inter, Data& data)
     m_monsterGeneric = &data.monstersGenerics().at(m_monsterID);
 
     // Events
-    setEmitter(&data);
+    setEmitter(&data, {events::monsterAdded, events::reserveCountdownChanged});
 
     // Background
     addPart(&m_reserveBackground);
@@ -94,10 +94,10 @@ void MonsterCage::receive(const context::Event& event)
 {
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
 
-    if (devent.type == "monster_added" && devent.monster.id == m_monsterID)
+    if (devent.type == events::monsterAdded && devent.monster.id == m_monsterID)
         refreshReservePuppetsCount();
 
-    else if (devent.type == "reserve_countdown_changed" && devent.monster.id == m_monsterID)
+    else if (devent.type == events::reserveCountdownChanged && devent.monster.id == m_monsterID)
         refreshHireBox();
 }
 
@@ -259,7 +259,7 @@ void MonsterCage::refreshReservePuppetsParameters(const uint monstersUpdateStart
         puppet->setLocalScale({m_scaleFactor, m_scaleFactor});
 
         // TODO Why 25.f? Use collision box, position 0.f means 0.f + colBox
-        float startOffset = alea::rand(25.f, reserveSize.x - 25.f);
+        float startOffset = alea::rand(25.f, reserveSize.x - 25.f, alea::Stream::VISUAL);
         puppet->setInitialLocalPosition({startOffset, 0.5f * reserveSize.y});
         puppet->setHorizontalRange(25.f, reserveSize.x - 25.f);
     }
@@ -105,9 +105,9 @@ void Sidebar::receive(const context::Event& event)
 {
     const auto& devent = reinterpret_cast<const dungeon::Event&>(event);
 
-    if (devent.type == "trap_generic_changed")
+    if (devent.type == events::trapGenericChanged)
         refreshTabTrapsContent();
-    else if (devent.type == "monster_generic_changed")
+    else if (devent.type == events::monsterGenericChanged)
         refreshTabMonstersContent();
 }
 
@@ -117,7 +117,7 @@ void Sidebar::receive(const context::Event& event)
 void Sidebar::useData(Data& data)
 {
     m_data = &data;
-    setEmitter(&data);
+    setEmitter(&data, {events::trapGenericChanged, events::monsterGenericChanged});
     m_summary.useData(data);
 
     refreshKnownMonsters();
@@ -84,15 +84,15 @@ void Summary::receive(const context::Event& event)
 {
     const auto& devent = *reinterpret_cast<const dungeon::Event*>(&event);
 
-    if (devent.type == "time_changed")
+    if (devent.type == events::timeChanged)
         refreshTimeBar();
-    else if (devent.type == "dosh_changed")
+    else if (devent.type == events::doshChanged)
         refreshDoshBar();
-    else if (devent.type == "soul_changed")
+    else if (devent.type == events::soulChanged)
         refreshSoulBar();
-    else if (devent.type == "fame_changed")
+    else if (devent.type == events::fameChanged)
         refreshClassBar();
-    else if (devent.type == "evil_changed")
+    else if (devent.type == events::evilChanged)
         refreshRankBar();
 }
 
@@ -102,7 +102,7 @@ void Summary::receive(const context::Event& event)
 void Summary::useData(Data& data)
 {
     m_data = &data;
-    setEmitter(&data);
+    setEmitter(&data, {events::timeChanged, events::doshChanged, events::soulChanged, events::fameChanged, events::evilChanged});
     refreshFromData();
 }
 
@@ -187,7 +187,7 @@ void Summary::refreshRankBar()
 
     auto evil = m_data->evilWallet().value();
 
-    m_rankingBars[RANKING_RANK].setText(alea::rand(rankNames));
+    m_rankingBars[RANKING_RANK].setText(alea::rand(rankNames, alea::Stream::VISUAL));
     m_rankingBars[RANKING_RANK].setPercent((evil % 100u) / 100.f);
 }
 
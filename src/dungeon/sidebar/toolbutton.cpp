@@ -82,7 +82,9 @@ ToolGrabbable::ToolGrabbable(scene::GrabbableSpawner& spawner, const std::string
     : baseClass(spawner)
 {
     addPart(&m_sprite);
-    m_sprite.setTexture(&context::context.textures.get(textureID));
+    auto region = context::context.textures.region(textureID);
+    m_sprite.setTexture(region.texture);
+    m_sprite.setTextureRect(region.rect);
     m_sprite.setSize(sizeHint());
     m_sprite.setOrigin(sizeHint() / 2.f);
 }
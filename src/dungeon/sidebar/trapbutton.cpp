@@ -65,7 +65,9 @@ TrapGrabbable::TrapGrabbable(scene::GrabbableSpawner& spawner, const std::wstrin
     auto textureID = "vanilla/traps/" + toString(trapID) + "/icon";
 
     addPart(&m_sprite);
-    m_sprite.setTexture(&context::context.textures.get(textureID));
+    auto region = context::context.textures.region(textureID);
+    m_sprite.setTexture(region.texture);
+    m_sprite.setTextureRect(region.rect);
     m_sprite.setSize(sizeHint());
     m_sprite.setOrigin(sizeHint() / 2.f);
 }
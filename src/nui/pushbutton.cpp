@@ -64,7 +64,9 @@ void PushButton::updateImageTexture()
 
     // Set the texture and add the image part if we need it now
     if (m_imageActive) {
-        m_image.setTexture(&context::context.textures.get(m_imageTextureID));
+        auto region = context::context.textures.region(m_imageTextureID);
+        m_image.setTexture(region.texture);
+        m_image.setTextureRect(region.rect);
         addPart(&m_image);
     }
 
@@ -0,0 +1,132 @@
+#include "resources/atlaspacker.hpp"
+
+#include "tools/platform-fixes.hpp" // find_if
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace resources;
+
+AtlasPacker::AtlasPacker(const sf::Vector2u& pageSize, uint padding)
+    : m_pageSize(pageSize)
+    , m_padding(padding)
+{
+}
+
+//-------------------//
+//----- Packing -----//
+
+std::vector<AtlasPacker::Placement> AtlasPacker::pack(const std::vector<sf::Vector2u>& sizes)
+{
+    std::vector<Placement> placements(sizes.size());
+    std::vector<std::vector<Segment>> skylines;
+    m_pagesHeights.clear();
+    m_packedArea = 0u;
+
+    // Tallest first, then widest, the order given breaking ties
+    std::vector<uint> order(sizes.size());
+    std::iota(std::begin(order), std::end(order), 0u);
+    std::stable_sort(std::begin(order), std::end(order), [&sizes] (uint a, uint b) {
+        if (sizes[a].y != sizes[b].y) return sizes[a].y > sizes[b].y;
+        return sizes[a].x > sizes[b].x;
+    });
+
+    for (auto index : order) {
+        const sf::Vector2u paddedSize(sizes[index].x + 2u * m_padding, sizes[index].y + 2u * m_padding);
+        if (paddedSize.x > m_pageSize.x || paddedSize.y > m_pageSize.y)
+            continue;
+
+        // First page where it fits, or a new one
+        sf::Vector2u position;
+        uint page = 0u;
+        while (page < skylines.size() && !findPosition(skylines[page], paddedSize, position))
+            ++page;
+
+        if (page == skylines.size()) {
+            skylines.push_back({{0u, 0u, m_pageSize.x}});
+            m_pagesHeights.emplace_back(0u);
+            position = {0u, 0u};
+        }
+
+        place(skylines[page], paddedSize, position);
+        m_pagesHeights[page] = std::max(m_pagesHeights[page], position.y + paddedSize.y);
+        m_packedArea += static_cast<uint64>(sizes[index].x) * sizes[index].y;
+
+        auto& placement = placements[index];
+        placement.page = page;
+        placement.rect = {static_cast<int>(position.x + m_padding), static_cast<int>(position.y + m_padding),
+                          static_cast<int>(sizes[index].x), static_cast<int>(sizes[index].y)};
+    }
+
+    return placements;
+}
+
+float AtlasPacker::occupancy() const
+{
+    uint64 usedArea = 0u;
+    for (auto height : m_pagesHeights)
+        usedArea += static_cast<uint64>(m_pageSize.x) * height;
+
+    returnif (usedArea == 0u) 0.f;
+    return static_cast<float>(m_packedArea) / static_cast<float>(usedArea);
+}
+
+//-------------------//
+//----- Skyline -----//
+
+bool AtlasPacker::findPosition(const std::vector<Segment>& skyline, const sf::Vector2u& size, sf::Vector2u& position) const
+{
+    bool found = false;
+    uint bestBottom = 0u;
+
+    for (uint i = 0u; i < skyline.size(); ++i) {
+        const auto x = skyline[i].x;
+        if (x + size.x > m_pageSize.x) break;
+
+        // The rectangle lies on the highest segment it spans
+        uint y = 0u;
+        for (uint j = i; j < skyline.size() && skyline[j].x < x + size.x; ++j)
+            y = std::max(y, skyline[j].y);
+
+        const auto bottom = y + size.y;
+        if (bottom > m_pageSize.y || (found && bottom >= bestBottom))
+            continue;
+
+        found = true;
+        bestBottom = bottom;
+        position = {x, y};
+    }
+
+    return found;
+}
+
+void AtlasPacker::place(std::vector<Segment>& skyline, const sf::Vector2u& size, const sf::Vector2u& position) const
+{
+    const auto right = position.x + size.x;
+
+    // The segments covered are replaced, the last one being cut
+    auto first = std::find_if(skyline, [&position] (const Segment& segment) { return segment.x == position.x; });
+    auto last = first;
+    while (last != std::end(skyline) && last->x + last->width <= right)
+        ++last;
+
+    if (last != std::end(skyline) && last->x < right) {
+        last->width -= right - last->x;
+        last->x = right;
+    }
+
+    first = skyline.erase(first, last);
+    first = skyline.insert(first, {position.x, position.y + size.y, size.x});
+
+    // Merging neighbours at the same height
+    for (uint i = 1u; i < skyline.size();) {
+        if (skyline[i - 1u].y == skyline[i].y) {
+            skyline[i - 1u].width += skyline[i].width;
+            skyline.erase(std::begin(skyline) + i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
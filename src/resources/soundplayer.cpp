@@ -2,6 +2,7 @@
 
 #include "tools/platform-fixes.hpp" // erase_if
 #include "core/gettext.hpp" // string2wstring
+#include "tools/tools.hpp"
 
 #include <SFML/Audio/Listener.hpp>
 #include <cmath>
@@ -44,6 +45,8 @@ void SoundPlayer::play(const std::string& id)
 
 void SoundPlayer::play(const std::string& id, sf::Vector2f position)
 {
+    returnif (m_muted);
+
     m_sounds.emplace_back(std::make_unique<sf::Sound>());
     auto& sound = *m_sounds.back();
 
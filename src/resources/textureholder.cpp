@@ -0,0 +1,278 @@
+#include "resources/textureholder.hpp"
+
+#include "resources/atlaspacker.hpp"
+#include "tools/debug.hpp"
+#include "tools/filesystem.hpp"
+#include "tools/platform-fixes.hpp" // make_unique
+#include "tools/string.hpp"
+#include "tools/tools.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace resources;
+
+namespace
+{
+    //! The size of the pages, supported by any graphic card.
+    const sf::Vector2u pageSize(2048u, 2048u);
+
+    //! Space around each texture, its edges being extruded there, so that smooth filtering does not bleed.
+    const uint padding = 2u;
+
+    //! The biggest texture side packed, bigger ones are not worth it.
+    const uint maxSide = 512u;
+
+    //! Change whenever the disk cache format changes.
+    const uint64 atlasVersion = 1u;
+
+    //! Whether the string starts with the prefix.
+    bool startsWith(const std::string& string, const std::string& prefix)
+    {
+        return string.compare(0u, prefix.size(), prefix) == 0;
+    }
+
+    //! Copy the image into the page at the position, its edges repeated once around.
+    void blit(sf::Image& page, const sf::Image& image, const sf::Vector2u& position)
+    {
+        const auto size = image.getSize();
+        const auto w = static_cast<int>(size.x);
+        const auto h = static_cast<int>(size.y);
+        const auto x = position.x;
+        const auto y = position.y;
+
+        page.copy(image, x, y);
+        page.copy(image, x, y - 1u, {0, 0, w, 1});
+        page.copy(image, x, y + size.y, {0, h - 1, w, 1});
+        page.copy(image, x - 1u, y, {0, 0, 1, h});
+        page.copy(image, x + size.x, y, {w - 1, 0, 1, h});
+
+        page.setPixel(x - 1u, y - 1u, image.getPixel(0u, 0u));
+        page.setPixel(x + size.x, y - 1u, image.getPixel(size.x - 1u, 0u));
+        page.setPixel(x - 1u, y + size.y, image.getPixel(0u, size.y - 1u));
+        page.setPixel(x + size.x, y + size.y, image.getPixel(size.x - 1u, size.y - 1u));
+    }
+}
+
+//-------------------//
+//----- Storage -----//
+
+void TextureHolder::free(const std::string& id)
+{
+    baseClass::free(id);
+    m_packed.erase(id);
+}
+
+void TextureHolder::freeMatchingPrefix(const std::string& prefix)
+{
+    baseClass::freeMatchingPrefix(prefix);
+
+    // Textures are within their folder, so are freed with their pages
+    for (auto it = std::begin(m_packed); it != std::end(m_packed);)
+        it = startsWith(it->first, prefix)? m_packed.erase(it) : std::next(it);
+
+    for (auto it = std::begin(m_pages); it != std::end(m_pages);)
+        it = startsWith(it->first, prefix)? m_pages.erase(it) : std::next(it);
+}
+
+//------------------//
+//----- Access -----//
+
+bool TextureHolder::stored(const std::string& id) const
+{
+    return baseClass::stored(id) || m_packed.find(id) != std::end(m_packed);
+}
+
+sf::Texture& TextureHolder::get(const std::string& id)
+{
+    // Packed only, but something needs it whole (repeated, shaders, full size...)
+    if (!baseClass::stored(id)) {
+        auto found = m_packed.find(id);
+        if (found != std::end(m_packed))
+            load(found->second.filename).setSmooth(true);
+    }
+
+    return baseClass::get(id);
+}
+
+TextureHolder::Region TextureHolder::region(const std::string& id)
+{
+    auto found = m_packed.find(id);
+    returnif (found != std::end(m_packed)) Region{found->second.page, found->second.rect};
+
+    const auto& texture = get(id);
+    const auto& size = texture.getSize();
+    return Region{&texture, {0, 0, static_cast<int>(size.x), static_cast<int>(size.y)}};
+}
+
+//-------------------//
+//----- Atlases -----//
+
+uint TextureHolder::pagesCount() const
+{
+    uint pagesCount = 0u;
+    for (const auto& pages : m_pages)
+        pagesCount += pages.second.size();
+    return pagesCount;
+}
+
+void TextureHolder::setAtlasDirectory(const std::string& directory)
+{
+    m_atlasDirectory = directory;
+    returnif (m_atlasDirectory.empty());
+
+    createDirectory(toWString(m_atlasDirectory));
+}
+
+bool TextureHolder::loadAtlas(const std::string& folder, const std::vector<std::string>& filenames)
+{
+    returnif (m_atlasDirectory.empty()) false;
+
+    std::ifstream stream(atlasFile(folder, ".atlas"));
+    returnif (!stream.is_open()) false;
+
+    // Header is the signature of the files packed, then the pages count
+    uint64 signature = 0u;
+    uint pagesCount = 0u;
+    stream >> signature >> pagesCount;
+    returnif (!stream || signature != atlasSignature(filenames)) false;
+
+    std::vector<std::unique_ptr<sf::Texture>> pages;
+    for (uint page = 0u; page < pagesCount; ++page) {
+        auto texture = std::make_unique<sf::Texture>();
+        returnif (!texture->loadFromFile(atlasFile(folder, "_" + std::to_string(page) + ".png"))) false;
+        texture->setSmooth(true);
+        pages.emplace_back(std::move(texture));
+    }
+
+    // Then one line per texture packed: page, rect and file
+    std::map<std::string, PackedTexture> packed;
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty()) continue;
+
+        PackedTexture texture;
+        uint page = 0u;
+        std::istringstream lineStream(line);
+        lineStream >> page >> texture.rect.left >> texture.rect.top >> texture.rect.width >> texture.rect.height;
+        std::getline(lineStream >> std::ws, texture.filename);
+
+        returnif (!lineStream || page >= pagesCount) false;
+        texture.page = pages[page].get();
+        packed[getID(texture.filename)] = std::move(texture);
+    }
+
+    for (auto& texture : packed)
+        m_packed[texture.first] = std::move(texture.second);
+    m_pages[folder] = std::move(pages);
+    return true;
+}
+
+void TextureHolder::packAtlas(const std::string& folder, const std::vector<std::string>& filenames,
+                              const std::vector<std::unique_ptr<sf::Image>>& images)
+{
+    massert(filenames.size() == images.size(), "Each file should have its image.");
+
+    // Only the small ones, in order, so that the same files give the same atlas
+    std::vector<uint> indices;
+    std::vector<sf::Vector2u> sizes;
+    for (uint i = 0u; i < images.size(); ++i) {
+        if (images[i] == nullptr) continue;
+        const auto& size = images[i]->getSize();
+        if (size.x == 0u || size.y == 0u || size.x > maxSide || size.y > maxSide) continue;
+        indices.emplace_back(i);
+        sizes.emplace_back(size);
+    }
+    returnif (indices.empty());
+
+    AtlasPacker packer(pageSize, padding);
+    auto placements = packer.pack(sizes);
+
+    // Pages are trimmed to what is used
+    std::vector<sf::Vector2u> pagesSizes(packer.pagesCount(), {0u, 0u});
+    for (uint page = 0u; page < packer.pagesCount(); ++page)
+        pagesSizes[page].y = packer.pagesHeights()[page];
+    for (const auto& placement : placements)
+        pagesSizes[placement.page].x = std::max(pagesSizes[placement.page].x, placement.rect.left + placement.rect.width + padding);
+
+    std::vector<sf::Image> pagesImages(packer.pagesCount());
+    for (uint page = 0u; page < packer.pagesCount(); ++page)
+        pagesImages[page].create(pagesSizes[page].x, pagesSizes[page].y, sf::Color::Transparent);
+
+    for (uint i = 0u; i < indices.size(); ++i) {
+        const auto& rect = placements[i].rect;
+        blit(pagesImages[placements[i].page], *images[indices[i]], sf::Vector2u(rect.left, rect.top));
+    }
+
+    // Uploading
+    std::vector<std::unique_ptr<sf::Texture>> pages;
+    for (const auto& pageImage : pagesImages) {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromImage(pageImage))
+            mquit("Failed to create an atlas page for " << folder << ". Ouch.");
+        texture->setSmooth(true);
+        pages.emplace_back(std::move(texture));
+    }
+
+    for (uint i = 0u; i < indices.size(); ++i) {
+        const auto& filename = filenames[indices[i]];
+        m_packed[getID(filename)] = PackedTexture{pages[placements[i].page].get(), placements[i].rect, filename};
+    }
+
+    m_pages[folder] = std::move(pages);
+
+    // Disk cache, the layout last, so that it is invalid if pages were not all saved
+    returnif (m_atlasDirectory.empty());
+
+    for (uint page = 0u; page < pagesImages.size(); ++page)
+        returnif (!pagesImages[page].saveToFile(atlasFile(folder, "_" + std::to_string(page) + ".png")));
+
+    std::ofstream stream(atlasFile(folder, ".atlas"));
+    returnif (!stream.is_open());
+
+    stream << atlasSignature(filenames) << ' ' << pagesImages.size() << std::endl;
+    for (uint i = 0u; i < indices.size(); ++i) {
+        const auto& rect = placements[i].rect;
+        stream << placements[i].page << ' ' << rect.left << ' ' << rect.top << ' ' << rect.width << ' ' << rect.height
+               << ' ' << filenames[indices[i]] << std::endl;
+    }
+}
+
+uint64 TextureHolder::atlasSignature(const std::vector<std::string>& filenames) const
+{
+    // FNV-1a over what changes the atlas
+    uint64 signature = 14695981039346656037ull;
+    auto mix = [&signature] (const void* data, std::size_t size) {
+        const auto bytes = static_cast<const uint8*>(data);
+        for (std::size_t i = 0u; i < size; ++i) {
+            signature ^= bytes[i];
+            signature *= 1099511628211ull;
+        }
+    };
+
+    const uint64 parameters[] = {atlasVersion, pageSize.x, pageSize.y, padding, maxSide};
+    mix(parameters, sizeof(parameters));
+
+    for (const auto& filename : filenames) {
+        const auto modificationTime = fileModificationTime(filename);
+        mix(filename.data(), filename.size() + 1u);
+        mix(&modificationTime, sizeof(uint64));
+    }
+
+    return signature;
+}
+
+std::string TextureHolder::atlasFile(const std::string& folder, const std::string& suffix) const
+{
+    // Escape the path, so that different folders cannot share a file: vanilla/my_traps -> vanilla_smy_utraps.atlas
+    std::string name;
+    for (auto c : folder) {
+        if (c == '_') name += "_u";
+        else if (c == '/' || c == '\\') name += "_s";
+        else name += c;
+    }
+    return m_atlasDirectory + "/" + name + suffix;
+}
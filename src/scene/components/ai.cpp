@@ -1,9 +1,226 @@
 #include "scene/components/ai.hpp"
 
+#include "scene/components/luacache.hpp"
+#include "tools/platform-fixes.hpp" // make_unique
+#include "tools/tools.hpp"
+
+#include <algorithm>
+#include <iostream>
+
 using namespace scene;
 
+bool AI::s_sharedVMs = true;
+uint AI::s_vmsPerScript = 1u;
+std::unordered_map<std::string, std::vector<std::unique_ptr<LuaVM>>> AI::s_vms;
+
+//-----------------//
+//----- LuaVM -----//
+
+LuaVM::LuaVM()
+    : m_L(luaL_newstate())
+    , m_lua(m_L)
+{
+    luaL_openlibs(m_L);
+
+    // Environments will fall back to the original global table
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+    m_globalsRef = luaL_ref(m_L, LUA_REGISTRYINDEX);
+}
+
+LuaVM::~LuaVM()
+{
+    lua_close(m_L);
+}
+
+size_t LuaVM::memoryUsage() const
+{
+    return 1024u * lua_gc(m_L, LUA_GCCOUNT, 0) + lua_gc(m_L, LUA_GCCOUNTB, 0);
+}
+
+//----- Instances
+
+bool LuaVM::compile(const std::string& file)
+{
+    // Already compiled from the latest version of the file
+    auto chunk = s_luaCache.chunk(file);
+    returnif (chunk == nullptr) false;
+    returnif (m_chunkRef != LUA_NOREF && m_chunkHash == chunk->hash) true;
+
+    const auto chunkName = "@" + file;
+    if (luaL_loadbufferx(m_L, chunk->bytecode.data(), chunk->bytecode.size(), chunkName.c_str(), "b") != LUA_OK
+        || lua_pcall(m_L, 0, 1, 0) != LUA_OK) {
+        std::cerr << "/!\\ LUA " << lua_tostring(m_L, -1) << std::endl;
+        lua_pop(m_L, 1);
+        return false;
+    }
+
+    // Instances already running keep the previous version
+    luaL_unref(m_L, LUA_REGISTRYINDEX, m_chunkRef);
+    m_chunkRef = luaL_ref(m_L, LUA_REGISTRYINDEX);
+    m_chunkHash = chunk->hash;
+    return true;
+}
+
+int LuaVM::createInstance(Entity* entity)
+{
+    returnif (m_chunkRef == LUA_NOREF) LUA_NOREF;
+
+    // Environment, with the C++ API and standard libraries accessible
+    lua_newtable(m_L);
+    lua_newtable(m_L);
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_globalsRef);
+    lua_setfield(m_L, -2, "__index");
+    lua_setmetatable(m_L, -2);
+
+    // Run the script within it
+    auto previousActive = m_active;
+    m_active = entity;
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_chunkRef);
+    lua_pushvalue(m_L, -2);
+    auto status = lua_pcall(m_L, 1, 0, 0);
+    m_active = previousActive;
+
+    if (status != LUA_OK) {
+        std::cerr << "/!\\ LUA " << lua_tostring(m_L, -1) << std::endl;
+        lua_pop(m_L, 2);
+        return LUA_NOREF;
+    }
+
+    m_instancesCount += 1u;
+    return luaL_ref(m_L, LUA_REGISTRYINDEX);
+}
+
+void LuaVM::destroyInstance(int instanceRef)
+{
+    m_instancesCount -= 1u;
+    luaL_unref(m_L, LUA_REGISTRYINDEX, instanceRef);
+}
+
+void LuaVM::activate(Entity* entity, int instanceRef)
+{
+    m_active = entity;
+    returnif (m_activeRef == instanceRef);
+    m_activeRef = instanceRef;
+
+    // Global accesses from C++ now target the environment
+    lua_rawgeti(m_L, LUA_REGISTRYINDEX, (instanceRef != LUA_NOREF)? instanceRef : m_globalsRef);
+    lua_rawseti(m_L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+}
+
+//--------------------//
+//----- LuaScope -----//
+
+LuaScope::LuaScope(LuaVM& vm, Entity* entity, int instanceRef)
+    : m_vm(&vm)
+    , m_previousActive(vm.m_active)
+    , m_previousRef(vm.m_activeRef)
+{
+    vm.m_scopesCount += 1u;
+    vm.activate(entity, instanceRef);
+}
+
+LuaScope::LuaScope(LuaScope&& other)
+    : m_vm(other.m_vm)
+    , m_previousActive(other.m_previousActive)
+    , m_previousRef(other.m_previousRef)
+{
+    other.m_vm = nullptr;
+}
+
+LuaScope::~LuaScope()
+{
+    returnif (m_vm == nullptr);
+    m_vm->activate(m_previousActive, m_previousRef);
+    m_vm->m_scopesCount -= 1u;
+}
+
+//--------------//
+//----- AI -----//
+
 AI::AI(scene::Entity& entity)
     : baseClass(entity)
-    , m_lua(true)
 {
 }
+
+AI::~AI()
+{
+    unload();
+}
+
+//----- Lua state
+
+bool AI::load(const std::string& file, const std::function<void(LuaVM&)>& onNewVM)
+{
+    unload();
+
+    // Find the least used VM running this script, or create one
+    if (s_sharedVMs) {
+        releaseUnusedVMs(file);
+        m_file = file;
+
+        auto& vms = s_vms[file];
+        if (vms.size() < s_vmsPerScript) {
+            vms.emplace_back(std::make_unique<LuaVM>());
+            onNewVM(*vms.back());
+            m_vm = vms.back().get();
+        }
+        else {
+            auto pVM = std::min_element(std::begin(vms), std::end(vms), [] (const std::unique_ptr<LuaVM>& a, const std::unique_ptr<LuaVM>& b) {
+                return a->instancesCount() < b->instancesCount();
+            });
+            m_vm = pVM->get();
+        }
+    }
+    else {
+        m_ownVM = std::make_unique<LuaVM>();
+        onNewVM(*m_ownVM);
+        m_vm = m_ownVM.get();
+    }
+
+    if (m_vm->compile(file))
+        m_instanceRef = m_vm->createInstance(&m_entity);
+
+    // Not keeping a VM that might be released
+    if (m_instanceRef == LUA_NOREF) {
+        unload();
+        return false;
+    }
+
+    return true;
+}
+
+LuaScope AI::lua()
+{
+    // No script loaded, calls will just fail
+    if (m_vm == nullptr) {
+        m_ownVM = std::make_unique<LuaVM>();
+        m_vm = m_ownVM.get();
+    }
+
+    return LuaScope(*m_vm, &m_entity, m_instanceRef);
+}
+
+void AI::unload()
+{
+    if (m_vm != nullptr && m_instanceRef != LUA_NOREF)
+        m_vm->destroyInstance(m_instanceRef);
+
+    m_instanceRef = LUA_NOREF;
+    m_ownVM = nullptr;
+    m_vm = nullptr;
+
+    returnif (m_file.empty());
+    releaseUnusedVMs(m_file);
+    m_file.clear();
+}
+
+void AI::releaseUnusedVMs(const std::string& file)
+{
+    auto found = s_vms.find(file);
+    returnif (found == std::end(s_vms));
+
+    // One still running a call is released later, by the next AI loading or unloading the script
+    auto& vms = found->second;
+    std::erase_if(vms, [] (const std::unique_ptr<LuaVM>& vm) { return vm->instancesCount() == 0u && !vm->inUse(); });
+    if (vms.empty()) s_vms.erase(found);
+}
@@ -62,5 +62,7 @@ void LightNormals::onLayerChanged(Layer* layer)
 
 void LightNormals::setNormalsTexture(const std::string& textureID)
 {
-    m_shape.setTexture(&context::context.textures.get(textureID));
+    auto region = context::context.textures.region(textureID);
+    m_shape.setTexture(region.texture);
+    m_shape.setTextureRect(region.rect);
 }
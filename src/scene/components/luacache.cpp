@@ -0,0 +1,193 @@
+#include "scene/components/luacache.hpp"
+
+#include "tools/filesystem.hpp"
+#include "tools/string.hpp"
+#include "tools/tools.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace scene;
+
+//----------------------------//
+//----- Static variables -----//
+
+LuaCache scene::s_luaCache;
+
+namespace
+{
+    //! Appends the bytecode dumped to a string.
+    int dumpWriter(lua_State*, const void* p, size_t size, void* userData)
+    {
+        static_cast<std::string*>(userData)->append(static_cast<const char*>(p), size);
+        return 0;
+    }
+
+    //! How long a chunk is used without reading its file again.
+    constexpr auto checkPeriod = std::chrono::seconds(1);
+
+    //! FNV-1a of the source.
+    uint64 sourceHash(const std::string& source)
+    {
+        uint64 hash = 14695981039346656037ull;
+        for (auto c : source) {
+            hash ^= static_cast<uint8>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+LuaCache::LuaCache()
+    : m_L(luaL_newstate())
+{
+}
+
+LuaCache::~LuaCache()
+{
+    lua_close(m_L);
+}
+
+//------------------//
+//----- Chunks -----//
+
+const LuaCache::Chunk* LuaCache::chunk(const std::string& file)
+{
+    // Checked recently, the file is not read for each instance
+    const auto now = std::chrono::steady_clock::now();
+    auto& chunk = m_chunks[file];
+    returnif (!chunk.bytecode.empty() && now - chunk.checkTime < checkPeriod) &chunk;
+    chunk.checkTime = now;
+
+    // Up to date, comparing contents as modification times are too coarse to see quick edits
+    std::string source;
+    if (!readSource(file, source)) {
+        m_chunks.erase(file);
+        return nullptr;
+    }
+
+    const auto hash = sourceHash(source);
+    returnif (!chunk.bytecode.empty() && chunk.hash == hash) &chunk;
+
+    // First time or file changed
+    chunk.hash = hash;
+    chunk.bytecode.clear();
+    if (loadFromDisk(file, chunk))
+        return &chunk;
+
+    if (!compile(file, source, chunk)) {
+        m_chunks.erase(file);
+        return nullptr;
+    }
+
+    saveToDisk(file, chunk);
+    return &chunk;
+}
+
+void LuaCache::clear()
+{
+    m_chunks.clear();
+}
+
+//----------------------//
+//----- Disk cache -----//
+
+void LuaCache::setDirectory(const std::string& directory)
+{
+    m_directory = directory;
+    returnif (m_directory.empty());
+
+    createDirectory(toWString(m_directory));
+}
+
+//---------------------//
+//----- Internals -----//
+
+bool LuaCache::readSource(const std::string& file, std::string& source) const
+{
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream.is_open()) {
+        std::cerr << "/!\\ LUA Cannot open file " << file << "." << std::endl;
+        return false;
+    }
+
+    source.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool LuaCache::compile(const std::string& file, const std::string& source, Chunk& chunk)
+{
+    // The script becomes the body of a function taking its environment,
+    // the header is kept on the first line so that error lines are still right
+    const auto code = "return function(_ENV, ...) " + source + "\nend";
+    const auto chunkName = "@" + file;
+
+    if (luaL_loadbufferx(m_L, code.c_str(), code.size(), chunkName.c_str(), "t") != LUA_OK) {
+        std::cerr << "/!\\ LUA " << lua_tostring(m_L, -1) << std::endl;
+        lua_pop(m_L, 1);
+        return false;
+    }
+
+    // Debug information is kept, for error messages
+#if LUA_VERSION_NUM >= 503
+    lua_dump(m_L, dumpWriter, &chunk.bytecode, 0);
+#else
+    lua_dump(m_L, dumpWriter, &chunk.bytecode);
+#endif
+    lua_pop(m_L, 1);
+    return true;
+}
+
+bool LuaCache::isLoadable(const std::string& file, const std::string& bytecode)
+{
+    const auto chunkName = "@" + file;
+    auto status = luaL_loadbufferx(m_L, bytecode.data(), bytecode.size(), chunkName.c_str(), "b");
+    lua_pop(m_L, 1);
+    return status == LUA_OK;
+}
+
+bool LuaCache::loadFromDisk(const std::string& file, Chunk& chunk)
+{
+    returnif (m_directory.empty()) false;
+
+    std::ifstream stream(diskFile(file), std::ios::binary);
+    returnif (!stream.is_open()) false;
+
+    // Header is the hash of the source compiled
+    uint64 hash = 0u;
+    stream.read(reinterpret_cast<char*>(&hash), sizeof(uint64));
+    returnif (!stream || hash != chunk.hash) false;
+
+    // Bytecode from another Lua version is ignored
+    chunk.bytecode.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    if (chunk.bytecode.empty() || !isLoadable(file, chunk.bytecode)) {
+        chunk.bytecode.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void LuaCache::saveToDisk(const std::string& file, const Chunk& chunk) const
+{
+    returnif (m_directory.empty());
+
+    std::ofstream stream(diskFile(file), std::ios::binary);
+    returnif (!stream.is_open());
+
+    stream.write(reinterpret_cast<const char*>(&chunk.hash), sizeof(uint64));
+    stream.write(chunk.bytecode.data(), chunk.bytecode.size());
+}
+
+std::string LuaCache::diskFile(const std::string& file) const
+{
+    // Escape the path, so that different scripts cannot share a file: res/my_traps/ai.lua -> res_smy_utraps_sai.luac
+    std::string name;
+    for (auto c : file) {
+        if (c == '_') name += "_u";
+        else if (c == '/' || c == '\\') name += "_s";
+        else name += c;
+    }
+    return m_directory + "/" + name + "c";
+}
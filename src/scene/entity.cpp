@@ -3,6 +3,7 @@
 #include "context/context.hpp"
 #include "scene/components/component.hpp"
 #include "scene/graph.hpp"
+#include "scene/spritebatch.hpp"
 #include "tools/debug.hpp"
 #include "tools/tools.hpp"
 #include "tools/vector.hpp"
@@ -45,17 +46,24 @@ Entity::~Entity()
 //----- Routine -----//
 
 void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    drawCulled(target, states, tools::viewRect(target.getView()));
+
+    // The caller might change the target right after
+    SpriteBatch::flushActive(target);
+}
+
+void Entity::drawCulled(sf::RenderTarget& target, sf::RenderStates states, const sf::FloatRect& viewRect) const
 {
     returnif (!m_visible);
 
     // Check if this entity is not visible because completely out
     // of the view rect. If so, no need for drawing itself and its children.
-    // Note: we're not checking entities with no size for they might just not know themself (scene::AnimatedSprite).
-    if (m_size.x > 0.f && m_size.y > 0.f) {
-        // OPTIM do not recompute that each time
-        sf::FloatRect viewRect{target.getView().getCenter() - target.getView().getSize() / 2.f, target.getView().getSize()};
-        viewRect = tools::intersect(viewRect, globalBounds());
-        returnif (viewRect.width < 0.f || viewRect.height < 0.f);
+    // Note: entities with no size might not know their bounds (scene::AnimatedSprite), these are always drawn.
+    sf::FloatRect bounds;
+    if (cullingBounds(bounds)) {
+        auto visibleRect = tools::intersect(viewRect, bounds);
+        returnif (visibleRect.width < 0.f || visibleRect.height < 0.f);
     }
 
     states.transform = getTransform();
@@ -68,15 +76,18 @@ void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const
         // Draw self
         if (!m_transparent) {
             drawParts(target, states);
+
+            if (drawsInternalDirectly()) SpriteBatch::flushActive(target);
             drawInternal(target, states);
 
+            if (!m_components.empty()) SpriteBatch::flushActive(target);
             for (const auto& component : m_components)
                 reinterpret_cast<scene::Component*>(component.second)->draw(target, states);
         }
 
         // Draw children - DFS
         for (auto& child : m_children)
-            child->draw(target, states);
+            child->drawCulled(target, states, viewRect);
 
         return;
     }
@@ -102,15 +113,18 @@ void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const
         // Draw self
         if (!m_transparent) {
             drawParts(target, states, clipArea);
+
+            if (drawsInternalDirectly()) SpriteBatch::flushActive(target);
             drawInternal(target, states);
 
+            if (!m_components.empty()) SpriteBatch::flushActive(target);
             for (const auto& component : m_components)
                 reinterpret_cast<scene::Component*>(component.second)->draw(target, states, clipArea);
         }
 
         // Draw children - DFS
         for (auto& child : m_children)
-            child->draw(target, states);
+            child->drawCulled(target, states, viewRect);
     }
 
     // // Reset previous clipping
@@ -119,9 +133,37 @@ void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const
     // target.setClippingArea(parentClippingAreaInt);
 }
 
+bool Entity::cullingBounds(sf::FloatRect& bounds) const
+{
+    if (m_cullingBoundsChanges) {
+        m_cullingBoundsChanges = false;
+
+        // Sized entities are trusted to draw within their size
+        if (m_size.x > 0.f && m_size.y > 0.f) {
+            m_cullingBounded = true;
+            m_cullingBounds = globalBounds();
+        }
+        // Others are bounded by their children, if drawing nothing themselves
+        else {
+            m_cullingBounded = !m_children.empty() && m_parts.empty() && m_components.empty();
+            m_cullingBounds = {0.f, 0.f, -1.f, -1.f};
+            for (const auto& child : m_children) {
+                sf::FloatRect childBounds;
+                m_cullingBounded = m_cullingBounded && child->cullingBounds(childBounds);
+                if (!m_cullingBounded) break;
+                m_cullingBounds = tools::unite(m_cullingBounds, childBounds);
+            }
+        }
+    }
+
+    bounds = m_cullingBounds;
+    return m_cullingBounded;
+}
+
 void Entity::drawParts(sf::RenderTarget& target, sf::RenderStates states) const
 {
     const sf::Shader* initialShader = states.shader;
+    auto batch = SpriteBatch::active(target);
 
     // Drawing parts
     for (auto& part : m_parts)
@@ -140,8 +182,14 @@ void Entity::drawParts(sf::RenderTarget& target, sf::RenderStates states) const
         //     target.setClippingArea(sf::IntRect(partClipArea.left, partClipArea.top, partClipArea.width, partClipArea.height));
         // }
 
-        // Effectively drawing this part
-        target.draw(*part.drawable, states);
+        // Effectively drawing this part, batched if a sprite
+        if (batch != nullptr && part.sprite != nullptr) {
+            batch->draw(*part.sprite, states);
+        }
+        else {
+            if (batch != nullptr) batch->flush();
+            target.draw(*part.drawable, states);
+        }
 
         // // Restore the previous clipping
         // if (part.clipping)
@@ -156,6 +204,7 @@ void Entity::drawParts(sf::RenderTarget& target, sf::RenderStates states) const
 void Entity::drawParts(sf::RenderTarget& target, sf::RenderStates states, const sf::FloatRect& clipArea) const
 {
     const sf::Shader* initialShader = states.shader;
+    auto batch = SpriteBatch::active(target);
 
     // Drawing parts
     for (auto& part : m_parts)
@@ -175,8 +224,14 @@ void Entity::drawParts(sf::RenderTarget& target, sf::RenderStates states, const
         //     target.setClippingArea(sf::IntRect(partClipArea.left, partClipArea.top, partClipArea.width, partClipArea.height));
         // }
 
-        // Effectively drawing this part
-        target.draw(*part.drawable, states);
+        // Effectively drawing this part, batched if a sprite
+        if (batch != nullptr && part.sprite != nullptr) {
+            batch->draw(*part.sprite, states);
+        }
+        else {
+            if (batch != nullptr) batch->flush();
+            target.draw(*part.drawable, states);
+        }
 
         // // Restore the previous clipping
         // if (part.clipping)
@@ -285,6 +340,7 @@ void Entity::detachChild(Entity& child)
     child.setGraph(nullptr);
     child.setLayer(nullptr);
     m_children.erase(found);
+    refreshBoundsChanges();
 }
 
 void Entity::detachChildren()
@@ -296,17 +352,27 @@ void Entity::detachChildren()
     }
 
     m_children.clear();
+    refreshBoundsChanges();
 }
 
-Entity* Entity::firstOver(const sf::Vector2f& position)
+Entity* Entity::firstOver(const sf::Vector2f& position, bool indexed)
 {
     // Invisible, so are the children
     // Note: transparency does not affect detectability
     returnif (!m_visible) nullptr;
 
+    // Nothing to find here, with a margin as inverse transforms might round differently
+    if (indexed) {
+        const auto& bounds = pickingBounds();
+        const float margin = 0.01f;
+        returnif (bounds.width < 0.f || bounds.height < 0.f) nullptr;
+        returnif (position.x < bounds.left - margin || position.x > bounds.left + bounds.width + margin) nullptr;
+        returnif (position.y < bounds.top - margin || position.y > bounds.top + bounds.height + margin) nullptr;
+    }
+
     // Reversed-DFS search for first children over position
     for (const auto& child : std::reverse(m_children)) {
-        Entity* entity = child->firstOver(position);
+        Entity* entity = child->firstOver(position, indexed);
         returnif (entity != nullptr) entity;
     }
 
@@ -324,6 +390,23 @@ Entity* Entity::firstOver(const sf::Vector2f& position)
     return this;
 }
 
+const sf::FloatRect& Entity::pickingBounds() const
+{
+    if (m_pickingBoundsChanges) {
+        // Only sized entities can be over a position themselves
+        m_pickingBounds = {0.f, 0.f, -1.f, -1.f};
+        if (m_size.x > 0.f && m_size.y > 0.f)
+            m_pickingBounds = globalBounds();
+
+        for (const auto& child : m_children)
+            m_pickingBounds = tools::unite(m_pickingBounds, child->pickingBounds());
+
+        m_pickingBoundsChanges = false;
+    }
+
+    return m_pickingBounds;
+}
+
 //---------------------------//
 //----- Focusing system -----//
 
@@ -419,6 +502,7 @@ Entity* Entity::previousFocusable()
 void Entity::clearParts()
 {
     m_parts.clear();
+    refreshBoundsChanges();
 }
 
 void Entity::addPart(sf::Drawable* drawable)
@@ -428,7 +512,8 @@ void Entity::addPart(sf::Drawable* drawable)
         if (part.drawable == drawable)
             mquit("Trying to add a part that was already added.");
 
-    m_parts.push_back({drawable, nullptr, false});
+    m_parts.push_back({drawable, nullptr, false, {}, dynamic_cast<const sf::Sprite*>(drawable)});
+    refreshBoundsChanges();
 }
 
 void Entity::removePart(sf::Drawable* drawable)
@@ -436,6 +521,7 @@ void Entity::removePart(sf::Drawable* drawable)
     for (auto it = m_parts.begin(); it != m_parts.end(); ++it) {
         if (it->drawable == drawable) {
             m_parts.erase(it);
+            refreshBoundsChanges();
             return;
         }
     }
@@ -502,9 +588,14 @@ sf::FloatRect Entity::localBounds() const
     return {0.f, 0.f, m_size.x, m_size.y};
 }
 
-sf::FloatRect Entity::globalBounds() const
+const sf::FloatRect& Entity::globalBounds() const
 {
-    return getTransform().transformRect(localBounds());
+    if (m_globalBoundsChanges) {
+        m_globalBounds = getTransform().transformRect(localBounds());
+        m_globalBoundsChanges = false;
+    }
+
+    return m_globalBounds;
 }
 
 void Entity::setSize(const sf::Vector2f& inSize)
@@ -513,6 +604,7 @@ void Entity::setSize(const sf::Vector2f& inSize)
 
     m_size = inSize;
     m_sizeChanges = true;
+    refreshBoundsChanges();
 
     if (!m_focusOwned)
         setFocusRect({0.f, 0.f, m_size.x, m_size.y});
@@ -531,6 +623,7 @@ void Entity::setLocalPosition(const sf::Vector2f& inLocalPosition)
 
     refreshKeepInsideLocalRect();
     refreshFromLocalPosition();
+    onLocalPositionChanges();
 }
 
 void Entity::setShader(const std::string& shaderID)
@@ -554,6 +647,7 @@ void Entity::resetClipAreas()
 {
     m_clipAreas.clear();
     m_globalClipAreas.clear();
+    refreshHitTests();
 }
 
 void Entity::addClipArea(const sf::FloatRect& clipArea, bool absolute)
@@ -590,6 +684,7 @@ void Entity::refreshRelativePosition()
 void Entity::refreshFromLocal()
 {
     m_localChanges = true;
+    refreshBoundsChanges();
 
     if (m_parent != nullptr) {
         setPosition(m_parent->getPosition() - m_parent->getOrigin());
@@ -615,6 +710,7 @@ void Entity::refreshFromLocal()
 void Entity::refreshFromLocalPosition()
 {
     m_localChanges = true;
+    refreshBoundsChanges();
 
     if (m_parent != nullptr) {
         setPosition(m_parent->getPosition() - m_parent->getOrigin());
@@ -631,6 +727,7 @@ void Entity::refreshFromLocalPosition()
 void Entity::refreshFromLocalRotation()
 {
     m_localChanges = true;
+    refreshBoundsChanges();
 
     if (m_parent != nullptr) {
         setRotation(m_parent->getRotation());
@@ -666,10 +763,36 @@ void Entity::refreshFromLocalScale()
 void Entity::refreshOrigin()
 {
     setOrigin(m_relativeOrigin * m_size);
-    refreshKeepInsideLocalRect();
+    if (refreshKeepInsideLocalRect()) onLocalPositionChanges();
     refreshFromLocalPosition();
 }
 
+void Entity::refreshBoundsChanges()
+{
+    refreshHitTests();
+
+    m_globalBoundsChanges = true;
+    m_cullingBoundsChanges = true;
+    m_pickingBoundsChanges = true;
+
+    // Culling bounds of sized ancestors do not depend on their children,
+    // and ancestors of an already changed one are changed too
+    bool culling = true;
+    for (auto parent = m_parent; parent != nullptr; parent = parent->m_parent) {
+        culling = culling && (parent->m_size.x <= 0.f || parent->m_size.y <= 0.f);
+        bool changed = !parent->m_pickingBoundsChanges || (culling && !parent->m_cullingBoundsChanges);
+        if (!changed) break;
+
+        parent->m_pickingBoundsChanges = true;
+        if (culling) parent->m_cullingBoundsChanges = true;
+    }
+}
+
+void Entity::refreshHitTests()
+{
+    Graph::invalidateHitTests();
+}
+
 void Entity::refreshDepthOrder()
 {
     if (m_parent != nullptr)
@@ -679,6 +802,7 @@ void Entity::refreshDepthOrder()
 void Entity::refreshChildrenOrder()
 {
     m_children.sort([](Entity* a, Entity* b) { return a->depth() > b->depth(); });
+    refreshHitTests();
 }
 
 void Entity::refreshChildrenRelativePosition()
@@ -689,6 +813,7 @@ void Entity::refreshChildrenRelativePosition()
 
 void Entity::refreshClipArea(const uint index)
 {
+    refreshHitTests();
     returnif (m_clipAreas[index].absolute);
     m_globalClipAreas[index] = getTransform().transformRect(m_clipAreas[index].area);
 }
@@ -748,7 +873,7 @@ void Entity::setKeepInsideLocalRect(const sf::FloatRect& localRect)
 {
     returnif (m_insideLocalRect == localRect);
     m_insideLocalRect = localRect;
-    refreshKeepInsideLocalRect();
+    if (refreshKeepInsideLocalRect()) onLocalPositionChanges();
     refreshFromLocalPosition();
 }
 
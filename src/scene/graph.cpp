@@ -12,12 +12,26 @@
 
 using namespace scene;
 
+//----------------------------//
+//----- Static variables -----//
+
+uint32 Graph::s_hitTestEpoch = 1u;
+
 Graph::Graph()
     : m_scene(this)
 {
     // NUI layer
     m_nuiLayer.init(this);
     m_nuiLayer.setManipulable(false);
+
+    // The mouse is now over this graph
+    invalidateHitTests();
+}
+
+Graph::~Graph()
+{
+    // The mouse is now over another graph
+    invalidateHitTests();
 }
 
 //-------------------//
@@ -434,12 +448,23 @@ void Graph::setHoveredEntity(Entity* hoveredEntity)
 
 Entity* Graph::entityFromPosition(const sf::Vector2i& mousePos, sf::Vector2f& viewPos)
 {
-    // Check whether a detectable entity is at that position in NUI layer
-    Entity* entity = m_nuiLayer.entityFromPosition(mousePos, viewPos);
-    returnif (entity != nullptr) entity;
+    // Nothing changed since the last hit test
+    if (m_hitTestEpoch == s_hitTestEpoch && m_hitTestMousePos == mousePos) {
+        viewPos = m_hitTestViewPos;
+        return m_hitTestEntity;
+    }
+
+    m_hitTestEpoch = s_hitTestEpoch;
+    m_hitTestMousePos = mousePos;
+
+    // Check whether a detectable entity is at that position in NUI layer,
+    // if not, check if there is one in scene layers
+    m_hitTestEntity = m_nuiLayer.entityFromPosition(mousePos, m_hitTestViewPos);
+    if (m_hitTestEntity == nullptr)
+        m_hitTestEntity = m_scene.entityFromPosition(mousePos, m_hitTestViewPos);
 
-    // If not, check if there is one in scene layers
-    return m_scene.entityFromPosition(mousePos, viewPos);
+    viewPos = m_hitTestViewPos;
+    return m_hitTestEntity;
 }
 
 const sf::View& Graph::viewFromLayerRoot(const Entity* root) const
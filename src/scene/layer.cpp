@@ -1,6 +1,7 @@
 #include "scene/layer.hpp"
 
 #include "context/context.hpp"
+#include "scene/graph.hpp"
 #include "tools/tools.hpp"
 #include "tools/vector.hpp"
 
@@ -45,7 +46,9 @@ void Layer::draw(sf::RenderTarget& target, sf::RenderStates states) const
     // Nothing? Direct drawing.
     if (m_posteffects.empty() && !m_lightsOn) {
         target.setView(m_view);
-        target.draw(m_root, states);
+        m_spriteBatch.begin(target);
+        m_root.drawCulled(target, states, tools::viewRect(m_view));
+        m_spriteBatch.end();
         return;
     }
 
@@ -53,7 +56,9 @@ void Layer::draw(sf::RenderTarget& target, sf::RenderStates states) const
     // No lights? Easy drawing.
     if (!m_lightsOn) {
         m_tmpTarget.clear(sf::Color::Transparent);
-        m_tmpTarget.draw(m_root, states);
+        m_spriteBatch.begin(m_tmpTarget);
+        m_root.drawCulled(m_tmpTarget, states, tools::viewRect(m_tmpTarget.getView()));
+        m_spriteBatch.end();
     }
     else {
         // Normals prologue
@@ -63,7 +68,9 @@ void Layer::draw(sf::RenderTarget& target, sf::RenderStates states) const
         // We keep an intermediate RenderTarget so that the lighting can affect only this layer
         m_tmpTarget.clear(sf::Color::Transparent);
         m_tmpTarget.setView(m_internView);
-        m_tmpTarget.draw(m_root, states);
+        m_spriteBatch.begin(m_tmpTarget);
+        m_root.drawCulled(m_tmpTarget, states, tools::viewRect(m_internView));
+        m_spriteBatch.end();
 
         // Normals epilogue
         m_lightSystem.normalsTargetDisplay();
@@ -108,6 +115,7 @@ void Layer::refreshWindow(const config::WindowInfo& cWindow)
 
     // Refresh the basic view, using the screenSize
     refreshBasicView();
+    Graph::invalidateHitTests();
 
     // Recursively update the whole layer.
     m_root.refreshWindow(cWindow);
@@ -172,12 +180,14 @@ void Layer::setViewport(const sf::FloatRect& viewport)
     m_ownViewport = true;
     m_view.setViewport(viewport);
     refreshBasicView();
+    Graph::invalidateHitTests();
 }
 
 void Layer::setRelativeCenter(const sf::Vector2f& relativeCenter)
 {
     m_view.setCenter(m_view.getSize() / 2.f + relativeCenter * (m_size - m_view.getSize()));
     m_internView.setCenter(m_view.getCenter());
+    Graph::invalidateHitTests();
 
     if (m_onViewChangesCallback != nullptr)
         m_onViewChangesCallback();
@@ -187,6 +197,7 @@ void Layer::setViewSize(const sf::Vector2f& viewSize)
 {
     m_view.setSize(viewSize);
     m_internView.setSize(m_view.getSize());
+    Graph::invalidateHitTests();
 
     if (m_onViewChangesCallback != nullptr)
         m_onViewChangesCallback();
@@ -196,7 +207,7 @@ Entity* Layer::entityFromPosition(const sf::Vector2i& mousePos, sf::Vector2f& vi
 {
     const auto& window = context::context.window;
     viewPos = window.mapPixelToCoords(mousePos, m_view);
-    return m_root.firstOver(viewPos);
+    return m_root.firstOver(viewPos, m_pickingIndexed);
 }
 
 void Layer::refreshManipulability()
@@ -207,6 +218,7 @@ void Layer::refreshManipulability()
 
         m_internView.setSize(m_view.getSize());
         m_internView.setCenter(m_view.getCenter());
+        Graph::invalidateHitTests();
     }
 }
 
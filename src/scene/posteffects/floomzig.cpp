@@ -1,7 +1,9 @@
 #include "scene/posteffects/floomzig.hpp"
 
 #include "context/context.hpp"
+#include "tools/random.hpp"
 #include "tools/vector.hpp"
+#include "tools/math.hpp"
 #include "tools/tools.hpp"
 
 #include <SFML/Graphics/Sprite.hpp>
@@ -51,8 +53,9 @@ void Floomzig::sobel(sf::RenderTarget& out, const sf::RenderTexture& in)
     m_sobelShader->setParameter("sourceSize", sf::v2f(in.getSize()));
 
     sf::Vector2f floomOffset;
-    floomOffset.x = static_cast<float>(15.f * std::sin(rand()));
-    floomOffset.y = static_cast<float>(15.f * std::cos(rand()));
+    auto angle = alea::rand(0.f, 2.f * static_cast<float>(M_PI), alea::Stream::VISUAL);
+    floomOffset.x = 15.f * std::sin(angle);
+    floomOffset.y = 15.f * std::cos(angle);
     m_sobelShader->setParameter("floomOffset", floomOffset);
 
     shaderize(out, *m_sobelShader);
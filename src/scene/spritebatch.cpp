@@ -0,0 +1,113 @@
+#include "scene/spritebatch.hpp"
+
+#include "tools/debug.hpp"
+#include "tools/tools.hpp"
+
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <cmath>
+
+using namespace scene;
+
+//----------------------------//
+//----- Static variables -----//
+
+SpriteBatch* SpriteBatch::s_active = nullptr;
+
+//-------------------//
+//----- Routine -----//
+
+void SpriteBatch::begin(sf::RenderTarget& target)
+{
+    massert(m_target == nullptr, "Sprite batch already begun.");
+
+    m_target = &target;
+    m_previous = s_active;
+    s_active = this;
+}
+
+void SpriteBatch::end()
+{
+    massert(s_active == this, "Sprite batches should end in the reverse order they began.");
+
+    flush();
+    s_active = m_previous;
+    m_previous = nullptr;
+    m_target = nullptr;
+}
+
+void SpriteBatch::draw(const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+    // Like SFML, a sprite without texture is not drawn
+    returnif (sprite.getTexture() == nullptr);
+
+    draw(*sprite.getTexture(), sprite.getTextureRect(), sprite.getColor(), sprite.getTransform(), states);
+}
+
+void SpriteBatch::draw(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Color& color,
+                       const sf::Transform& transform, const sf::RenderStates& states)
+{
+    // Different render states, the pending quads are drawn first
+    if (!m_vertices.empty() && (m_states.texture != &texture || m_states.shader != states.shader || m_states.blendMode != states.blendMode))
+        flush();
+
+    m_states.texture = &texture;
+    m_states.shader = states.shader;
+    m_states.blendMode = states.blendMode;
+
+    // Corners, as sf::Sprite, flipped if the texture rect has negative dimensions
+    const auto width = static_cast<float>(std::abs(textureRect.width));
+    const auto height = static_cast<float>(std::abs(textureRect.height));
+    const auto left = static_cast<float>(textureRect.left);
+    const auto top = static_cast<float>(textureRect.top);
+    const auto right = left + textureRect.width;
+    const auto bottom = top + textureRect.height;
+
+    const auto combinedTransform = states.transform * transform;
+    const sf::Vertex topLeft(combinedTransform.transformPoint(0.f, 0.f), color, {left, top});
+    const sf::Vertex topRight(combinedTransform.transformPoint(width, 0.f), color, {right, top});
+    const sf::Vertex bottomLeft(combinedTransform.transformPoint(0.f, height), color, {left, bottom});
+    const sf::Vertex bottomRight(combinedTransform.transformPoint(width, height), color, {right, bottom});
+
+    // Two triangles
+    m_vertices.emplace_back(topLeft);
+    m_vertices.emplace_back(topRight);
+    m_vertices.emplace_back(bottomLeft);
+    m_vertices.emplace_back(bottomLeft);
+    m_vertices.emplace_back(topRight);
+    m_vertices.emplace_back(bottomRight);
+
+    ++m_quadsCount;
+}
+
+void SpriteBatch::flush()
+{
+    returnif (m_vertices.empty());
+
+    // The vertices are already transformed
+    if (m_submit != nullptr)
+        m_submit(m_vertices.data(), m_vertices.size(), m_states);
+    else if (m_target != nullptr)
+        m_target->draw(m_vertices.data(), m_vertices.size(), sf::Triangles, m_states);
+
+    // Keeping the capacity for next quads
+    m_vertices.clear();
+    ++m_flushesCount;
+}
+
+SpriteBatch* SpriteBatch::active(const sf::RenderTarget& target)
+{
+    for (auto batch = s_active; batch != nullptr; batch = batch->m_previous)
+        if (batch->m_target == &target)
+            return batch;
+
+    return nullptr;
+}
+
+void SpriteBatch::flushActive(const sf::RenderTarget& target)
+{
+    auto batch = active(target);
+    if (batch != nullptr)
+        batch->flush();
+}
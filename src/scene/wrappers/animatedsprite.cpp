@@ -48,10 +48,17 @@ void AnimatedSprite::updateRoutine(const sf::Time& dt)
     // Update hitbox
     if (m_hasHitbox) {
         auto hitbox = m_spriterEntity->getObjectInstance("hitbox");
-        m_hitbox.width  = hitbox->getSize().x * hitbox->getScale().x;
-        m_hitbox.height = hitbox->getSize().y * hitbox->getScale().y;
-        m_hitbox.left   = hitbox->getPosition().x;
-        m_hitbox.top    = hitbox->getPosition().y;
+        sf::FloatRect newHitbox;
+        newHitbox.width  = hitbox->getSize().x * hitbox->getScale().x;
+        newHitbox.height = hitbox->getSize().y * hitbox->getScale().y;
+        newHitbox.left   = hitbox->getPosition().x;
+        newHitbox.top    = hitbox->getPosition().y;
+
+        // The hitbox is what the mouse hits
+        if (newHitbox != m_hitbox) {
+            m_hitbox = newHitbox;
+            refreshHitTests();
+        }
     }
 }
 
@@ -159,4 +166,6 @@ void AnimatedSprite::refreshHitbox()
         m_hitbox.left   = 0.f;
         m_hitbox.top    = 0.f;
     }
+
+    refreshHitTests();
 }
@@ -33,7 +33,9 @@ void LightSprite::onScaleChanges()
 
 void LightSprite::setTexture(const std::string& textureID)
 {
-    m_shape.setTexture(&context::context.textures.get(textureID));
+    auto region = context::context.textures.region(textureID);
+    m_shape.setTexture(region.texture);
+    m_shape.setTextureRect(region.rect);
 
     auto normalsTextureID = textureID + "_NORMALS";
     if (context::context.textures.stored(normalsTextureID)) {
@@ -29,5 +29,7 @@ void RectangleShape::onScaleChanges()
 
 void RectangleShape::setTexture(const std::string& textureID)
 {
-    m_rectangleShape.setTexture(&context::context.textures.get(textureID));
+    auto region = context::context.textures.region(textureID);
+    m_rectangleShape.setTexture(region.texture);
+    m_rectangleShape.setTextureRect(region.rect);
 }
@@ -25,7 +25,8 @@ void Sprite::onScaleChanges()
 
 void Sprite::setTexture(const std::string& textureID)
 {
-    const auto& texture = context::context.textures.get(textureID);
-    m_sprite.setTexture(texture);
-    setSize(sf::v2f(texture.getSize()));
+    auto region = context::context.textures.region(textureID);
+    m_sprite.setTexture(*region.texture);
+    m_sprite.setTextureRect(region.rect);
+    setSize({static_cast<float>(region.rect.width), static_cast<float>(region.rect.height)});
 }
@@ -1,5 +1,7 @@
 #include "spriter/sfmlboxinstanceinfo.hpp"
 
+#include "scene/spritebatch.hpp"
+
 #include <Spriter/global/settings.h>
 
 using namespace SpriterEngine;
@@ -18,6 +20,7 @@ void SfmlBoxInstanceInfo::render(sf::RenderTarget& target, sf::RenderStates& sta
         rectangle.setRotation(toDegrees(getAngle()));
         rectangle.setScale(getScale().x, getScale().y);
         rectangle.setOrigin(getPivot().x*getSize().x, getPivot().y*getSize().y);
+        scene::SpriteBatch::flushActive(target);
         target.draw(rectangle, states);
     }
 }
@@ -1,6 +1,7 @@
 #include "spriter/sfmlimagefile.hpp"
 
 #include "context/context.hpp"
+#include "scene/spritebatch.hpp"
 
 #include <Spriter/objectinfo/universalobjectinterface.h>
 
@@ -12,9 +13,10 @@ SfmlImageFile::SfmlImageFile(std::string filePath, point defaultPivot)
     : baseClass(filePath, defaultPivot)
 {
     auto fileID = context::context.textures.getID(path());
-    auto& texture = context::context.textures.get(fileID);
-    sprite.setTexture(texture);
-    m_textureSize = texture.getSize();
+    auto region = context::context.textures.region(fileID);
+    sprite.setTexture(*region.texture);
+    sprite.setTextureRect(region.rect);
+    m_textureSize = sf::Vector2u(region.rect.width, region.rect.height);
 }
 
 //-------------------//
@@ -31,5 +33,8 @@ void SfmlImageFile::renderSprite(UniversalObjectInterface *spriteInfo, sf::Rende
     sprite.setScale(spriteInfo->getScale().x, spriteInfo->getScale().y);
     sprite.setOrigin(spriteInfo->getPivot().x * m_textureSize.x, spriteInfo->getPivot().y * m_textureSize.y);
 
-    target.draw(sprite, states);
+    // Batched with the other bones if possible
+    auto batch = scene::SpriteBatch::active(target);
+    if (batch != nullptr) batch->draw(sprite, states);
+    else target.draw(sprite, states);
 }
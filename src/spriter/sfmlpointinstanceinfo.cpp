@@ -1,5 +1,7 @@
 #include "spriter/sfmlpointinstanceinfo.hpp"
 
+#include "scene/spritebatch.hpp"
+
 #include <Spriter/global/settings.h>
 
 using namespace SpriterEngine;
@@ -17,6 +19,7 @@ void SfmlPointInstanceInfo::render(sf::RenderTarget& target, sf::RenderStates& s
     {
         circle.setPosition(getPosition().x, getPosition().y);
         circle.setRotation(toDegrees(getAngle()));
+        scene::SpriteBatch::flushActive(target);
         target.draw(circle, states);
     }
 }
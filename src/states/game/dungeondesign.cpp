@@ -102,6 +102,14 @@ bool GameDungeonDesign::update(const sf::Time& dt)
     // Loading is over, we're just updating the whole thing
     auto dtFactored = timeFactor() * dt;
     m_dungeonData.update(dtFactored);
+
+    // Autosave, written in background
+    m_autosaveTime += dt.asSeconds();
+    if (m_autosaveTime >= m_autosaveDelay) {
+        m_autosaveTime = 0.f;
+        m_dungeonData.saveAsync(context::worlds.selected().folder);
+    }
+
     return baseClass::update(dt);
 }
 
@@ -276,11 +284,11 @@ void GameDungeonDesign::updateLoading(const sf::Time& dt)
     LOAD( 4u, Application::loadTextures({"core/dungeon/inter"}))
     LOAD( 5u, Application::loadTextures({"core/dungeon/scene"}))
     LOAD( 6u, Application::loadTextures({"core/dungeon/sidebar"}))
-    LOAD( 7u, Application::loadTextures({"vanilla/dynamics"}))
-    LOAD( 8u, Application::loadTextures({"vanilla/facilities"}))
-    LOAD( 9u, Application::loadTextures({"vanilla/monsters"}))
-    LOAD(10u, Application::loadTextures({"vanilla/traps"}))
-    LOAD(11u, Application::loadTextures({"vanilla/heroes"}))
+    LOAD( 7u, Application::loadTextures({"vanilla/dynamics"}, true))
+    LOAD( 8u, Application::loadTextures({"vanilla/facilities"}, true))
+    LOAD( 9u, Application::loadTextures({"vanilla/monsters"}, true))
+    LOAD(10u, Application::loadTextures({"vanilla/traps"}, true))
+    LOAD(11u, Application::loadTextures({"vanilla/heroes"}, true))
 
     LOAD(15u, Application::loadSounds({"vanilla"}))
 
@@ -5,4 +5,15 @@ using namespace alea;
 //----------------------------//
 //----- Static variables -----//
 
-std::mt19937 alea::s_generator;
+std::array<std::mt19937, static_cast<uint>(Stream::COUNT)> alea::s_generators;
+
+//-------------------//
+//----- Seeding -----//
+
+void alea::seed(uint32 value)
+{
+    for (uint i = 0u; i < s_generators.size(); ++i) {
+        std::seed_seq sequence{value, static_cast<uint32>(i)};
+        s_generators[i].seed(sequence);
+    }
+}
@@ -0,0 +1,31 @@
+// Benchmark of resources::AtlasPacker.
+// Packs as many sprites as the game textures folders, for several page sizes,
+// reporting the time spent, the pages used and how much of them is covered.
+
+#include "resources/atlaspacker.hpp"
+#include "tools/random.hpp"
+
+#include <iostream>
+#include <chrono>
+
+int main(void)
+{
+    alea::seed(42u);
+
+    std::vector<sf::Vector2u> sizes;
+    for (uint i = 0u; i < 5000u; ++i)
+        sizes.emplace_back(alea::rand(8u, 256u), alea::rand(8u, 256u));
+
+    for (auto pageSide : {1024u, 2048u, 4096u}) {
+        resources::AtlasPacker packer({pageSide, pageSide}, 2u);
+
+        auto start = std::chrono::steady_clock::now();
+        packer.pack(sizes);
+        auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Pages of " << pageSide << ": " << sizes.size() << " sprites in " << duration << " ms, "
+                  << packer.pagesCount() << " pages, occupancy " << packer.occupancy() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+// Benchmark of the frame time spike when saving the dungeon.
+// Compares the blocking save with the background one, on a synthetic 100x100 dungeon.
+
+#include "dungeon/data.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <chrono>
+
+//! Keeps the per-frame work from being optimized out.
+volatile uint s_sink = 0u;
+
+//! Simulate frames, saving on some of them, and print frame times.
+void bench(const std::string& label, dungeon::Data& data, const std::function<void()>& save)
+{
+    const uint framesCount = 300u;
+    std::vector<double> frameTimes;
+
+    for (uint frame = 0u; frame < framesCount; ++frame) {
+        auto start = std::chrono::steady_clock::now();
+
+        // Some light per-frame work over the dungeon state
+        uint facilitiesCount = 0u;
+        for (uint floor = 0u; floor < data.floorsCount(); ++floor)
+        for (uint room = 0u; room < data.floorRoomsCount(); ++room)
+            facilitiesCount += data.room({static_cast<uint8>(floor), static_cast<uint8>(room)}).facilities.size();
+
+        if (frame % 100u == 50u)
+            save();
+
+        s_sink = facilitiesCount;
+        frameTimes.emplace_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Make sure everything is written before going on
+    auto start = std::chrono::steady_clock::now();
+    data.waitSaves();
+    auto flush = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(std::begin(frameTimes), std::end(frameTimes));
+    std::cout << label << ": median frame " << frameTimes[framesCount / 2u] << "ms, worst frame " << frameTimes.back()
+              << "ms (waited " << flush << "ms for the worker at the end)" << std::endl;
+}
+
+int main(void)
+{
+    dungeon::Data data;
+    data.load(L"big_bobby/");
+
+    // The richest room content, repeated over a 100x100 dungeon
+    dungeon::Room modelRoom;
+    for (uint floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint room = 0u; room < data.floorRoomsCount(); ++room)
+        if (data.room({static_cast<uint8>(floor), static_cast<uint8>(room)}).facilities.size() > modelRoom.facilities.size())
+            modelRoom = data.room({static_cast<uint8>(floor), static_cast<uint8>(room)});
+
+    data.setFloorsCount(100u);
+    data.setFloorRoomsCount(100u);
+    for (uint floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint room = 0u; room < data.floorRoomsCount(); ++room) {
+        dungeon::RoomCoords coords = {static_cast<uint8>(floor), static_cast<uint8>(room)};
+        auto& dungeonRoom = data.room(coords);
+        dungeonRoom.state = dungeon::RoomState::CONSTRUCTED;
+        dungeonRoom.trap = modelRoom.trap;
+        dungeonRoom.facilities = modelRoom.facilities;
+        for (auto& facility : dungeonRoom.facilities)
+            facility.coords = coords;
+    }
+
+    for (bool binary : {false, true}) {
+        data.setBinarySaves(binary);
+        std::string format = binary? " (binary)" : " (XML)   ";
+        bench("Blocking save  " + format, data, [&] { data.save(L"big_bobby/bench-autosave-"); });
+        bench("Background save" + format, data, [&] { data.saveAsync(L"big_bobby/bench-autosave-"); });
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+// Benchmark of dungeon::Detector range queries and UID lookups.
+// Compares the spatial index against the full scan of all entities.
+
+#include "dungeon/detector.hpp"
+#include "dungeon/detectentity.hpp"
+#include "tools/random.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <memory>
+
+//! A detect entity placed in a virtual dungeon.
+class BenchEntity final : public dungeon::DetectEntity
+{
+public:
+
+    std::string _name() const final { return "BenchEntity"; }
+    std::string detectKey() const final { return m_key; }
+
+    std::vector<uint32> query(const float range) const
+    {
+        std::vector<uint32> UIDs;
+        inRangeUIDs("hero", range, UIDs);
+        return UIDs;
+    }
+
+    std::string m_key;
+};
+
+int main(void)
+{
+    // A 10x10 dungeon, rooms being 100 wide
+    const float roomSize = 100.f;
+    const float dungeonSize = 10.f * roomSize;
+    const uint queriesCount = 2000u;
+
+    alea::seed(42u);
+    dungeon::s_detector.setCellSize(roomSize);
+
+    for (uint entitiesCount : {1000u, 5000u, 20000u}) {
+        std::vector<std::unique_ptr<BenchEntity>> entities;
+        for (uint i = 0u; i < entitiesCount; ++i) {
+            entities.emplace_back(std::make_unique<BenchEntity>());
+            entities.back()->m_key = (i % 3u == 0u)? "monster" : "hero";
+            entities.back()->setLocalPosition({alea::rand(0.f, dungeonSize), alea::rand(0.f, dungeonSize)});
+        }
+
+        for (bool indexed : {false, true}) {
+            dungeon::s_detector.setIndexed(indexed);
+
+            uint64 found = 0u;
+            auto start = std::chrono::steady_clock::now();
+            for (uint q = 0u; q < queriesCount; ++q)
+                found += entities[q % entitiesCount]->query(0.5f * roomSize).size();
+            auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << entitiesCount << " entities, " << (indexed? "spatial index" : "full scan    ") << ": "
+                      << static_cast<uint64>(queriesCount / duration) << " queries/s (" << found << " detections)" << std::endl;
+        }
+
+        // Results should be exactly the same
+        for (uint q = 0u; q < queriesCount; ++q) {
+            const auto& entity = *entities[q % entitiesCount];
+            dungeon::s_detector.setIndexed(false);
+            auto expected = entity.query(0.5f * roomSize);
+            dungeon::s_detector.setIndexed(true);
+            if (entity.query(0.5f * roomSize) != expected) {
+                std::cerr << "Spatial index results differ from full scan for entity " << entity.UID() << "." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // UID lookups
+        uint64 foundCount = 0u;
+        auto start = std::chrono::steady_clock::now();
+        for (uint q = 0u; q < 100u * queriesCount; ++q)
+            foundCount += (dungeon::s_detector.find(entities[q % entitiesCount]->UID()) != nullptr)? 1u : 0u;
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << entitiesCount << " entities, UID lookups: " << static_cast<uint64>(foundCount / duration) << " finds/s" << std::endl;
+
+        // Stale UIDs should not be found, even once their slot is reused
+        auto staleUID = entities.front()->UID();
+        entities.erase(std::begin(entities));
+        entities.emplace_back(std::make_unique<BenchEntity>());
+        if (dungeon::s_detector.find(staleUID) != nullptr) {
+            std::cerr << "Stale UID " << staleUID << " is still resolved to an entity." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+// Benchmark of dungeon::Data save and load.
+// Compares the XML format with the binary one, in time and file size,
+// on a real save and on a synthetic 100x100 dungeon.
+
+#include "dungeon/data.hpp"
+#include "tools/string.hpp"
+
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+
+//! Time spent in the function, averaged over a few runs.
+double measure(const std::function<void()>& function)
+{
+    const uint runs = 5u;
+    auto start = std::chrono::steady_clock::now();
+    for (uint i = 0u; i < runs; ++i)
+        function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+//! Size of the file, in bytes.
+uint64 fileSize(const std::wstring& filename)
+{
+    std::ifstream stream(toString(filename), std::ios::binary | std::ios::ate);
+    return stream.tellg();
+}
+
+void bench(const std::string& label, dungeon::Data& data, const std::wstring& folder)
+{
+    std::wstring xmlFilename, binaryFilename;
+
+    data.setBinarySaves(false);
+    auto xmlSave = measure([&] { xmlFilename = data.save(folder + L"bench-xml-"); });
+    auto xmlLoad = measure([&] { data.load(folder + L"bench-xml-"); });
+
+    data.setBinarySaves(true);
+    auto binarySave = measure([&] { binaryFilename = data.save(folder + L"bench-binary-"); });
+    auto binaryLoad = measure([&] { data.load(folder + L"bench-binary-"); });
+
+    std::cout << label << std::endl;
+    std::cout << "    XML:    save " << xmlSave << "ms, load " << xmlLoad << "ms, " << fileSize(xmlFilename) << " bytes" << std::endl;
+    std::cout << "    Binary: save " << binarySave << "ms, load " << binaryLoad << "ms, " << fileSize(binaryFilename) << " bytes" << std::endl;
+}
+
+int main(void)
+{
+    dungeon::Data data;
+
+    // A real save
+    data.load(L"big_bobby/");
+    bench("big_bobby", data, L"big_bobby/");
+
+    // The same rooms content, repeated over a 100x100 dungeon
+    dungeon::Room modelRoom;
+    for (uint floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint room = 0u; room < data.floorRoomsCount(); ++room)
+        if (data.room({static_cast<uint8>(floor), static_cast<uint8>(room)}).facilities.size() > modelRoom.facilities.size())
+            modelRoom = data.room({static_cast<uint8>(floor), static_cast<uint8>(room)});
+
+    data.setFloorsCount(100u);
+    data.setFloorRoomsCount(100u);
+    for (uint floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint room = 0u; room < data.floorRoomsCount(); ++room) {
+        dungeon::RoomCoords coords = {static_cast<uint8>(floor), static_cast<uint8>(room)};
+        auto& dungeonRoom = data.room(coords);
+        dungeonRoom.state = dungeon::RoomState::CONSTRUCTED;
+        dungeonRoom.trap = modelRoom.trap;
+        dungeonRoom.facilities = modelRoom.facilities;
+        for (auto& facility : dungeonRoom.facilities)
+            facility.coords = coords;
+    }
+
+    bench("synthetic 100x100", data, L"big_bobby/");
+
+    return EXIT_SUCCESS;
+}
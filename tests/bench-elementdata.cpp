@@ -0,0 +1,63 @@
+// Benchmark of dungeon::ElementData attributes get/set.
+// Compares the previous layout (hash map by wide string) with the flat storage,
+// accessed by name and by pre-resolved handle.
+
+#include "dungeon/elements/elementdata.hpp"
+
+#include <pugixml/pugixml.hpp>
+
+#include <unordered_map>
+#include <functional>
+#include <iostream>
+#include <chrono>
+
+int main(void)
+{
+    const uint iterations = 1000000u;
+    const std::vector<std::wstring> names = {L"rx", L"ry", L"tx", L"ty", L"dosh", L"hp", L"fame", L"soul"};
+
+    // Previous layout
+    std::unordered_map<std::wstring, MetaData> map;
+    for (const auto& name : names)
+        map[name].init_float(0.f);
+
+    // New layout
+    dungeon::ElementData data;
+    data.create(L"bench");
+    std::vector<dungeon::AttributeID> ids;
+    for (const auto& name : names) {
+        ids.emplace_back(dungeon::ElementData::attributeID(name));
+        data[ids.back()].init_float(0.f);
+    }
+
+    // Same kind of work as MovingElement::updateRoutine
+    auto bench = [&] (const std::string& label, const std::function<float(uint)>& access) {
+        float sum = 0.f;
+        auto start = std::chrono::steady_clock::now();
+        for (uint i = 0u; i < iterations; ++i)
+            sum += access(i % names.size());
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << label << ": " << static_cast<uint64>(iterations / duration) << " get+set/s (" << sum << ")" << std::endl;
+    };
+
+    bench("Hash map by name  ", [&] (uint i) { map[names[i]].as_float() += 1.f; return map[names[i]].as_float(); });
+    bench("Flat data by name ", [&] (uint i) { data[names[i]].as_float() += 1.f; return data[names[i]].as_float(); });
+    bench("Flat data by ID   ", [&] (uint i) { data[ids[i]].as_float() += 1.f; return data[ids[i]].as_float(); });
+
+    // XML round trip should be lossless
+    data[L"flag"].init_bool(true);
+    data[L"count"].init_uint32(42u);
+    pugi::xml_document doc;
+    auto node = doc.append_child(L"data");
+    data.saveXML(node);
+
+    dungeon::ElementData loaded;
+    loaded.loadXML(node);
+    if (loaded.type() != L"bench" || !loaded.at(L"flag").as_bool() || loaded.at(L"count").as_uint32() != 42u
+        || loaded.at(dungeon::attributes::rx).as_float() != data.at(dungeon::attributes::rx).as_float()) {
+        std::cerr << "XML round trip differs from original data." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
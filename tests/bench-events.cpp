@@ -0,0 +1,152 @@
+// Benchmark of context::EventEmitter.
+// Compares the previous design (string types, heap-allocated events,
+// every receiver visited) with interned types dispatched by value
+// to the receivers subscribed to them.
+
+#include "context/event.hpp"
+#include "tools/platform-fixes.hpp" // make_unique
+
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <deque>
+
+//! Time spent in the function.
+template<class Function>
+double measure(const Function& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//----------------------//
+//----- Old design -----//
+
+struct LegacyEvent
+{
+    virtual ~LegacyEvent() = default;
+    std::string type;
+    int delta;
+};
+
+struct LegacyReceiver
+{
+    std::string interest;
+    uint received = 0u;
+
+    void receive(const LegacyEvent& event)
+    {
+        if (event.type == interest)
+            received += 1u;
+    }
+};
+
+struct LegacyEmitter
+{
+    std::vector<LegacyReceiver*> receivers;
+    std::deque<std::unique_ptr<LegacyEvent>> events;
+
+    void addEvent(std::string type)
+    {
+        auto event = std::make_unique<LegacyEvent>();
+        event->type = std::move(type);
+        events.emplace_back(std::move(event));
+    }
+
+    void broadcast()
+    {
+        for (const auto& event : events)
+            for (auto receiver : receivers)
+                receiver->receive(*event);
+        events.clear();
+    }
+};
+
+//----------------------//
+//----- New design -----//
+
+struct BenchEvent : public context::Event
+{
+    int delta;
+};
+
+class BenchEmitter final : public context::EventEmitter
+{
+public:
+    using context::EventEmitter::broadcast;
+};
+
+class BenchReceiver final : public context::EventReceiver
+{
+public:
+    uint received = 0u;
+
+protected:
+    void receive(const context::Event&) final { received += 1u; }
+};
+
+//----------------//
+//----- Main -----//
+
+int main(void)
+{
+    const uint typesCount = 20u;
+    const uint receiversCount = 200u;
+    const uint framesCount = 1000u;
+    const uint eventsPerFrame = 50u;
+
+    std::vector<std::string> names;
+    std::vector<context::EventID> ids;
+    for (uint i = 0u; i < typesCount; ++i) {
+        names.emplace_back("bench_event_" + std::to_string(i));
+        ids.emplace_back(context::eventID(names.back()));
+    }
+
+    // Each receiver is interested in one type only, as in the game
+    LegacyEmitter legacyEmitter;
+    std::vector<LegacyReceiver> legacyReceivers(receiversCount);
+    for (uint i = 0u; i < receiversCount; ++i) {
+        legacyReceivers[i].interest = names[i % typesCount];
+        legacyEmitter.receivers.emplace_back(&legacyReceivers[i]);
+    }
+
+    BenchEmitter emitter;
+    std::vector<std::unique_ptr<BenchReceiver>> receivers;
+    for (uint i = 0u; i < receiversCount; ++i) {
+        receivers.emplace_back(std::make_unique<BenchReceiver>());
+        receivers.back()->setEmitter(&emitter, {ids[i % typesCount]});
+    }
+
+    auto legacyTime = measure([&] {
+        for (uint frame = 0u; frame < framesCount; ++frame) {
+            for (uint i = 0u; i < eventsPerFrame; ++i)
+                legacyEmitter.addEvent(names[(frame + i) % typesCount]);
+            legacyEmitter.broadcast();
+        }
+    });
+
+    auto time = measure([&] {
+        for (uint frame = 0u; frame < framesCount; ++frame) {
+            for (uint i = 0u; i < eventsPerFrame; ++i) {
+                BenchEvent event;
+                event.type = ids[(frame + i) % typesCount];
+                event.delta = i;
+                emitter.addEvent(event);
+            }
+            emitter.broadcast();
+        }
+    });
+
+    uint legacyReceived = 0u, received = 0u;
+    for (const auto& receiver : legacyReceivers) legacyReceived += receiver.received;
+    for (const auto& receiver : receivers) received += receiver->received;
+
+    const uint eventsCount = framesCount * eventsPerFrame;
+    std::cout << eventsCount << " events, " << receiversCount << " receivers over " << typesCount << " types" << std::endl;
+    std::cout << "    Strings, heap, all receivers: " << legacyTime << "ms (" << legacyReceived << " received)" << std::endl;
+    std::cout << "    Interned, by value, per type: " << time << "ms (" << received << " received)" << std::endl;
+    std::cout << "    Throughput: " << eventsCount / legacyTime << " vs " << eventsCount / time << " events/ms" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// Benchmark of the graph evaluation of moving elements.
+// Compares the per-node callbacks, eev_weight getters reading a table refreshed on each call,
+// to the batched _evaluateAll call.
+
+#include "scene/components/ai.hpp"
+#include "scene/entity.hpp"
+#include "tools/int.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+//! The weight of a node, as moving elements pass it to Lua.
+struct Weight
+{
+    uint visited = 0u;
+    uint lastVisit = 0u;
+    uint altitude = 0u;
+    uint treasure = 0u;
+    bool exit = false;
+};
+
+//! An entity running a script.
+class BenchEntity final : public scene::Entity
+{
+public:
+
+    BenchEntity() : m_ai(*this) {}
+
+    std::string _name() const final { return "BenchEntity"; }
+
+    scene::AI m_ai;
+};
+
+//! Fill the fields of the table on top of the stack with the weight.
+void pushWeight(lua_State* L, const Weight& weight)
+{
+    lua_pushinteger(L, weight.visited);
+    lua_setfield(L, -2, "visited");
+    lua_pushinteger(L, weight.lastVisit);
+    lua_setfield(L, -2, "lastVisit");
+    lua_pushinteger(L, weight.altitude);
+    lua_setfield(L, -2, "altitude");
+    lua_pushinteger(L, weight.treasure);
+    lua_setfield(L, -2, "treasure");
+    lua_pushboolean(L, weight.exit);
+    lua_setfield(L, -2, "exit");
+}
+
+//! An eev_weight getter, returning the field (second upvalue) of the values table (first upvalue).
+int weightGetter(lua_State* L)
+{
+    lua_pushvalue(L, lua_upvalueindex(2));
+    lua_rawget(L, lua_upvalueindex(1));
+    return 1;
+}
+
+//! Push the table read by the eev_weight getters, creating them the first time.
+void pushWeightValues(lua_State* L)
+{
+    lua_getglobal(L, "eev_weight");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "altitude");
+        lua_getupvalue(L, -1, 1);
+        lua_replace(L, -3);
+        lua_pop(L, 1);
+        return;
+    }
+    lua_pop(L, 1);
+
+    lua_createtable(L, 0, 5);
+    lua_createtable(L, 0, 5);
+    for (auto field : {"visited", "lastVisit", "altitude", "treasure", "exit"}) {
+        lua_pushvalue(L, -2);
+        lua_pushstring(L, field);
+        lua_pushcclosure(L, weightGetter, 2);
+        lua_setfield(L, -2, field);
+    }
+    lua_setglobal(L, "eev_weight");
+}
+
+//! One evaluation with the per-node callbacks.
+int evaluatePerNode(BenchEntity& entity, const std::vector<Weight>& weights)
+{
+    int sum = 0;
+    for (uint i = 0u; i < weights.size(); ++i) {
+        auto scope = entity.m_ai.lua();
+        auto L = scope.raw();
+
+        pushWeightValues(L);
+        pushWeight(L, weights[i]);
+        lua_pop(L, 1);
+
+        sum += static_cast<int>(scope[(i == 0u)? "_evaluateReference" : "_evaluate"]());
+    }
+    return sum;
+}
+
+//! One evaluation with a batched call.
+int evaluateBatched(BenchEntity& entity, const std::vector<Weight>& weights)
+{
+    auto scope = entity.m_ai.lua();
+    auto L = scope.raw();
+
+    lua_getglobal(L, "_evaluateAll");
+    lua_getglobal(L, "eev_weights");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "eev_weights");
+    }
+
+    for (uint i = 0u; i < weights.size(); ++i) {
+        lua_rawgeti(L, -1, i + 1u);
+        if (!lua_istable(L, -1)) {
+            lua_pop(L, 1);
+            lua_createtable(L, 0, 5);
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, -3, i + 1u);
+        }
+
+        pushWeight(L, weights[i]);
+        lua_pop(L, 1);
+    }
+
+    lua_pushinteger(L, weights.size());
+    if (lua_pcall(L, 2, 1, 0) != LUA_OK) {
+        std::cerr << "/!\\ LUA " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return 0;
+    }
+
+    int sum = 0;
+    for (uint i = 0u; i < weights.size(); ++i) {
+        lua_rawgeti(L, -1, i + 1u);
+        sum += static_cast<int>(lua_tonumber(L, -1));
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+
+    return sum;
+}
+
+int main(void)
+{
+    const uint evaluationsCount = 20000u;
+    auto noAPI = [] (scene::LuaVM&) {};
+    auto attributeAPI = [] (scene::LuaVM& vm) {
+        vm.state()["eev_attribute"] = std::function<uint32(const std::string&)>([] (const std::string&) { return 0u; });
+    };
+
+    // The current node and 4 neighbours
+    std::vector<Weight> weights(5u);
+    for (uint i = 0u; i < weights.size(); ++i) {
+        weights[i].visited = i % 3u;
+        weights[i].lastVisit = 2u * i;
+        weights[i].altitude = i;
+    }
+
+    BenchEntity legacy, batched;
+    if (!legacy.m_ai.load("res/vanilla/monsters/creepim/ai.lua", attributeAPI)
+        || !batched.m_ai.load("res/vanilla/heroes/groo/ai.lua", noAPI)) {
+        std::cerr << "Cannot load scripts." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto measure = [&] (const char* label, const std::function<int()>& evaluate) {
+        int sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint i = 0u; i < evaluationsCount; ++i)
+            sum += evaluate();
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << label << ": " << 1e6 * duration / evaluationsCount << " us/evaluation"
+                  << " (checksum " << sum << ")" << std::endl;
+    };
+
+    measure("Per node", [&] { return evaluatePerNode(legacy, weights); });
+    measure("Batched ", [&] { return evaluateBatched(batched, weights); });
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+// Benchmark of scene::AI with shared and private Lua VMs.
+// Reports the memory used and the time to spawn an element, then the cost of a lua call.
+// Also compares spawn times with and without the bytecode cache.
+
+#include "scene/components/ai.hpp"
+#include "scene/components/luacache.hpp"
+#include "scene/entity.hpp"
+#include "tools/int.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+//! An entity running a script.
+class BenchEntity final : public scene::Entity
+{
+public:
+
+    BenchEntity() : m_ai(*this) {}
+
+    std::string _name() const final { return "BenchEntity"; }
+
+    scene::AI m_ai;
+    uint32 m_dosh = 0u;
+};
+
+int main(void)
+{
+    const std::string file = "res/vanilla/heroes/groo/ai.lua";
+    const uint elementsCount = 1000u;
+
+    // The whole API used by the script, forwarding to the active entity, so that any callback can run
+    uint32 lootDosh = 0u;
+    auto registerAPI = [&lootDosh] (scene::LuaVM& vm) {
+        auto pVM = &vm;
+        auto active = [pVM] () -> BenchEntity& { return *static_cast<BenchEntity*>(pVM->active()); };
+
+        vm.state()["eev_initEmptyDataU32"] = std::function<uint32(const std::string&, uint32)>([active] (const std::string&, uint32 value) {
+            auto& entity = active();
+            if (entity.m_dosh == 0u) entity.m_dosh = value;
+            return entity.m_dosh;
+        });
+        vm.state()["eev_getDataU32"] = std::function<uint32(const std::string&)>([active] (const std::string&) { return active().m_dosh; });
+        vm.state()["eev_getDataFloat"] = std::function<float(const std::string&)>([] (const std::string&) { return 0.f; });
+        vm.state()["eev_spawnDynamic"] = std::function<uint32(const std::string&, float, float)>([] (const std::string&, float, float) { return 1u; });
+        vm.state()["eev_setUIDDataU32"] = std::function<uint32(uint32, const std::string&, uint32)>([&lootDosh] (uint32, const std::string& key, uint32 value) {
+            if (key == "dosh") lootDosh = value;
+            return value;
+        });
+        vm.state()["eev_stealTreasureInto"] = std::function<void(const std::string&)>([] (const std::string&) {});
+        vm.state()["eev_getOut"] = std::function<void()>([] {});
+    };
+
+    for (bool shared : {false, true}) {
+        scene::AI::setSharedVMs(shared);
+
+        std::vector<std::unique_ptr<BenchEntity>> entities;
+        auto start = std::chrono::steady_clock::now();
+        for (uint i = 0u; i < elementsCount; ++i) {
+            entities.emplace_back(std::make_unique<BenchEntity>());
+            if (!entities.back()->m_ai.load(file, registerAPI)) {
+                std::cerr << "Cannot load " << file << "." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        auto spawnDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Memory of all distinct VMs
+        size_t memory = 0u;
+        std::vector<scene::LuaVM*> vms;
+        for (auto& entity : entities) {
+            auto vm = entity->m_ai.vm();
+            if (std::find(std::begin(vms), std::end(vms), vm) != std::end(vms)) continue;
+            vms.emplace_back(vm);
+            memory += vm->memoryUsage();
+        }
+
+        // Calls
+        start = std::chrono::steady_clock::now();
+        for (auto& entity : entities) {
+            entity->m_ai.lua()["_reinit"]();
+            entity->m_ai.lua()["_update"](0.016);
+        }
+        auto callsDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // The API should have been called on each element
+        for (auto& entity : entities) {
+            if (entity->m_dosh != 50u) {
+                std::cerr << "The API was not called on the active element." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::cout << elementsCount << " elements, " << (shared? "shared VM  " : "private VMs") << ": "
+                  << memory / elementsCount << " bytes/element, "
+                  << 1e6 * spawnDuration / elementsCount << " us/spawn, "
+                  << static_cast<uint64>(2u * elementsCount / callsDuration) << " calls/s ("
+                  << vms.size() << " VMs)" << std::endl;
+    }
+
+    // Bytecode cache, private VMs to load the script each time
+    scene::AI::setSharedVMs(false);
+    for (bool cached : {false, true}) {
+        std::vector<std::unique_ptr<BenchEntity>> entities;
+        auto start = std::chrono::steady_clock::now();
+        for (uint i = 0u; i < elementsCount; ++i) {
+            if (!cached) scene::s_luaCache.clear();
+            entities.emplace_back(std::make_unique<BenchEntity>());
+            entities.back()->m_ai.load(file, registerAPI);
+        }
+        auto spawnDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << elementsCount << " elements, private VMs, " << (cached? "bytecode cache" : "compiling     ") << ": "
+                  << 1e6 * spawnDuration / elementsCount << " us/spawn" << std::endl;
+    }
+
+    // Instances should not share their script state
+    scene::AI::setSharedVMs(true);
+    BenchEntity first, second;
+    first.m_ai.load(file, registerAPI);
+    second.m_ai.load(file, registerAPI);
+    first.m_ai.lua()["benchValue"] = 1;
+    second.m_ai.lua()["benchValue"] = 2;
+    if (static_cast<int>(first.m_ai.lua()["benchValue"]) != 1) {
+        std::cerr << "Instances share their globals." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Callbacks using the rest of the API
+    first.m_ai.lua()["_reinit"]();
+    first.m_ai.lua()["_onDeath"]();
+    if (lootDosh != 50u) {
+        std::cerr << "The API was not called from _onDeath()." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "tools/tools.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+//! Returns ok, reporting the label if the check failed.
+inline bool check(const std::string& label, bool ok)
+{
+    if (!ok) std::cerr << label << " failed." << std::endl;
+    return ok;
+}
+
+//! Returns true if the strings are equal, reporting both otherwise.
+inline bool check(const std::string& label, const std::string& found, const std::string& expected)
+{
+    returnif (found == expected) true;
+    std::cerr << label << " failed." << std::endl;
+    std::cerr << "Found: " << found << " | Expected: " << expected << std::endl;
+    return false;
+}
+
+//! Returns true if the values are equal, reporting the sizes otherwise.
+template <typename T>
+inline bool check(const std::string& label, const std::vector<T>& found, const std::vector<T>& expected)
+{
+    returnif (found == expected) true;
+    std::cerr << label << " failed, got " << found.size() << " values instead of " << expected.size() << "." << std::endl;
+    return false;
+}
@@ -0,0 +1,98 @@
+#include "resources/atlaspacker.hpp"
+#include "tools/random.hpp"
+#include "tools/tools.hpp"
+
+#include <iostream>
+#include <vector>
+
+//! Whether the packing is valid: all in pages, no overlap, padding kept.
+bool validPacking(const std::vector<sf::Vector2u>& sizes, const std::vector<resources::AtlasPacker::Placement>& placements,
+                  const sf::Vector2u& pageSize, int padding)
+{
+    returnif (sizes.size() != placements.size()) false;
+
+    for (uint i = 0u; i < placements.size(); ++i) {
+        const auto& placement = placements[i];
+        const auto& rect = placement.rect;
+
+        // Too big for a page
+        if (placement.page < 0) {
+            returnif (sizes[i].x + 2u * padding <= pageSize.x && sizes[i].y + 2u * padding <= pageSize.y) false;
+            continue;
+        }
+
+        returnif (rect.width != static_cast<int>(sizes[i].x) || rect.height != static_cast<int>(sizes[i].y)) false;
+        returnif (rect.left < padding || rect.top < padding) false;
+        returnif (rect.left + rect.width + padding > static_cast<int>(pageSize.x)) false;
+        returnif (rect.top + rect.height + padding > static_cast<int>(pageSize.y)) false;
+
+        for (uint j = 0u; j < i; ++j) {
+            const auto& other = placements[j];
+            if (other.page != placement.page) continue;
+
+            bool apart = rect.left + rect.width + 2 * padding <= other.rect.left || other.rect.left + other.rect.width + 2 * padding <= rect.left
+                      || rect.top + rect.height + 2 * padding <= other.rect.top || other.rect.top + other.rect.height + 2 * padding <= rect.top;
+            returnif (!apart) false;
+        }
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    alea::seed(42u);
+
+    const sf::Vector2u pageSize(1024u, 1024u);
+    resources::AtlasPacker packer(pageSize, 2u);
+
+    // Sprites-like sizes, some too big
+    std::vector<sf::Vector2u> sizes;
+    for (uint i = 0u; i < 600u; ++i)
+        sizes.emplace_back(alea::rand(8u, 160u), alea::rand(8u, 160u));
+    sizes.emplace_back(2000u, 10u);
+    sizes.emplace_back(1022u, 1022u);
+    sizes.emplace_back(1020u, 1020u);
+
+    auto placements = packer.pack(sizes);
+    if (!validPacking(sizes, placements, pageSize, 2)) {
+        std::cerr << "Invalid packing." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Exactly filling a page with padding, but not beyond
+    if (placements[600u].page != -1 || placements[601u].page != -1 || placements[602u].page < 0) {
+        std::cerr << "Wrong decision for big rectangles." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Quality
+    std::cout << "Packed in " << packer.pagesCount() << " pages, occupancy " << packer.occupancy() << "." << std::endl;
+    if (packer.occupancy() < 0.8f) {
+        std::cerr << "Packing is too sparse." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Deterministic
+    auto placementsAgain = packer.pack(sizes);
+    for (uint i = 0u; i < placements.size(); ++i) {
+        if (placements[i].page != placementsAgain[i].page || placements[i].rect != placementsAgain[i].rect) {
+            std::cerr << "Packing is not deterministic." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Same sizes fill rows
+    std::vector<sf::Vector2u> tiles(64u, {124u, 124u});
+    packer.pack(tiles);
+    if (packer.pagesCount() != 1u || packer.pagesHeights()[0u] != 1024u || packer.occupancy() < 0.9f) {
+        std::cerr << "Tiles should fill exactly one page." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Nothing to pack
+    packer.pack({});
+    returnif (packer.pagesCount() != 0u || packer.occupancy() != 0.f) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
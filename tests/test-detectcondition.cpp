@@ -0,0 +1,110 @@
+#include "dungeon/detectcondition.hpp"
+#include "dungeon/detectentity.hpp"
+#include "tools/tools.hpp"
+
+#include <iostream>
+
+//! A detect entity with a key and a single data.
+class TestEntity final : public dungeon::DetectEntity
+{
+public:
+
+    TestEntity(const std::string& key) : m_key(key) { setDetectRangeFactor(100.f); setDetectRoomSize({100.f, 100.f}); }
+
+    std::string _name() const final { return "TestEntity"; }
+    std::string detectKey() const final { return m_key; }
+
+    bool detectData(uint32, float& value) const final
+    {
+        returnif (m_dosh < 0.f) false;
+        value = m_dosh;
+        return true;
+    }
+
+    float m_dosh = -1.f;
+
+private:
+
+    std::string m_key;
+};
+
+int main(void)
+{
+    // Compilation, with the range out of which the condition cannot be met
+    struct Compilation
+    {
+        std::string condition;
+        bool valid;
+        float range;
+    };
+
+    std::vector<Compilation> compilations = {
+        {"distance < 0.3",                                      true,   0.3f},
+        {"distance<0.3 and same_room",                          true,   0.3f},
+        {"distance < 0.5 or key == monster",                    true,   -1.f},
+        {"(distance < 1 or distance <= 2) and data.dosh > 0",   true,   2.f},
+        {"not distance < 1",                                    true,   -1.f},
+        {"same_floor",                                          true,   -1.f},
+        {"distance == 3",                                       false,  -1.f},
+        {"distance <",                                          false,  -1.f},
+        {"(same_room",                                          false,  -1.f},
+        {"key == 3",                                            false,  -1.f},
+        {"same_room same_floor",                                false,  -1.f},
+        {"unknown < 2",                                         false,  -1.f},
+        {"",                                                    false,  -1.f},
+    };
+
+    for (const auto& compilation : compilations) {
+        dungeon::DetectCondition condition;
+        bool valid = condition.compile(compilation.condition);
+        if (valid != compilation.valid || condition.valid() != valid || condition.range() != compilation.range) {
+            std::cerr << "Compiling '" << compilation.condition << "' failed: " << condition.error() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Evaluation, the entities being in the same room, 40 apart
+    TestEntity trap("trap");
+    TestEntity hero("hero");
+    trap.setLocalPosition({10.f, 10.f});
+    hero.setLocalPosition({50.f, 10.f});
+    hero.m_dosh = 5.f;
+
+    struct Evaluation
+    {
+        std::string condition;
+        bool met;
+    };
+
+    std::vector<Evaluation> evaluations = {
+        {"distance < 0.3",                                      false},
+        {"distance < 0.5",                                      true},
+        {"same_room",                                           true},
+        {"not same_room",                                       false},
+        {"key == hero and same_floor",                          true},
+        {"key != hero or data.dosh > 4",                        true},
+        {"data.dosh > 5",                                       false},
+        {"data.dosh >= 5 and (distance > 1 or same_room)",      true},
+        {"not not same_room and not key == monster",            true},
+        {"data.dosh < 10 and distance > 0.5",                   false},
+    };
+
+    for (const auto& evaluation : evaluations) {
+        dungeon::DetectCondition condition;
+        condition.compile(evaluation.condition);
+        if (condition.evaluate(trap, hero) != evaluation.met) {
+            std::cerr << "Evaluating '" << evaluation.condition << "' failed." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Other room, same floor, and missing data
+    hero.setLocalPosition({150.f, 10.f});
+    hero.m_dosh = -1.f;
+
+    dungeon::DetectCondition condition;
+    condition.compile("same_floor and not same_room and not data.dosh > 0");
+    returnif (!condition.evaluate(trap, hero)) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#include "dungeon/detector.hpp"
+#include "dungeon/detectentity.hpp"
+#include "tools/tools.hpp"
+#include "check.hpp"
+
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//! A detect entity recording the events of its signals.
+class TestEntity final : public dungeon::DetectEntity
+{
+public:
+
+    TestEntity(const std::string& key) : m_key(key) {}
+
+    std::string _name() const final { return "TestEntity"; }
+    std::string detectKey() const final { return m_key; }
+
+    void watch(const std::string& key, DetectEvent event, std::vector<uint32>& calls)
+    {
+        addDetectSignal(key, "distance < 10", [&calls] (const uint32 UID) { calls.emplace_back(UID); }, event);
+    }
+
+    void tick() { update(sf::Time::Zero, 1.f); }
+
+private:
+
+    std::string m_key;
+};
+
+int main(void)
+{
+    std::vector<uint32> enters, stays, exits;
+
+    TestEntity trap("trap");
+    trap.watch("hero", TestEntity::DetectEvent::ENTER, enters);
+    trap.watch("hero", TestEntity::DetectEvent::STAY, stays);
+    trap.watch("hero", TestEntity::DetectEvent::EXIT, exits);
+
+    auto hero = std::make_unique<TestEntity>("hero");
+    auto monster = std::make_unique<TestEntity>("monster");
+    hero->setLocalPosition({100.f, 0.f});
+    monster->setLocalPosition({1.f, 0.f});
+    const auto heroUID = hero->UID();
+
+    // Nothing in range, other keys ignored
+    trap.tick();
+    returnif (!check("Out of range", enters, {}) || !check("Out of range", stays, {}) || !check("Out of range", exits, {})) EXIT_FAILURE;
+
+    // Entering, once
+    hero->setLocalPosition({5.f, 0.f});
+    trap.tick();
+    trap.tick();
+    trap.tick();
+    returnif (!check("Enter", enters, {heroUID})) EXIT_FAILURE;
+    returnif (!check("Stay", stays, {heroUID, heroUID, heroUID})) EXIT_FAILURE;
+    returnif (!check("No exit", exits, {})) EXIT_FAILURE;
+
+    // Leaving, once
+    hero->setLocalPosition({50.f, 0.f});
+    trap.tick();
+    trap.tick();
+    returnif (!check("Exit", exits, {heroUID})) EXIT_FAILURE;
+    returnif (!check("No more stay", stays, {heroUID, heroUID, heroUID})) EXIT_FAILURE;
+
+    // Hidden entities leave too
+    hero->setLocalPosition({0.f, 5.f});
+    trap.tick();
+    hero->setDetectVisible(false);
+    trap.tick();
+    returnif (!check("Enter again", enters, {heroUID, heroUID})) EXIT_FAILURE;
+    returnif (!check("Exit when hidden", exits, {heroUID, heroUID})) EXIT_FAILURE;
+
+    // Destroyed entities leave, with their now stale UID
+    hero->setDetectVisible(true);
+    trap.tick();
+    hero = nullptr;
+    trap.tick();
+    returnif (!check("Exit when destroyed", exits, {heroUID, heroUID, heroUID})) EXIT_FAILURE;
+
+    // Inactive entities keep their state
+    auto otherHero = std::make_unique<TestEntity>("hero");
+    otherHero->setLocalPosition({0.f, 0.f});
+    trap.setDetectActive(false);
+    trap.tick();
+    returnif (!check("Inactive", enters, {heroUID, heroUID, heroUID})) EXIT_FAILURE;
+    trap.setDetectActive(true);
+    trap.tick();
+    returnif (!check("Active again", enters, {heroUID, heroUID, heroUID, otherHero->UID()})) EXIT_FAILURE;
+
+    // Far entities and huge ranges do not overflow the cells
+    auto inRangeCount = [] (const sf::Vector2f& position, float range) {
+        uint count = 0u;
+        dungeon::s_detector.applyInRange(position, range, [&count] (dungeon::DetectEntity&, float) { count += 1u; });
+        return count;
+    };
+
+    // Enough cells for small ranges to use the spatial index
+    std::vector<std::unique_ptr<TestEntity>> fillers;
+    for (uint i = 0u; i < 16u; ++i) {
+        fillers.emplace_back(std::make_unique<TestEntity>("filler"));
+        fillers.back()->setLocalPosition({-1000.f - 200.f * i, 0.f});
+    }
+
+    monster->setLocalPosition({1e12f, 0.f});
+    returnif (!check("Far entity", inRangeCount({0.f, 0.f}, 10.f) == 2u && inRangeCount({1e12f, 0.f}, 10.f) == 1u)) EXIT_FAILURE;
+    returnif (!check("Huge range", inRangeCount({0.f, 0.f}, 1e35f) == 19u)) EXIT_FAILURE;
+    returnif (!check("Infinite range", inRangeCount({0.f, 0.f}, std::numeric_limits<float>::infinity()) == 19u)) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
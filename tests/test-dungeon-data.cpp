@@ -4,21 +4,15 @@
 #include <iostream>
 #include <fstream>
 
-int main(void)
+//! Returns true if both files have the same content, line by line.
+bool sameFiles(const std::wstring& loadedFilename, const std::wstring& savedFilename)
 {
-    dungeon::Data data;
-
-    // Loading and saving
-    auto loadedFilename = data.load(L"../tests/data/test-dungeon-data/");
-    auto savedFilename = data.save(L"../tests/data/test-dungeon-data/saved-");
-
-    // Files should be identical
     std::wifstream loaded(toString(loadedFilename));
     std::wifstream saved(toString(savedFilename));
 
     if (!loaded.is_open() || !saved.is_open()) {
         std::cerr << "Cannot load files." << std::endl;
-        return EXIT_FAILURE;
+        return false;
     }
 
     std::wstring loadedString;
@@ -27,14 +21,39 @@ int main(void)
     uint lineNumber = 1u;
     while (getline(loaded, loadedString) && getline(saved, savedString)) {
         if (loadedString != savedString) {
-            std::wcout << L"Saved file is different from loaded file at line " << lineNumber << L"." << std::endl;
+            std::wcout << L"Saved file " << savedFilename << L" is different from loaded file at line " << lineNumber << L"." << std::endl;
             std::wcout << L"Load: " << loadedString << std::endl;
             std::wcout << L"Save: " << savedString << std::endl;
-            return EXIT_FAILURE;
+            return false;
         }
 
         ++lineNumber;
     }
 
+    return true;
+}
+
+int main(void)
+{
+    dungeon::Data data;
+
+    // Loading and saving
+    auto loadedFilename = data.load(L"../tests/data/test-dungeon-data/");
+    auto savedFilename = data.save(L"../tests/data/test-dungeon-data/saved-");
+
+    // Files should be identical
+    if (!sameFiles(loadedFilename, savedFilename))
+        return EXIT_FAILURE;
+
+    // Going through the binary format should not lose anything
+    data.setBinarySaves(true);
+    data.save(L"../tests/data/test-dungeon-data/saved-binary-");
+    data.load(L"../tests/data/test-dungeon-data/saved-binary-");
+    data.setBinarySaves(false);
+    auto binarySavedFilename = data.save(L"../tests/data/test-dungeon-data/saved-binary-");
+
+    if (!sameFiles(loadedFilename, binarySavedFilename))
+        return EXIT_FAILURE;
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,120 @@
+#include "context/event.hpp"
+#include "tools/tools.hpp"
+#include "check.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+
+struct TestEvent : public context::Event
+{
+    TestEvent() { std::memset(static_cast<void*>(this), 0, sizeof(TestEvent)); }
+    int value;
+};
+
+class TestEmitter final : public context::EventEmitter
+{
+public:
+    using context::EventEmitter::broadcast;
+    using context::EventEmitter::setCoalescing;
+
+    void add(context::EventID type, int value)
+    {
+        TestEvent event;
+        event.type = type;
+        event.value = value;
+        addEvent(event);
+    }
+};
+
+class TestReceiver final : public context::EventReceiver
+{
+public:
+    std::string received;
+    TestEmitter* reemitter = nullptr;
+
+protected:
+    void receive(const context::Event& event) final
+    {
+        const auto& tevent = *reinterpret_cast<const TestEvent*>(&event);
+        received += context::eventName(tevent.type) + std::to_string(tevent.value) + " ";
+
+        // Re-emitting while broadcasting
+        if (reemitter != nullptr && tevent.value == 0)
+            reemitter->add(tevent.type, 9);
+    }
+};
+
+int main(void)
+{
+    const auto a = context::eventID("a");
+    const auto b = context::eventID("b");
+    const auto c = context::eventID("c");
+    const auto d = context::eventID("d");
+
+    TestEmitter emitter;
+    TestReceiver receiver;
+    receiver.setEmitter(&emitter, {a, b, c, d});
+
+    emitter.setCoalescing(b, context::Coalescing::DROP_IF_LAST_EQUAL);
+    emitter.setCoalescing(c, context::Coalescing::MERGE);
+    emitter.setCoalescing(d, context::Coalescing::MOVE_TO_END);
+
+    // No coalescing
+    emitter.add(a, 1); emitter.add(a, 1); emitter.add(d, 1); emitter.add(a, 1);
+    emitter.broadcast();
+    returnif (!check("No coalescing", receiver.received, "a1 a1 d1 a1 ")) EXIT_FAILURE;
+
+    // Drop if last equal
+    receiver.received.clear();
+    emitter.add(b, 1); emitter.add(b, 1); emitter.add(b, 2); emitter.add(a, 1); emitter.add(b, 2);
+    emitter.broadcast();
+    returnif (!check("Drop if last equal", receiver.received, "b1 b2 a1 b2 ")) EXIT_FAILURE;
+
+    // Merge
+    receiver.received.clear();
+    emitter.add(c, 1); emitter.add(a, 1); emitter.add(c, 2); emitter.add(c, 1); emitter.add(a, 2); emitter.add(c, 2);
+    emitter.broadcast();
+    returnif (!check("Merge", receiver.received, "c1 a1 c2 a2 ")) EXIT_FAILURE;
+
+    // Move to end, like facility_changed around a room reconstruction
+    receiver.received.clear();
+    emitter.add(d, 1); emitter.add(a, 1); emitter.add(b, 1); emitter.add(d, 1); emitter.add(d, 2); emitter.add(d, 2);
+    emitter.broadcast();
+    returnif (!check("Move to end", receiver.received, "a1 b1 d1 d2 ")) EXIT_FAILURE;
+
+    // Partial broadcasts, coalesced events still counted until sent
+    receiver.received.clear();
+    emitter.add(d, 1); emitter.add(a, 1); emitter.add(d, 1);
+    emitter.broadcast(2u);
+    emitter.add(c, 1);
+    emitter.broadcast(1u);
+    emitter.add(c, 1);
+    emitter.broadcast();
+    returnif (!check("Partial broadcasts", receiver.received, "a1 d1 c1 ")) EXIT_FAILURE;
+
+    // Events added while broadcasting wait for the next broadcast
+    receiver.received.clear();
+    receiver.reemitter = &emitter;
+    emitter.add(a, 0); emitter.add(c, 0); emitter.add(c, 9); emitter.add(d, 0);
+    emitter.broadcast();
+    returnif (!check("Broadcasting", receiver.received, "a0 c0 c9 d0 ")) EXIT_FAILURE;
+    receiver.received.clear();
+    emitter.broadcast();
+    returnif (!check("Next broadcast", receiver.received, "a9 d9 ")) EXIT_FAILURE;
+    receiver.reemitter = nullptr;
+
+    // Many events, growing the ring buffer while not starting at its beginning
+    std::stringstream expected;
+    receiver.received.clear();
+    for (int i = 0; i < 100; ++i) {
+        emitter.add(a, i);
+        emitter.add(d, i % 3);
+        expected << "a" << i << " ";
+        if (i >= 97) expected << "d" << i % 3 << " ";
+    }
+    emitter.broadcast();
+    returnif (!check("Growing", receiver.received, expected.str())) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+// Randomized differential test of dungeon::Graph incremental updates.
+// After random edits, the graph patched from invalidated rooms
+// should be identical to a graph fully rebuilt from the same data.
+// Its cached distance fields should match a plain search from each room.
+
+#include "dungeon/data.hpp"
+#include "dungeon/graph.hpp"
+#include "ai/node.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+
+const dungeon::Graph::NodeData* toNodeData(const ai::Node* node)
+{
+    returnif (node == nullptr) nullptr;
+    return reinterpret_cast<const dungeon::Graph::NodeData*>(node->data);
+}
+
+const dungeon::Graph::NeighbourData* toNeighbourData(const ai::Neighbour& neighbour)
+{
+    return reinterpret_cast<const dungeon::Graph::NeighbourData*>(neighbour.data);
+}
+
+//! Returns true if both graphs have the same nodes, neighbours and starting nodes.
+bool sameGraphs(const dungeon::Graph& patched, const dungeon::Graph& rebuilt, const dungeon::Data& data)
+{
+    for (uint8 floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint8 room = 0u; room < data.floorRoomsCount(); ++room) {
+        dungeon::RoomCoords coords = {floor, room};
+        const auto& patchedNode = *patched.nodeData(coords);
+        const auto& rebuiltNode = *rebuilt.nodeData(coords);
+
+        if (patchedNode.constructed != rebuiltNode.constructed || patchedNode.entrance != rebuiltNode.entrance
+            || patchedNode.treasure != rebuiltNode.treasure || patchedNode.altitude != rebuiltNode.altitude) {
+            std::cerr << "Node " << coords << " has different attributes." << std::endl;
+            return false;
+        }
+
+        const auto& patchedNeighbours = patchedNode.node->neighbours;
+        const auto& rebuiltNeighbours = rebuiltNode.node->neighbours;
+        if (patchedNeighbours.size() != rebuiltNeighbours.size()) {
+            std::cerr << "Node " << coords << " has a different number of neighbours." << std::endl;
+            std::cerr << "Found: " << patchedNeighbours.size() << " | Expected: " << rebuiltNeighbours.size() << std::endl;
+            return false;
+        }
+
+        for (uint i = 0u; i < patchedNeighbours.size(); ++i) {
+            if (toNodeData(patchedNeighbours[i].node)->coords != toNodeData(rebuiltNeighbours[i].node)->coords
+                || toNeighbourData(patchedNeighbours[i])->tunnelFacilityID != toNeighbourData(rebuiltNeighbours[i])->tunnelFacilityID) {
+                std::cerr << "Node " << coords << " has a different neighbour " << i << "." << std::endl;
+                std::cerr << "Found: " << toNodeData(patchedNeighbours[i].node)->coords
+                          << " | Expected: " << toNodeData(rebuiltNeighbours[i].node)->coords << std::endl;
+                return false;
+            }
+        }
+    }
+
+    const auto& patchedStartingNodes = patched.startingNodes();
+    const auto& rebuiltStartingNodes = rebuilt.startingNodes();
+    if (patchedStartingNodes.size() != rebuiltStartingNodes.size()) {
+        std::cerr << "Different number of starting nodes." << std::endl;
+        std::cerr << "Found: " << patchedStartingNodes.size() << " | Expected: " << rebuiltStartingNodes.size() << std::endl;
+        return false;
+    }
+
+    for (uint i = 0u; i < patchedStartingNodes.size(); ++i) {
+        if (toNodeData(patchedStartingNodes[i])->coords != toNodeData(rebuiltStartingNodes[i])->coords) {
+            std::cerr << "Starting node " << i << " is different." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//! Distances from a room to all others, following neighbours forward.
+std::vector<uint> distancesFrom(const dungeon::Graph& graph, const dungeon::Data& data, const dungeon::RoomCoords& from)
+{
+    std::vector<uint> distances(data.floorsCount() * data.floorRoomsCount(), -1u);
+    auto index = [&data] (const dungeon::RoomCoords& coords) { return coords.x * data.floorRoomsCount() + coords.y; };
+
+    std::queue<const dungeon::Graph::NodeData*> queue;
+    distances[index(from)] = 0u;
+    queue.emplace(graph.nodeData(from));
+    while (!queue.empty()) {
+        auto nodeData = queue.front();
+        queue.pop();
+        for (const auto& neighbour : nodeData->node->neighbours) {
+            auto neighbourData = toNodeData(neighbour.node);
+            if (distances[index(neighbourData->coords)] != -1u) continue;
+            distances[index(neighbourData->coords)] = distances[index(nodeData->coords)] + 1u;
+            queue.emplace(neighbourData);
+        }
+    }
+
+    return distances;
+}
+
+//! Returns true if all distances given by the graph are the shortest ones.
+bool sameDistances(dungeon::Graph& graph, const dungeon::Data& data)
+{
+    for (uint8 floor = 0u; floor < data.floorsCount(); ++floor)
+    for (uint8 room = 0u; room < data.floorRoomsCount(); ++room) {
+        dungeon::RoomCoords from = {floor, room};
+        auto distances = distancesFrom(graph, data, from);
+
+        uint entranceDistance = -1u;
+        uint treasureDistance = -1u;
+        for (uint8 toFloor = 0u; toFloor < data.floorsCount(); ++toFloor)
+        for (uint8 toRoom = 0u; toRoom < data.floorRoomsCount(); ++toRoom) {
+            dungeon::RoomCoords to = {toFloor, toRoom};
+            const auto& toData = *graph.nodeData(to);
+            auto expected = toData.constructed? distances[toFloor * data.floorRoomsCount() + toRoom] : -1u;
+            if (toData.entrance) entranceDistance = std::min(entranceDistance, expected);
+            if (toData.treasure > 0u) treasureDistance = std::min(treasureDistance, expected);
+
+            if (graph.distance(from, to) != expected) {
+                std::cerr << "Distance from " << from << " to " << to << " is wrong." << std::endl;
+                std::cerr << "Found: " << graph.distance(from, to) << " | Expected: " << expected << std::endl;
+                return false;
+            }
+
+            // The next room should be one move closer
+            auto next = graph.nextTowards(from, to);
+            bool nextExpected = (expected != 0u && expected != -1u);
+            if ((next != nullptr) != nextExpected || (next != nullptr && graph.distance(next->coords, to) != expected - 1u)) {
+                std::cerr << "Next room from " << from << " to " << to << " is wrong." << std::endl;
+                return false;
+            }
+        }
+
+        if (graph.entranceDistance(from) != entranceDistance || graph.treasureDistance(from) != treasureDistance) {
+            std::cerr << "Distance from " << from << " to entrances or treasures is wrong." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    dungeon::Data data;
+    dungeon::Graph graph;
+
+    data.load(L"../tests/data/test-graph/");
+    graph.useData(data);
+
+    std::mt19937 generator(42u);
+    auto random = [&generator] (uint max) { return std::uniform_int_distribution<uint>(0u, max - 1u)(generator); };
+    const std::vector<std::wstring> facilitiesIDs = {L"entrance", L"ladder", L"stairs", L"smallChest", L"torch", L"trapdoor"};
+    const std::vector<dungeon::Direction> directions = {dungeon::EAST, dungeon::WEST, dungeon::NORTH, dungeon::SOUTH};
+
+    auto randomEdit = [&] {
+        dungeon::RoomCoords coords = {static_cast<uint8>(random(data.floorsCount())),
+                                      static_cast<uint8>(random(data.floorRoomsCount()))};
+        const auto& facilityID = facilitiesIDs[random(facilitiesIDs.size())];
+
+        switch (random(9u)) {
+        case 0u: data.constructRoom(coords); break;
+        case 1u: data.destroyRoom(coords); break;
+        case 2u: data.pushRoom(coords, directions[random(directions.size())]); break;
+        case 3u:
+        case 4u: data.facilitiesCreate(coords, facilityID); break;
+        case 5u: data.facilitiesRemove(coords, facilityID); break;
+        case 6u: {
+            auto facilityInfo = data.facilitiesFind(coords, facilityID);
+            if (facilityInfo == nullptr) break;
+            if (random(2u) == 0u) data.addFacilityTunnel(*facilityInfo, {static_cast<int>(random(3u)) - 1, static_cast<int>(random(3u)) - 1}, true);
+            else data.addFacilityTunnel(*facilityInfo, {static_cast<int>(random(data.floorsCount())), static_cast<int>(random(data.floorRoomsCount()))}, false);
+            break;
+        }
+        case 7u: data.setRoomFacilityBarrier(coords, facilityID, random(2u) == 0u); break;
+        case 8u: data.setRoomFacilityTreasure(coords, facilityID, random(100u)); break;
+        }
+    };
+
+    // Compares the graph to one fully rebuilt from a copy of the same data.
+    auto checkGraph = [&] (const std::string& when) {
+        data.save(L"../tests/data/test-graph/saved-update-");
+        dungeon::Data rebuiltData;
+        dungeon::Graph rebuiltGraph;
+        rebuiltData.load(L"../tests/data/test-graph/saved-update-");
+        rebuiltGraph.useData(rebuiltData);
+
+        if (!sameGraphs(graph, rebuiltGraph, data)) {
+            std::cerr << "Incremental update differs from full rebuild " << when << "." << std::endl;
+            return false;
+        }
+
+        if (!sameDistances(graph, data)) {
+            std::cerr << "Cached distances are wrong " << when << "." << std::endl;
+            return false;
+        }
+
+        return true;
+    };
+
+    // Broadcasting after each edit, so that the graph patches itself
+    const uint roundsCount = 50u;
+    const uint editsCount = 20u;
+    for (uint round = 0u; round < roundsCount; ++round) {
+        for (uint edit = 0u; edit < editsCount; ++edit) {
+            randomEdit();
+            data.update(sf::Time::Zero);
+        }
+
+        if (!checkGraph("after round " + std::to_string(round)))
+            return EXIT_FAILURE;
+    }
+
+    // Several edits coalesced into one broadcast
+    for (uint round = 0u; round < roundsCount; ++round) {
+        for (uint edit = 0u; edit < editsCount; ++edit)
+            randomEdit();
+        data.update(sf::Time::Zero);
+
+        if (!checkGraph("after coalesced round " + std::to_string(round)))
+            return EXIT_FAILURE;
+    }
+
+    // Loading while rooms are still invalidated, only the load should be considered
+    data.save(L"../tests/data/test-graph/saved-update-");
+    for (uint edit = 0u; edit < editsCount; ++edit)
+        randomEdit();
+    data.load(L"../tests/data/test-graph/saved-update-");
+    data.update(sf::Time::Zero);
+
+    if (!checkGraph("after loading"))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include "tools/handlepool.hpp"
+#include "check.hpp"
+
+#include <iostream>
+#include <string>
+
+struct TestObject
+{
+    TestObject(std::string inName) : name(std::move(inName)) {}
+    std::string name;
+};
+
+using TestPool = HandlePool<TestObject, 4u>;
+
+//! Returns all names in iteration order.
+std::string names(const TestPool& pool)
+{
+    std::string names;
+    for (const auto& object : pool)
+        names += object.name + " ";
+    return names;
+}
+
+int main(void)
+{
+    TestPool pool;
+    std::vector<TestPool::Handle> handles;
+
+    // Several chunks
+    for (uint i = 0u; i < 10u; ++i)
+        handles.emplace_back(pool.emplace(std::to_string(i)));
+    returnif (!check("Emplace", pool.size() == 10u && names(pool) == "0 1 2 3 4 5 6 7 8 9 ")) EXIT_FAILURE;
+
+    // Addresses are stable, handles get stale
+    auto pFive = pool.get(handles[5u]);
+    pool.erase(handles[2u]);
+    pool.erase(handles[7u]);
+    auto handle = pool.emplace("x");
+    returnif (!check("Stable address", pool.get(handles[5u]) == pFive && pFive->name == "5")) EXIT_FAILURE;
+    returnif (!check("Stale handle", pool.get(handles[2u]) == nullptr && pool.get(handles[7u]) == nullptr)) EXIT_FAILURE;
+    returnif (!check("Reused slot", pool.get(handle) != nullptr && pool.get(handle)->name == "x")) EXIT_FAILURE;
+    returnif (!check("Invalid handle", pool.get(TestPool::invalidHandle) == nullptr)) EXIT_FAILURE;
+
+    // Erasing while iterating
+    for (auto it = std::begin(pool); it != std::end(pool); ++it)
+        if (it->name == "3" || it->name == "9")
+            pool.erase(it.handle());
+    returnif (!check("Erase while iterating", pool.size() == 7u && names(pool) == "0 1 4 5 6 x 8 ")) EXIT_FAILURE;
+
+    // Many generations of the same slot
+    for (uint i = 0u; i < 10000u; ++i) {
+        auto oldHandle = pool.emplace("y");
+        pool.erase(oldHandle);
+        returnif (!check("Generations", pool.get(oldHandle) == nullptr && pool.size() == 7u)) EXIT_FAILURE;
+    }
+
+    pool.clear();
+    returnif (!check("Clear", pool.empty() && std::begin(pool) == std::end(pool) && pool.get(handle) == nullptr)) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
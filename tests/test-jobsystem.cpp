@@ -0,0 +1,93 @@
+#include "core/jobsystem.hpp"
+#include "tools/tools.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//! Nested fork/join.
+uint fibonacci(JobSystem& jobs, uint n)
+{
+    returnif (n < 2u) n;
+
+    uint a = 0u, b = 0u;
+    JobGroup group;
+    jobs.fork(group, "fibonacci", [&jobs, &a, n] { a = fibonacci(jobs, n - 1u); });
+    b = fibonacci(jobs, n - 2u);
+    jobs.join(group);
+
+    return a + b;
+}
+
+int main(void)
+{
+    for (uint workersCount = 1u; workersCount <= 8u; ++workersCount) {
+        JobSystem jobs;
+        jobs.start(workersCount);
+        const auto suffix = " on " + std::to_string(workersCount) + " workers";
+        returnif (!check("Workers count" + suffix, jobs.workersCount() == workersCount)) EXIT_FAILURE;
+
+        // Each index run exactly once, whatever the grain
+        for (uint grain = 1u; grain <= 7u; grain += 3u) {
+            std::vector<uint> runs(100u, 0u);
+            jobs.parallelFor("for", runs.size(), [&runs] (uint index) { runs[index] += index + 1u; }, grain);
+
+            bool ok = true;
+            for (uint i = 0u; i < runs.size(); ++i)
+                ok = ok && (runs[i] == i + 1u);
+            returnif (!check("Parallel for" + suffix, ok)) EXIT_FAILURE;
+        }
+
+        // Fork/join
+        returnif (!check("Fork/join" + suffix, fibonacci(jobs, 16u) == 987u)) EXIT_FAILURE;
+
+        // Dependencies, each stage starting once the previous one is done
+        std::vector<uint> stages(3u, 0u);
+        JobGroup first, second, third;
+        for (uint i = 0u; i < 10u; ++i)
+            jobs.fork(first, "first", [&stages] { stages[0u] += 1u; });
+        jobs.forkAfter(first, second, "second", [&stages] { stages[1u] = stages[0u]; });
+        jobs.forkAfter(second, third, "third", [&stages] { stages[2u] = stages[1u] + 1u; });
+        jobs.join(third);
+        returnif (!check("Dependencies" + suffix, third.done() && stages[1u] == 10u && stages[2u] == 11u)) EXIT_FAILURE;
+
+        // Already done dependency
+        JobGroup fourth;
+        jobs.forkAfter(first, fourth, "fourth", [&stages] { stages[0u] = 0u; });
+        jobs.join(fourth);
+        returnif (!check("Done dependency" + suffix, stages[0u] == 0u)) EXIT_FAILURE;
+    }
+
+    // Hooks around each job, with a valid worker index
+    JobSystem jobs;
+    std::atomic<uint> started{0u}, finished{0u}, badWorkers{0u};
+    jobs.setHooks([&started, &badWorkers] (const char*, uint worker) { started += 1u; if (worker >= 4u) badWorkers += 1u; },
+                  [&finished] (const char*, uint) { finished += 1u; });
+    jobs.start(4u);
+    jobs.parallelFor("hooked", 50u, [] (uint) {});
+    returnif (!check("Hooks", started == 50u && finished == 50u && badWorkers == 0u)) EXIT_FAILURE;
+
+    // Jobs queued when stopping are run exactly once, by the workers or by the thread joining
+    JobGroup queuedGroup;
+    std::vector<std::atomic<uint>> queuedRuns(1000u);
+    for (auto& runs : queuedRuns)
+        jobs.fork(queuedGroup, "queued", [&runs] { runs += 1u; });
+    jobs.stop();
+    jobs.join(queuedGroup);
+
+    bool ok = queuedGroup.done();
+    for (const auto& runs : queuedRuns)
+        ok = ok && (runs == 1u);
+    returnif (!check("Queued before stop", ok && jobs.workersCount() == 1u)) EXIT_FAILURE;
+
+    // Jobs forked once stopped are run by the thread joining
+    JobGroup group;
+    uint value = 0u;
+    jobs.fork(group, "stopped", [&value] { value = 42u; });
+    jobs.join(group);
+    returnif (!check("Forked after stop", value == 42u)) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include "scene/entity.hpp"
+#include "scene/graph.hpp"
+#include "tools/random.hpp"
+#include "tools/tools.hpp"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+//! An entity exposing picking.
+class TestEntity final : public scene::Entity
+{
+public:
+
+    std::string _name() const final { return "TestEntity"; }
+
+    using scene::Entity::firstOver;
+    using scene::Entity::setDetectable;
+};
+
+//! Compare the indexed picking against the full DFS, over the root and around.
+bool samePicking(TestEntity& root, const std::string& label)
+{
+    for (uint i = 0u; i < 5000u; ++i) {
+        sf::Vector2f position{alea::rand(-100.f, 1100.f), alea::rand(-100.f, 1100.f)};
+        if (root.firstOver(position, true) != root.firstOver(position, false)) {
+            std::cerr << label << ": picking differs from the DFS at " << position.x << ", " << position.y << "." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(void)
+{
+    alea::seed(42u);
+
+    TestEntity root;
+    root.setSize({1000.f, 1000.f});
+
+    // A random tree, with some entities out of their parent, rotated, hidden, clipped or not detectable
+    std::vector<std::unique_ptr<TestEntity>> entities;
+    std::vector<TestEntity*> parents;
+    for (uint i = 0u; i < 500u; ++i) {
+        auto entity = std::make_unique<TestEntity>();
+        if (alea::rand(0u, 4u) != 0u)
+            entity->setSize({alea::rand(5.f, 150.f), alea::rand(5.f, 150.f)});
+        entity->setLocalPosition({alea::rand(-50.f, 300.f), alea::rand(-50.f, 300.f)});
+        entity->setDepth(alea::rand(0.f, 100.f));
+        if (alea::rand(0u, 10u) == 0u) entity->setLocalRotation(alea::rand(0.f, 90.f));
+        if (alea::rand(0u, 10u) == 0u) entity->setVisible(false);
+        if (alea::rand(0u, 5u) == 0u) entity->setDetectable(false);
+        if (alea::rand(0u, 20u) == 0u) entity->addClipArea({0.f, 0.f, 20.f, 20.f});
+
+        auto parentIndex = alea::rand(0u, static_cast<uint>(entities.size()));
+        auto& parent = (parentIndex == entities.size())? root : *entities[parentIndex];
+        parent.attachChild(*entity);
+        parents.emplace_back(&parent);
+        entities.emplace_back(std::move(entity));
+    }
+
+    returnif (!samePicking(root, "Initial tree")) EXIT_FAILURE;
+
+    // Moving and resizing, the bounds being refreshed incrementally
+    for (uint i = 0u; i < 100u; ++i) {
+        auto& entity = *alea::rand(entities);
+        entity.localMove({alea::rand(-100.f, 100.f), alea::rand(-100.f, 100.f)});
+        if (alea::rand(0u, 3u) == 0u) entity.setSize({alea::rand(5.f, 200.f), alea::rand(5.f, 200.f)});
+    }
+
+    returnif (!samePicking(root, "Moved entities")) EXIT_FAILURE;
+
+    // Detaching whole branches
+    for (uint i = 0u; i < 20u; ++i) {
+        auto index = alea::rand(0u, static_cast<uint>(entities.size()) - 1u);
+        if (parents[index] != nullptr)
+            parents[index]->detachChild(*entities[index]);
+        parents[index] = nullptr;
+    }
+
+    returnif (!samePicking(root, "Detached branches")) EXIT_FAILURE;
+
+    // Children order changes
+    for (uint i = 0u; i < 50u; ++i)
+        alea::rand(entities)->setDepth(alea::rand(0.f, 100.f));
+
+    returnif (!samePicking(root, "Reordered children")) EXIT_FAILURE;
+
+    // Hit tests are invalidated by any change of what is under the mouse
+    TestEntity entity;
+    root.attachChild(entity);
+    std::vector<std::pair<std::string, std::function<void()>>> changes = {
+        {"Move",     [&entity] { entity.localMove({1.f, 0.f}); }},
+        {"Resize",   [&entity] { entity.setSize({10.f, 10.f}); }},
+        {"Hide",     [&entity] { entity.setVisible(false); }},
+        {"Undetect", [&entity] { entity.setDetectable(false); }},
+        {"Depth",    [&entity] { entity.setDepth(42.f); }},
+        {"Clip",     [&entity] { entity.addClipArea({0.f, 0.f, 5.f, 5.f}); }},
+        {"Detach",   [&entity] { entity.detachChildren(); }},
+    };
+
+    for (const auto& change : changes) {
+        auto epoch = scene::Graph::hitTestEpoch();
+        change.second();
+        if (scene::Graph::hitTestEpoch() == epoch) {
+            std::cerr << change.first << " did not invalidate hit tests." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#include "tools/random.hpp"
+#include "tools/tools.hpp"
+#include "check.hpp"
+
+#include <iostream>
+#include <vector>
+
+//! Draws some numbers from a stream.
+std::vector<uint> draw(alea::Stream stream)
+{
+    std::vector<uint> numbers;
+    for (uint i = 0u; i < 100u; ++i)
+        numbers.emplace_back(alea::rand(0u, 1000u, stream));
+    return numbers;
+}
+
+int main(void)
+{
+    // Same seed, same sequences
+    alea::seed(42u);
+    auto heroes = draw(alea::Stream::HEROES);
+    auto elements = draw(alea::Stream::ELEMENTS);
+    alea::seed(42u);
+    returnif (!check("Reproducible", draw(alea::Stream::HEROES) == heroes)) EXIT_FAILURE;
+    returnif (!check("Different streams", elements != heroes)) EXIT_FAILURE;
+
+    // Streams are independent
+    alea::seed(42u);
+    draw(alea::Stream::VISUAL);
+    returnif (!check("Independent streams", draw(alea::Stream::ELEMENTS) == elements)) EXIT_FAILURE;
+
+    // Integer ranges are inclusive
+    bool lowSeen = false, highSeen = false;
+    for (uint i = 0u; i < 1000u; ++i) {
+        auto value = alea::rand(1, 3);
+        returnif (!check("Integer range", value >= 1 && value <= 3)) EXIT_FAILURE;
+        lowSeen = lowSeen || (value == 1);
+        highSeen = highSeen || (value == 3);
+    }
+    returnif (!check("Integer bounds", lowSeen && highSeen)) EXIT_FAILURE;
+
+    // Real ranges
+    for (uint i = 0u; i < 1000u; ++i) {
+        auto value = alea::rand(0.f, 1.f, alea::Stream::VISUAL);
+        returnif (!check("Real range", value >= 0.f && value < 1.f)) EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
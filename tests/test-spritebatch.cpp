@@ -0,0 +1,109 @@
+#include "scene/spritebatch.hpp"
+#include "tools/tools.hpp"
+#include "check.hpp"
+
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+//! A batch flushed, as submitted.
+struct Flush
+{
+    std::vector<sf::Vertex> vertices;
+    const sf::Texture* texture;
+    const sf::Shader* shader;
+    sf::BlendMode blendMode;
+};
+
+bool samePosition(const sf::Vertex& vertex, float x, float y)
+{
+    return std::abs(vertex.position.x - x) < 0.001f && std::abs(vertex.position.y - y) < 0.001f;
+}
+
+int main(void)
+{
+    std::vector<Flush> flushes;
+    scene::SpriteBatch batch;
+    batch.setSubmit([&flushes] (const sf::Vertex* vertices, std::size_t verticesCount, const sf::RenderStates& states) {
+        flushes.push_back({{vertices, vertices + verticesCount}, states.texture, states.shader, states.blendMode});
+    });
+
+    sf::Texture atlas, otherAtlas;
+    sf::Shader shader;
+
+    // Sprites of the same atlas, whatever their transforms, share a flush
+    sf::Sprite first(atlas, {0, 0, 10, 20});
+    sf::Sprite second(atlas, {10, 0, 30, 40});
+    second.setPosition(100.f, 50.f);
+    second.setColor(sf::Color::Red);
+    sf::Sprite third(atlas, {40, 0, 10, 10});
+    third.setRotation(90.f);
+
+    batch.draw(first, sf::RenderStates::Default);
+    batch.draw(second, sf::RenderStates::Default);
+    batch.draw(third, sf::RenderStates::Default);
+    returnif (!check("Pending until flushed", flushes.empty())) EXIT_FAILURE;
+
+    batch.flush();
+    returnif (!check("Same atlas flush", flushes.size() == 1u && flushes[0].vertices.size() == 18u)) EXIT_FAILURE;
+    returnif (!check("Atlas bound", flushes[0].texture == &atlas && flushes[0].shader == nullptr)) EXIT_FAILURE;
+
+    // Quads are transformed on the CPU, as two triangles
+    const auto& vertices = flushes[0].vertices;
+    returnif (!check("First quad", samePosition(vertices[0], 0.f, 0.f) && samePosition(vertices[5], 10.f, 20.f))) EXIT_FAILURE;
+    returnif (!check("Second quad", samePosition(vertices[6], 100.f, 50.f) && samePosition(vertices[11], 130.f, 90.f))) EXIT_FAILURE;
+    returnif (!check("Rotated quad", samePosition(vertices[12], 0.f, 0.f) && samePosition(vertices[17], -10.f, 10.f))) EXIT_FAILURE;
+    returnif (!check("Texture coordinates", vertices[6].texCoords == sf::Vector2f(10.f, 0.f) && vertices[11].texCoords == sf::Vector2f(40.f, 40.f))) EXIT_FAILURE;
+    returnif (!check("Colors", vertices[0].color == sf::Color::White && vertices[6].color == sf::Color::Red)) EXIT_FAILURE;
+
+    // Nothing pending, nothing submitted
+    batch.flush();
+    returnif (!check("Empty flush", flushes.size() == 1u && batch.flushesCount() == 1u && batch.quadsCount() == 3u)) EXIT_FAILURE;
+
+    // Changing texture, shader or blend mode flushes, keeping the order
+    flushes.clear();
+    batch.resetCounters();
+
+    sf::RenderStates shaded(&shader);
+    sf::RenderStates added(sf::BlendAdd);
+    sf::Sprite other(otherAtlas, {0, 0, 5, 5});
+
+    batch.draw(first, sf::RenderStates::Default);
+    batch.draw(other, sf::RenderStates::Default);
+    batch.draw(second, sf::RenderStates::Default);
+    batch.draw(third, shaded);
+    batch.draw(first, shaded);
+    batch.draw(second, added);
+    batch.flush();
+
+    returnif (!check("Flushes on changes", flushes.size() == 5u && batch.flushesCount() == 5u && batch.quadsCount() == 6u)) EXIT_FAILURE;
+    returnif (!check("Order kept", flushes[0].texture == &atlas && flushes[1].texture == &otherAtlas && flushes[2].texture == &atlas)) EXIT_FAILURE;
+    returnif (!check("Shader kept", flushes[2].shader == nullptr && flushes[3].shader == &shader && flushes[3].vertices.size() == 12u)) EXIT_FAILURE;
+    returnif (!check("Blend mode kept", flushes[4].blendMode == sf::BlendAdd && flushes[4].shader == nullptr)) EXIT_FAILURE;
+
+    // The states transform applies after the sprite one, and flipped rects flip the texture
+    flushes.clear();
+
+    sf::RenderStates moved;
+    moved.transform.translate(5.f, 5.f);
+    sf::Sprite flipped(atlas, {10, 0, -10, 20});
+
+    batch.draw(flipped, moved);
+    batch.flush();
+
+    const auto& flippedVertices = flushes[0].vertices;
+    returnif (!check("States transform", samePosition(flippedVertices[0], 5.f, 5.f) && samePosition(flippedVertices[5], 15.f, 25.f))) EXIT_FAILURE;
+    returnif (!check("Flipped rect", flippedVertices[0].texCoords == sf::Vector2f(10.f, 0.f) && flippedVertices[5].texCoords == sf::Vector2f(0.f, 20.f))) EXIT_FAILURE;
+
+    // Sprites without texture are not drawn
+    flushes.clear();
+    batch.draw(sf::Sprite(), sf::RenderStates::Default);
+    batch.flush();
+    returnif (!check("No texture", flushes.empty())) EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}